@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// Times the callback in nanoseconds per call. The callback is repeated until a batch takes long enough to be
+// measurable and the fastest of a few batches is returned, which filters out most scheduling noise.
+template <typename Callback>
+double MeasureNanoseconds(Callback callback, double minBatchNanoseconds = 1e6)
+{
+  typedef std::chrono::steady_clock Clock;
+  double best = 0;
+  for(size_t batch = 0; batch < 3; ++batch)
+  {
+    size_t iterations = 0;
+    double elapsed = 0;
+    Clock::time_point start = Clock::now();
+    do
+    {
+      callback();
+      ++iterations;
+      elapsed = double(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    } while(elapsed < minBatchNanoseconds);
+
+    double perCall = elapsed / double(iterations);
+    if(batch == 0 || perCall < best)
+      best = perCall;
+  }
+  return best;
+}
+
+// A simple but concave polygon: evenly spaced angles with a random radius each. Wound clockwise like the test data.
+inline PointContour MakeStarPolygon(size_t vertexCount, const Vec2& center, float innerRadius, float outerRadius, std::mt19937& random)
+{
+  std::uniform_real_distribution<float> radiusDistribution(innerRadius, outerRadius);
+  PointContour result;
+  for(size_t i = 0; i < vertexCount; ++i)
+  {
+    float angle = -6.2831853f * float(i) / float(vertexCount);
+    float radius = radiusDistribution(random);
+    result.push_back(center + Vec2(std::cos(angle), std::sin(angle)) * radius);
+  }
+  return result;
+}
+
+inline PointContour MakeRegularPolygon(size_t vertexCount, const Vec2& center, float radius)
+{
+  PointContour result;
+  for(size_t i = 0; i < vertexCount; ++i)
+  {
+    float angle = -6.2831853f * float(i) / float(vertexCount);
+    result.push_back(center + Vec2(std::cos(angle), std::sin(angle)) * radius);
+  }
+  return result;
+}
+
+inline PointContour MakeRectangle(const Vec2& min, const Vec2& max)
+{
+  return PointContour{min, Vec2(min.x, max.y), max, Vec2(max.x, min.y)};
+}
@@ -0,0 +1,7 @@
+target_sources(Benchmarks
+  PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/main.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Benchmark.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/Calibration.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Calibration.hpp
+)
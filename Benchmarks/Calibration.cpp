@@ -0,0 +1,228 @@
+#include "Calibration.hpp"
+
+#include "Benchmark.hpp"
+
+#include <cstdio>
+
+const ClipEngine CostModelCalibration::Engines[4] = {ClipEngine::WeilerAtherton, ClipEngine::Scanline, ClipEngine::Convex, ClipEngine::Rectangle};
+
+static const char* GetEngineName(ClipEngine engine)
+{
+  switch(engine)
+  {
+    case ClipEngine::Automatic:
+      return "Automatic";
+    case ClipEngine::WeilerAtherton:
+      return "WeilerAtherton";
+    case ClipEngine::Scanline:
+      return "Scanline";
+    case ClipEngine::Convex:
+      return "Convex";
+    case ClipEngine::Rectangle:
+      return "Rectangle";
+  }
+  return "";
+}
+
+// Solves the square system in place with partial pivoting. Returns false if it's singular.
+static bool SolveLinearSystem(double* matrix, double* vector, size_t size)
+{
+  for(size_t column = 0; column < size; ++column)
+  {
+    size_t pivot = column;
+    for(size_t row = column + 1; row < size; ++row)
+    {
+      if(std::abs(matrix[row * size + column]) > std::abs(matrix[pivot * size + column]))
+        pivot = row;
+    }
+    if(std::abs(matrix[pivot * size + column]) < 1e-12)
+      return false;
+    for(size_t i = 0; i < size; ++i)
+      std::swap(matrix[column * size + i], matrix[pivot * size + i]);
+    std::swap(vector[column], vector[pivot]);
+
+    for(size_t row = column + 1; row < size; ++row)
+    {
+      double factor = matrix[row * size + column] / matrix[column * size + column];
+      for(size_t i = column; i < size; ++i)
+        matrix[row * size + i] -= factor * matrix[column * size + i];
+      vector[row] -= factor * vector[column];
+    }
+  }
+  for(size_t column = size; column-- > 0;)
+  {
+    for(size_t i = column + 1; i < size; ++i)
+      vector[column] -= matrix[column * size + i] * vector[i];
+    vector[column] /= matrix[column * size + column];
+  }
+  return true;
+}
+
+//-------------------------------------------------------------------CostModelCalibration
+void CostModelCalibration::Run()
+{
+  mMeasurements.clear();
+  std::mt19937 random(12345);
+  std::uniform_real_distribution<float> offsetDistribution(-0.6f, 0.6f);
+  const size_t vertexCounts[] = {4, 8, 16, 64, 256, 1024};
+  for(size_t polygonCount : vertexCounts)
+  {
+    for(size_t clipCount : vertexCounts)
+    {
+      Vec2 offset(offsetDistribution(random), offsetDistribution(random));
+      PointContour polygonStar = MakeStarPolygon(polygonCount, Vec2(0, 0), 0.5f, 1.0f, random);
+      PointContour clipStar = MakeStarPolygon(clipCount, offset, 0.5f, 1.0f, random);
+      Measure(ClipOperation::Subtract, polygonStar, clipStar);
+      Measure(ClipOperation::Intersect, polygonStar, clipStar);
+
+      PointContour polygonConvex = MakeRegularPolygon(polygonCount, Vec2(0, 0), 1.0f);
+      PointContour clipConvex = MakeRegularPolygon(clipCount, offset, 0.8f);
+      Measure(ClipOperation::Intersect, polygonConvex, clipConvex);
+    }
+
+    Vec2 min(offsetDistribution(random) - 0.5f, offsetDistribution(random) - 0.5f);
+    PointContour rectangle = MakeRectangle(min, min + Vec2(1.2f, 0.9f));
+    Measure(ClipOperation::Intersect, MakeRegularPolygon(polygonCount, Vec2(0, 0), 1.0f), rectangle);
+  }
+
+  for(size_t i = 0; i < 4; ++i)
+    FitEngine(i);
+}
+
+void CostModelCalibration::Measure(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion)
+{
+  Measurement measurement;
+  measurement.mOperation = operation;
+  measurement.mStats.Compute(polygonPoints, clipRegion, mCrossingSampleCount);
+  const ClipInputStats& stats = measurement.mStats;
+  if(!stats.mAabbsOverlap)
+    return;
+
+  // Only time the engines the cost model would be allowed to choose.
+  bool fastPaths = operation == ClipOperation::Intersect && stats.mPolygonConvex;
+  bool allowed[4] = {stats.mEstimatedCrossings > 0, true, fastPaths && stats.mClipRegionConvex, fastPaths && stats.mClipRegionRectangle};
+
+  Clipper clipper;
+  PointContourList polygons{polygonPoints};
+  PointContourList clipRegions{clipRegion};
+  PointContourList results;
+  for(size_t i = 0; i < 4; ++i)
+  {
+    if(!allowed[i])
+      continue;
+
+    ClipOptions options;
+    options.mEngine = Engines[i];
+    measurement.mTimes[i] = MeasureNanoseconds([&]() { clipper.Execute(operation, polygons, clipRegions, options, results); });
+  }
+  mMeasurements.push_back(measurement);
+}
+
+void CostModelCalibration::FitEngine(size_t engineIndex)
+{
+  const size_t count = ClipCostModel::FeatureCount;
+  ClipEngine engine = Engines[engineIndex];
+  float* coefficients = mFittedModel.GetCoefficients(engine);
+
+  // Features that are always zero for this engine can't be fitted.
+  bool active[count] = {};
+  for(const Measurement& measurement : mMeasurements)
+  {
+    if(measurement.mTimes[engineIndex] < 0)
+      continue;
+    float features[count];
+    ClipCostModel::ComputeFeatures(engine, measurement.mStats, features);
+    for(size_t i = 0; i < count; ++i)
+      active[i] = active[i] || features[i] != 0;
+  }
+
+  // Least squares on the relative error. A negative coefficient would make the model favor bigger inputs, so the
+  // most negative feature gets dropped and the fit is repeated until they're all non-negative.
+  for(size_t iteration = 0; iteration < count; ++iteration)
+  {
+    double matrix[count * count] = {};
+    double vector[count] = {};
+    for(const Measurement& measurement : mMeasurements)
+    {
+      double time = measurement.mTimes[engineIndex];
+      if(time <= 0)
+        continue;
+      float features[count];
+      ClipCostModel::ComputeFeatures(engine, measurement.mStats, features);
+      double weight = 1.0 / (time * time);
+      for(size_t row = 0; row < count; ++row)
+      {
+        for(size_t column = 0; column < count; ++column)
+          matrix[row * count + column] += weight * features[row] * features[column];
+        vector[row] += weight * features[row] * time;
+      }
+    }
+    // Inactive features get an identity row so they solve to zero.
+    for(size_t i = 0; i < count; ++i)
+    {
+      if(active[i])
+        continue;
+      for(size_t j = 0; j < count; ++j)
+        matrix[i * count + j] = matrix[j * count + i] = 0;
+      matrix[i * count + i] = 1;
+      vector[i] = 0;
+    }
+    if(!SolveLinearSystem(matrix, vector, count))
+      return;
+
+    size_t mostNegative = count;
+    for(size_t i = 0; i < count; ++i)
+    {
+      if(vector[i] < 0 && (mostNegative == count || vector[i] < vector[mostNegative]))
+        mostNegative = i;
+    }
+    if(mostNegative == count)
+    {
+      for(size_t i = 0; i < count; ++i)
+        coefficients[i] = float(vector[i]);
+      return;
+    }
+    active[mostNegative] = false;
+  }
+}
+
+void CostModelCalibration::PrintModel() const
+{
+  printf("Fitted cost model (nanoseconds):\n");
+  for(ClipEngine engine : Engines)
+  {
+    const float* coefficients = mFittedModel.GetCoefficients(engine);
+    printf("  float m%s[FeatureCount] = {%#.6gf, %#.6gf, %#.6gf, %#.6gf};\n", GetEngineName(engine),
+           coefficients[0], coefficients[1], coefficients[2], coefficients[3]);
+  }
+}
+
+void CostModelCalibration::PrintAccuracy(const char* name, const ClipCostModel& model) const
+{
+  size_t hits = 0;
+  double chosenTime = 0;
+  double bestTime = 0;
+  for(const Measurement& measurement : mMeasurements)
+  {
+    size_t best = 1;
+    for(size_t i = 0; i < 4; ++i)
+    {
+      if(measurement.mTimes[i] >= 0 && measurement.mTimes[i] < measurement.mTimes[best])
+        best = i;
+    }
+
+    ClipEngine chosen = model.ChooseEngine(measurement.mOperation, measurement.mStats);
+    size_t chosenIndex = 1;
+    for(size_t i = 0; i < 4; ++i)
+    {
+      if(Engines[i] == chosen)
+        chosenIndex = i;
+    }
+    if(chosenIndex == best)
+      ++hits;
+    chosenTime += measurement.mTimes[chosenIndex];
+    bestTime += measurement.mTimes[best];
+  }
+  printf("%s model: picked the fastest engine %zu/%zu times, %.2fx the time of always picking the fastest\n",
+         name, hits, mMeasurements.size(), bestTime > 0 ? chosenTime / bestTime : 0.0);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ClipCostModel.hpp"
+
+//-------------------------------------------------------------------CostModelCalibration
+// Times every engine that can handle a spread of generated inputs (concave stars, convex polygons and rectangles
+// over a range of vertex counts) and fits the ClipCostModel coefficients to the measurements. The fit minimizes
+// the relative error so the small inputs, where the choice matters most per call, aren't drowned out by the large ones.
+struct CostModelCalibration
+{
+  void Run();
+  // Prints the fitted coefficients in the same form as the ClipCostModel defaults so they can be pasted in.
+  void PrintModel() const;
+  // Prints how often each model picks the engine that was actually fastest and the total time of its picks
+  // relative to always picking the fastest.
+  void PrintAccuracy(const char* name, const ClipCostModel& model) const;
+
+  ClipCostModel mFittedModel;
+  size_t mCrossingSampleCount = 32;
+
+private:
+  struct Measurement
+  {
+    ClipOperation mOperation = ClipOperation::Intersect;
+    ClipInputStats mStats;
+    // Nanoseconds per call for each engine, or negative if the engine can't handle the inputs.
+    double mTimes[4] = {-1, -1, -1, -1};
+  };
+
+  static const ClipEngine Engines[4];
+
+  void Measure(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion);
+  void FitEngine(size_t engineIndex);
+
+  Array<Measurement> mMeasurements;
+};
@@ -0,0 +1,132 @@
+#include "Benchmark.hpp"
+#include "Calibration.hpp"
+#include "FixedClipper.hpp"
+#include "PolylineClipper.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Every allocation in the program goes through here so a benchmark can check that a path doesn't allocate.
+static std::atomic<size_t> sAllocationCount{0};
+
+void* operator new(size_t size)
+{
+  ++sAllocationCount;
+  if(void* memory = std::malloc(size == 0 ? 1 : size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+  std::free(memory);
+}
+
+// Line of sight style workload: many short segments against one convex zone, batched against one at a time.
+void BenchmarkSegmentBatch()
+{
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> position(-12, 12);
+  std::uniform_real_distribution<float> offset(-1, 1);
+  PointContour zone = MakeRegularPolygon(8, Vec2(0, 0), 8);
+  SegmentBatch segments;
+  for(size_t i = 0; i < 4096; ++i)
+  {
+    Vec2 start(position(random), position(random));
+    segments.Add(start, start + Vec2(offset(random), offset(random)));
+  }
+
+  Array<float> enterTimes;
+  Array<float> exitTimes;
+  double batched = MeasureNanoseconds([&]()
+  {
+    PolylineClipper::ClipSegments(segments, zone, enterTimes, exitTimes);
+  });
+
+  PolylineClipper clipper;
+  PointContourList inside;
+  PointContourList outside;
+  double individual = MeasureNanoseconds([&]()
+  {
+    for(size_t i = 0; i < segments.GetCount(); ++i)
+    {
+      PointContour segment{Vec2(segments.mStartX[i], segments.mStartY[i]), Vec2(segments.mEndX[i], segments.mEndY[i])};
+      clipper.Clip(segment, zone, inside, outside);
+    }
+  });
+  printf("Segment batch: %zu segments, batched %.1f ns/segment, polyline clipper %.1f ns/segment\n",
+    segments.GetCount(), batched / double(segments.GetCount()), individual / double(segments.GetCount()));
+}
+
+// Real-time thread style workload: many clips of small polygons, which the fixed clipper has to do without a
+// single allocation. The allocating clipper's count is after its vertex pool has warmed up.
+void BenchmarkFixedClipper()
+{
+  std::mt19937 random(11);
+  std::uniform_int_distribution<size_t> vertexCount(3, 16);
+  std::uniform_real_distribution<float> offset(-2, 2);
+  const size_t pairCount = 256;
+  Array<PointContour> polygons;
+  Array<PointContour> clipRegions;
+  for(size_t i = 0; i < pairCount; ++i)
+  {
+    polygons.push_back(MakeStarPolygon(vertexCount(random), Vec2(0, 0), 1, 3, random));
+    clipRegions.push_back(MakeStarPolygon(vertexCount(random), Vec2(offset(random), offset(random)), 1, 3, random));
+  }
+
+  FixedClipper<64> fixedClipper;
+  FixedContourList<64> fixedResults;
+  size_t overflows = 0;
+  size_t allocations = sAllocationCount;
+  double fixed = MeasureNanoseconds([&]()
+  {
+    for(size_t i = 0; i < pairCount; ++i)
+    {
+      if(fixedClipper.Execute(ClipOperation::Subtract, polygons[i], clipRegions[i], fixedResults) != ClipStatus::Success)
+        ++overflows;
+    }
+  });
+  size_t fixedAllocations = sAllocationCount - allocations;
+
+  Clipper clipper;
+  PointContourList results;
+  PointContourSink sink(results);
+  auto runClipper = [&]()
+  {
+    for(size_t i = 0; i < pairCount; ++i)
+    {
+      results.clear();
+      clipper.Execute(ClipOperation::Subtract, polygons[i], clipRegions[i], sink);
+    }
+  };
+  runClipper();
+  allocations = sAllocationCount;
+  runClipper();
+  size_t clipperAllocations = sAllocationCount - allocations;
+  double allocating = MeasureNanoseconds(runClipper);
+
+  printf("Fixed clipper: %zu subtractions, fixed %.1f ns/clip with %zu allocations (%zu overflowed), clipper %.1f ns/clip with %zu allocations per batch\n",
+    pairCount, fixed / double(pairCount), fixedAllocations, overflows, allocating / double(pairCount), clipperAllocations);
+  if(fixedAllocations != 0)
+    printf("Error: the fixed clipper allocated\n");
+}
+
+int main()
+{
+  CostModelCalibration calibration;
+  calibration.Run();
+  calibration.PrintModel();
+  calibration.PrintAccuracy("Default", ClipCostModel());
+  calibration.PrintAccuracy("Fitted", calibration.mFittedModel);
+
+  BenchmarkSegmentBatch();
+  BenchmarkFixedClipper();
+  return 0;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Vector2.hpp"
+#include <algorithm>
+#include <cfloat>
+
+struct Aabb
+{
+  Aabb() : mMin(FLT_MAX, FLT_MAX), mMax(-FLT_MAX, -FLT_MAX) {}
+  Aabb(const Vec2& min, const Vec2& max) : mMin(min), mMax(max) {}
+
+  // An aabb is only valid once at least one point has been expanded into it.
+  bool IsValid() const
+  {
+    return mMin.x <= mMax.x && mMin.y <= mMax.y;
+  }
+  void Expand(const Vec2& point)
+  {
+    mMin.x = std::min(mMin.x, point.x);
+    mMin.y = std::min(mMin.y, point.y);
+    mMax.x = std::max(mMax.x, point.x);
+    mMax.y = std::max(mMax.y, point.y);
+  }
+  void Expand(const Aabb& aabb)
+  {
+    if(!aabb.IsValid())
+      return;
+    Expand(aabb.mMin);
+    Expand(aabb.mMax);
+  }
+  bool Overlaps(const Aabb& rhs) const
+  {
+    return mMin.x <= rhs.mMax.x && rhs.mMin.x <= mMax.x &&
+           mMin.y <= rhs.mMax.y && rhs.mMin.y <= mMax.y;
+  }
+  bool Contains(const Aabb& rhs) const
+  {
+    return mMin.x <= rhs.mMin.x && rhs.mMax.x <= mMax.x &&
+           mMin.y <= rhs.mMin.y && rhs.mMax.y <= mMax.y;
+  }
+  bool Contains(const Vec2& point) const
+  {
+    return mMin.x <= point.x && point.x <= mMax.x &&
+           mMin.y <= point.y && point.y <= mMax.y;
+  }
+  Vec2 GetCenter() const
+  {
+    return (mMin + mMax) * 0.5f;
+  }
+  Vec2 GetExtents() const
+  {
+    return mMax - mMin;
+  }
+  float GetArea() const
+  {
+    Vec2 extents = GetExtents();
+    return extents.x * extents.y;
+  }
+  static Aabb FromSegment(const Vec2& start, const Vec2& end)
+  {
+    Aabb result;
+    result.Expand(start);
+    result.Expand(end);
+    return result;
+  }
+  static Aabb Combine(const Aabb& lhs, const Aabb& rhs)
+  {
+    Aabb result = lhs;
+    result.Expand(rhs);
+    return result;
+  }
+
+  Vec2 mMin;
+  Vec2 mMax;
+};
@@ -0,0 +1,209 @@
+#include "AabbTree.hpp"
+
+#include <algorithm>
+
+static float Perimeter(const Aabb& aabb)
+{
+  Vec2 extents = aabb.GetExtents();
+  return 2.0f * (extents.x + extents.y);
+}
+
+//-------------------------------------------------------------------AabbTree
+size_t AabbTree::CreateProxy(const Aabb& aabb, size_t userData)
+{
+  size_t proxyId = AllocateNode();
+  Node& node = mNodes[proxyId];
+  Vec2 margin(mMargin, mMargin);
+  node.mAabb = Aabb(aabb.mMin - margin, aabb.mMax + margin);
+  node.mUserData = userData;
+  node.mHeight = 0;
+  InsertLeaf(proxyId);
+  return proxyId;
+}
+
+void AabbTree::DestroyProxy(size_t proxyId)
+{
+  RemoveLeaf(proxyId);
+  FreeNode(proxyId);
+}
+
+bool AabbTree::MoveProxy(size_t proxyId, const Aabb& aabb)
+{
+  if(mNodes[proxyId].mAabb.Contains(aabb))
+    return false;
+
+  RemoveLeaf(proxyId);
+  Vec2 margin(mMargin, mMargin);
+  mNodes[proxyId].mAabb = Aabb(aabb.mMin - margin, aabb.mMax + margin);
+  InsertLeaf(proxyId);
+  return true;
+}
+
+size_t AabbTree::AllocateNode()
+{
+  if(mFreeNodes.empty())
+  {
+    mNodes.push_back(Node());
+    return mNodes.size() - 1;
+  }
+
+  size_t nodeId = mFreeNodes.back();
+  mFreeNodes.pop_back();
+  mNodes[nodeId] = Node();
+  return nodeId;
+}
+
+void AabbTree::FreeNode(size_t nodeId)
+{
+  mNodes[nodeId].mHeight = -1;
+  mFreeNodes.push_back(nodeId);
+}
+
+void AabbTree::InsertLeaf(size_t leafId)
+{
+  if(mRoot == NullNode)
+  {
+    mRoot = leafId;
+    mNodes[leafId].mParent = NullNode;
+    return;
+  }
+
+  // Descend to the sibling that results in the smallest perimeter growth
+  Aabb leafAabb = mNodes[leafId].mAabb;
+  size_t index = mRoot;
+  while(!mNodes[index].IsLeaf())
+  {
+    const Node& node = mNodes[index];
+    float perimeter = Perimeter(node.mAabb);
+    float combinedPerimeter = Perimeter(Aabb::Combine(node.mAabb, leafAabb));
+    // Cost of creating a new parent here, and the minimum cost pushed down to the children
+    float cost = 2.0f * combinedPerimeter;
+    float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+    auto childCost = [this, &leafAabb, inheritanceCost](size_t childId)
+    {
+      const Node& child = mNodes[childId];
+      float combined = Perimeter(Aabb::Combine(child.mAabb, leafAabb));
+      if(child.IsLeaf())
+        return combined + inheritanceCost;
+      return combined - Perimeter(child.mAabb) + inheritanceCost;
+    };
+    float cost0 = childCost(node.mChild0);
+    float cost1 = childCost(node.mChild1);
+    if(cost < cost0 && cost < cost1)
+      break;
+    index = cost0 < cost1 ? node.mChild0 : node.mChild1;
+  }
+
+  // Create a new parent joining the leaf with the chosen sibling
+  size_t siblingId = index;
+  size_t oldParentId = mNodes[siblingId].mParent;
+  size_t newParentId = AllocateNode();
+  Node& newParent = mNodes[newParentId];
+  newParent.mParent = oldParentId;
+  newParent.mAabb = Aabb::Combine(leafAabb, mNodes[siblingId].mAabb);
+  newParent.mHeight = mNodes[siblingId].mHeight + 1;
+  newParent.mChild0 = siblingId;
+  newParent.mChild1 = leafId;
+  mNodes[siblingId].mParent = newParentId;
+  mNodes[leafId].mParent = newParentId;
+
+  if(oldParentId == NullNode)
+    mRoot = newParentId;
+  else if(mNodes[oldParentId].mChild0 == siblingId)
+    mNodes[oldParentId].mChild0 = newParentId;
+  else
+    mNodes[oldParentId].mChild1 = newParentId;
+
+  Refit(mNodes[leafId].mParent);
+}
+
+void AabbTree::RemoveLeaf(size_t leafId)
+{
+  if(leafId == mRoot)
+  {
+    mRoot = NullNode;
+    return;
+  }
+
+  // The parent goes away and the sibling takes its place
+  size_t parentId = mNodes[leafId].mParent;
+  size_t grandParentId = mNodes[parentId].mParent;
+  size_t siblingId = mNodes[parentId].mChild0 == leafId ? mNodes[parentId].mChild1 : mNodes[parentId].mChild0;
+
+  if(grandParentId == NullNode)
+  {
+    mRoot = siblingId;
+    mNodes[siblingId].mParent = NullNode;
+    FreeNode(parentId);
+    return;
+  }
+
+  if(mNodes[grandParentId].mChild0 == parentId)
+    mNodes[grandParentId].mChild0 = siblingId;
+  else
+    mNodes[grandParentId].mChild1 = siblingId;
+  mNodes[siblingId].mParent = grandParentId;
+  FreeNode(parentId);
+
+  Refit(grandParentId);
+}
+
+void AabbTree::Refit(size_t nodeId)
+{
+  while(nodeId != NullNode)
+  {
+    nodeId = Balance(nodeId);
+
+    Node& node = mNodes[nodeId];
+    const Node& child0 = mNodes[node.mChild0];
+    const Node& child1 = mNodes[node.mChild1];
+    node.mHeight = 1 + std::max(child0.mHeight, child1.mHeight);
+    node.mAabb = Aabb::Combine(child0.mAabb, child1.mAabb);
+
+    nodeId = node.mParent;
+  }
+}
+
+size_t AabbTree::Balance(size_t nodeId)
+{
+  Node& a = mNodes[nodeId];
+  if(a.IsLeaf() || a.mHeight < 2)
+    return nodeId;
+
+  size_t bId = a.mChild0;
+  size_t cId = a.mChild1;
+  int balance = mNodes[cId].mHeight - mNodes[bId].mHeight;
+  if(balance >= -1 && balance <= 1)
+    return nodeId;
+
+  // Promote the taller child, its taller grandchild stays below it and the shorter one moves down to the old node.
+  size_t tallId = balance > 1 ? cId : bId;
+  size_t shortId = balance > 1 ? bId : cId;
+  Node& tall = mNodes[tallId];
+  size_t fId = tall.mChild0;
+  size_t gId = tall.mChild1;
+
+  tall.mChild0 = nodeId;
+  tall.mParent = a.mParent;
+  a.mParent = tallId;
+  if(tall.mParent == NullNode)
+    mRoot = tallId;
+  else if(mNodes[tall.mParent].mChild0 == nodeId)
+    mNodes[tall.mParent].mChild0 = tallId;
+  else
+    mNodes[tall.mParent].mChild1 = tallId;
+
+  size_t keepId = mNodes[fId].mHeight > mNodes[gId].mHeight ? fId : gId;
+  size_t moveId = keepId == fId ? gId : fId;
+  tall.mChild1 = keepId;
+  a.mChild0 = shortId;
+  a.mChild1 = moveId;
+  mNodes[moveId].mParent = nodeId;
+
+  a.mAabb = Aabb::Combine(mNodes[shortId].mAabb, mNodes[moveId].mAabb);
+  a.mHeight = 1 + std::max(mNodes[shortId].mHeight, mNodes[moveId].mHeight);
+  tall.mAabb = Aabb::Combine(a.mAabb, mNodes[keepId].mAabb);
+  tall.mHeight = 1 + std::max(a.mHeight, mNodes[keepId].mHeight);
+  return tallId;
+}
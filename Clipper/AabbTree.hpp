@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+//-------------------------------------------------------------------AabbTree
+// A dynamic aabb tree for objects that move every frame. Leaves store a fat aabb (the tight aabb grown by a margin)
+// so small movements don't require any tree changes. When an object leaves its fat aabb the leaf is reinserted and
+// only the ancestors of the touched nodes are refit, keeping the tree balanced with rotations.
+struct AabbTree
+{
+  static constexpr size_t NullNode = static_cast<size_t>(-1);
+
+  struct Node
+  {
+    bool IsLeaf() const { return mChild0 == NullNode; }
+
+    Aabb mAabb;
+    size_t mParent = NullNode;
+    size_t mChild0 = NullNode;
+    size_t mChild1 = NullNode;
+    // Height of the sub-tree, leaves are 0 and free nodes are -1.
+    int mHeight = -1;
+    size_t mUserData = 0;
+  };
+
+  // Inserts a new leaf for the given tight aabb, returning the proxy id used to reference it.
+  size_t CreateProxy(const Aabb& aabb, size_t userData);
+  void DestroyProxy(size_t proxyId);
+  // Updates the leaf for the new tight aabb. Returns true if the leaf had to be reinserted because the
+  // aabb escaped the fat aabb, false if nothing in the tree changed.
+  bool MoveProxy(size_t proxyId, const Aabb& aabb);
+
+  const Aabb& GetFatAabb(size_t proxyId) const { return mNodes[proxyId].mAabb; }
+  size_t GetUserData(size_t proxyId) const { return mNodes[proxyId].mUserData; }
+  int GetHeight() const { return mRoot == NullNode ? 0 : mNodes[mRoot].mHeight; }
+
+  // Calls the callback with the proxy id of every leaf whose fat aabb overlaps the given aabb.
+  template <typename Callback>
+  void Query(const Aabb& aabb, Callback callback) const
+  {
+    if(mRoot == NullNode)
+      return;
+
+    Array<size_t> stack{mRoot};
+    while(!stack.empty())
+    {
+      size_t nodeId = stack.back();
+      stack.pop_back();
+      const Node& node = mNodes[nodeId];
+      if(!node.mAabb.Overlaps(aabb))
+        continue;
+
+      if(node.IsLeaf())
+        callback(nodeId);
+      else
+      {
+        stack.push_back(node.mChild0);
+        stack.push_back(node.mChild1);
+      }
+    }
+  }
+
+  // How much each tight aabb is grown by when stored in the tree.
+  float mMargin = 0.1f;
+
+private:
+  size_t AllocateNode();
+  void FreeNode(size_t nodeId);
+  void InsertLeaf(size_t leafId);
+  void RemoveLeaf(size_t leafId);
+  // Walks up from the given node refitting aabbs and heights, rotating any unbalanced nodes on the way.
+  void Refit(size_t nodeId);
+  size_t Balance(size_t nodeId);
+
+  Array<Node> mNodes;
+  Array<size_t> mFreeNodes;
+  size_t mRoot = NullNode;
+};
@@ -1,6 +1,43 @@
 target_sources(Clipper
   PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/Aabb.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/AabbTree.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/AabbTree.hpp
     ${CMAKE_CURRENT_LIST_DIR}/Vector2.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ChunkedTerrain.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ChunkedTerrain.hpp
     ${CMAKE_CURRENT_LIST_DIR}/Clipper.cpp
     ${CMAKE_CURRENT_LIST_DIR}/Clipper.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipCutters.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipCostModel.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipCostModel.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipExpr.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipExpr.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipJob.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipJob.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipParallel.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipParallelEdges.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipScene.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipScene.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipShape.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ClipShape.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ContourSimplifier.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ContourSimplifier.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ConvexClipper.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ConvexClipper.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/FixedClipper.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/InterleavedContourSink.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/InterleavedContourSink.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/PolygonOffsetter.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/PolygonOffsetter.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/PolygonTriangulator.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/PolygonTriangulator.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/PolylineClipper.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/PolylineClipper.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ScanlineClipper.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ScanlineClipper.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/SpatialJoin.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/SpatialJoin.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/StrTree.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/StrTree.hpp
 )
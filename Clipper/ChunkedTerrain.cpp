@@ -0,0 +1,440 @@
+#include "ChunkedTerrain.hpp"
+
+#include "ClipParallel.hpp"
+#include "ContourSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+// Appends the contours of a clip to a piece list along with which of their edges are seams. The clipper traces each
+// edge along the input its start vertex came from, so the provenance of that vertex says where the edge came from.
+// Clip region edges are seams when the clip region was a chunk or split rectangle, and polygon edges keep the flag
+// they had in the polygon.
+static void AppendPieces(PointContourList& contours, const ClipProvenance& provenance, const Array<bool>& polygonSeams, bool clipRegionIsSeam,
+  PointContourList& pieces, Array<Array<bool>>& seamEdges)
+{
+  for(size_t i = 0; i < contours.size(); ++i)
+  {
+    Array<bool> seams(contours[i].size());
+    size_t begin = provenance.GetContourBegin(i);
+    for(size_t j = 0; j < seams.size(); ++j)
+    {
+      const ClipVertexSource& source = provenance.mSources[begin + j];
+      if(source.mOperand == ClipOperand::ClipRegion)
+        seams[j] = clipRegionIsSeam;
+      else
+        seams[j] = polygonSeams[source.mEdgeIndex];
+    }
+    pieces.push_back(std::move(contours[i]));
+    seamEdges.push_back(std::move(seams));
+  }
+}
+
+// A seam edge as a span along its axis aligned line, running from mStart to mEnd.
+struct SeamSpan
+{
+  bool mVertical;
+  float mLine;
+  float mStart;
+  float mEnd;
+};
+
+// Seam edges of neighboring pieces run along the same line in opposite directions and cancel out. Where a cutter
+// edge coincides with a seam, only one side of the seam is left and that part of it is a real edge. Each line is
+// cut at every span end and the directions covering each interval are summed, so whatever doesn't cancel is kept.
+static void CancelSeamSpans(Array<SeamSpan>& spans, float epsilon, Array<SeamSpan>& leftovers)
+{
+  std::sort(spans.begin(), spans.end(), [](const SeamSpan& lhs, const SeamSpan& rhs)
+  {
+    if(lhs.mVertical != rhs.mVertical)
+      return lhs.mVertical < rhs.mVertical;
+    return lhs.mLine < rhs.mLine;
+  });
+
+  Array<float> positions;
+  Array<int> coverage;
+  size_t lineBegin = 0;
+  while(lineBegin < spans.size())
+  {
+    // The same line is computed separately in each chunk, so it only matches within a tolerance.
+    size_t lineEnd = lineBegin + 1;
+    while(lineEnd < spans.size() && spans[lineEnd].mVertical == spans[lineBegin].mVertical && spans[lineEnd].mLine - spans[lineEnd - 1].mLine <= epsilon)
+      ++lineEnd;
+
+    positions.clear();
+    for(size_t i = lineBegin; i < lineEnd; ++i)
+    {
+      positions.push_back(spans[i].mStart);
+      positions.push_back(spans[i].mEnd);
+    }
+    std::sort(positions.begin(), positions.end());
+    size_t uniqueCount = 1;
+    for(size_t i = 1; i < positions.size(); ++i)
+    {
+      if(positions[i] - positions[uniqueCount - 1] > epsilon)
+        positions[uniqueCount++] = positions[i];
+    }
+    positions.resize(uniqueCount);
+    auto findPosition = [&positions, epsilon](float value)
+    {
+      return static_cast<size_t>(std::lower_bound(positions.begin(), positions.end(), value - epsilon) - positions.begin());
+    };
+
+    coverage.assign(uniqueCount, 0);
+    for(size_t i = lineBegin; i < lineEnd; ++i)
+    {
+      const SeamSpan& span = spans[i];
+      int direction = span.mEnd > span.mStart ? 1 : -1;
+      coverage[findPosition(std::min(span.mStart, span.mEnd))] += direction;
+      coverage[findPosition(std::max(span.mStart, span.mEnd))] -= direction;
+    }
+    int sum = 0;
+    for(size_t i = 0; i + 1 < uniqueCount; ++i)
+    {
+      sum += coverage[i];
+      if(sum > 0)
+        leftovers.push_back(SeamSpan{spans[lineBegin].mVertical, spans[lineBegin].mLine, positions[i], positions[i + 1]});
+      else if(sum < 0)
+        leftovers.push_back(SeamSpan{spans[lineBegin].mVertical, spans[lineBegin].mLine, positions[i + 1], positions[i]});
+    }
+    lineBegin = lineEnd;
+  }
+}
+
+//-------------------------------------------------------------------ChunkedTerrain
+void ChunkedTerrain::Build(const PointContourList& terrain, float cellSize)
+{
+  mChunks.clear();
+  mPendingCutters.clear();
+  mContours.clear();
+  mContoursDirty = true;
+  mCellSize = cellSize;
+
+  Aabb terrainAabb;
+  for(const PointContour& polygon : terrain)
+    terrainAabb.Expand(ComputeAabb(polygon));
+  if(!terrainAabb.IsValid())
+    return;
+  mClockwise = ComputeSignedArea(terrain[0]) < 0;
+
+  // Pad the grid by an uneven fraction of a cell so that the terrain never lies on the outer border.
+  Vec2 padding(cellSize * 0.3719f, cellSize * 0.3719f);
+  mOrigin = terrainAabb.mMin - padding;
+  Vec2 extents = terrainAabb.GetExtents() + padding * 2.0f;
+  mCellCountX = static_cast<size_t>(std::ceil(extents.x / cellSize));
+  mCellCountY = static_cast<size_t>(std::ceil(extents.y / cellSize));
+  mChunks.resize(mCellCountX * mCellCountY);
+
+  for(size_t y = 0; y < mCellCountY; ++y)
+  {
+    for(size_t x = 0; x < mCellCountX; ++x)
+    {
+      Chunk& chunk = mChunks[y * mCellCountX + x];
+      Vec2 min = mOrigin + Vec2(x * cellSize, y * cellSize);
+      chunk.mBounds = Aabb(min, min + Vec2(cellSize, cellSize));
+    }
+  }
+
+  ParallelFor(mChunks.size(), mThreadCount, [this, &terrain](size_t i, size_t threadIndex)
+  {
+    Chunk& chunk = mChunks[i];
+    PointContour cell = MakeRectangle(chunk.mBounds);
+    Clipper clipper;
+    ClipProvenance provenance;
+    clipper.mProvenance = &provenance;
+    for(const PointContour& polygon : terrain)
+    {
+      if(!ComputeAabb(polygon).Overlaps(chunk.mBounds))
+        continue;
+      PointContourList pieces;
+      clipper.IntersectWithContainment(polygon, cell, pieces);
+      AppendPieces(pieces, provenance, Array<bool>(polygon.size(), false), true, chunk.mPieces, chunk.mSeamEdges);
+    }
+  });
+}
+
+void ChunkedTerrain::Carve(const PointContour& cutter)
+{
+  QueueCarve(cutter);
+  Flush();
+}
+
+void ChunkedTerrain::QueueCarve(const PointContour& cutter)
+{
+  if(cutter.size() < 3)
+    return;
+
+  // The clipper expects both polygons to wind the same way
+  mPendingCutters.push_back(cutter);
+  PointContour& queued = mPendingCutters.back();
+  if((ComputeSignedArea(queued) < 0) != mClockwise)
+    std::reverse(queued.begin(), queued.end());
+}
+
+void ChunkedTerrain::Flush()
+{
+  mStats = ChunkedTerrainStats();
+  if(mPendingCutters.empty() || mChunks.empty())
+    return;
+
+  // Bin every cutter into the chunks its aabb touches
+  Array<size_t> touchedChunks;
+  for(size_t cutterIndex = 0; cutterIndex < mPendingCutters.size(); ++cutterIndex)
+  {
+    Aabb aabb = ComputeAabb(mPendingCutters[cutterIndex]);
+    Vec2 min = (aabb.mMin - mOrigin) * (1.0f / mCellSize);
+    Vec2 max = (aabb.mMax - mOrigin) * (1.0f / mCellSize);
+    if(max.x < 0 || max.y < 0 || min.x >= mCellCountX || min.y >= mCellCountY)
+      continue;
+
+    size_t minX = static_cast<size_t>(std::max(0.0f, min.x));
+    size_t minY = static_cast<size_t>(std::max(0.0f, min.y));
+    size_t maxX = std::min(mCellCountX - 1, static_cast<size_t>(max.x));
+    size_t maxY = std::min(mCellCountY - 1, static_cast<size_t>(max.y));
+    for(size_t y = minY; y <= maxY; ++y)
+    {
+      for(size_t x = minX; x <= maxX; ++x)
+      {
+        size_t chunkIndex = y * mCellCountX + x;
+        Chunk& chunk = mChunks[chunkIndex];
+        if(chunk.mPendingCutters.empty())
+          touchedChunks.push_back(chunkIndex);
+        chunk.mPendingCutters.push_back(cutterIndex);
+      }
+    }
+  }
+
+  // Each touched chunk applies all of its cutters in one pass. Chunks are independent so they can run in parallel.
+  Array<ChunkedTerrainStats> threadStats(ResolveThreadCount(mThreadCount));
+  ParallelFor(touchedChunks.size(), mThreadCount, [this, &touchedChunks, &threadStats](size_t i, size_t threadIndex)
+  {
+    Clipper clipper;
+    ClipProvenance provenance;
+    clipper.mProvenance = &provenance;
+    ChunkedTerrainStats& stats = threadStats[threadIndex];
+    Chunk& chunk = mChunks[touchedChunks[i]];
+    size_t pieceCount = chunk.mPieces.size();
+    size_t splitCount = chunk.mSplitCount;
+    CarveChunk(chunk, clipper);
+    stats.mPiecesClipped += pieceCount;
+    stats.mPiecesSplit += chunk.mSplitCount - splitCount;
+  });
+
+  mStats.mChunksTouched = touchedChunks.size();
+  for(const ChunkedTerrainStats& stats : threadStats)
+  {
+    mStats.mPiecesClipped += stats.mPiecesClipped;
+    mStats.mPiecesSplit += stats.mPiecesSplit;
+  }
+  mPendingCutters.clear();
+  mContoursDirty = mContoursDirty || !touchedChunks.empty();
+}
+
+const PointContourList& ChunkedTerrain::GetContours()
+{
+  if(mContoursDirty)
+  {
+    Stitch();
+    mContoursDirty = false;
+  }
+  return mContours;
+}
+
+PointContour ChunkedTerrain::MakeRectangle(const Aabb& aabb) const
+{
+  PointContour result{aabb.mMin, Vec2(aabb.mMin.x, aabb.mMax.y), aabb.mMax, Vec2(aabb.mMax.x, aabb.mMin.y)};
+  if(!mClockwise)
+    std::reverse(result.begin(), result.end());
+  return result;
+}
+
+void ChunkedTerrain::CarveChunk(Chunk& chunk, Clipper& clipper)
+{
+  for(size_t cutterIndex : chunk.mPendingCutters)
+  {
+    const PointContour& cutter = mPendingCutters[cutterIndex];
+    Aabb cutterAabb = ComputeAabb(cutter);
+
+    PointContourList remaining;
+    Array<Array<bool>> remainingSeams;
+    for(size_t i = 0; i < chunk.mPieces.size(); ++i)
+    {
+      if(!ComputeAabb(chunk.mPieces[i]).Overlaps(cutterAabb))
+      {
+        remaining.push_back(std::move(chunk.mPieces[i]));
+        remainingSeams.push_back(std::move(chunk.mSeamEdges[i]));
+      }
+      else
+        CarvePiece(chunk, clipper, chunk.mPieces[i], chunk.mSeamEdges[i], cutter, true, remaining, remainingSeams);
+    }
+    chunk.mPieces.swap(remaining);
+    chunk.mSeamEdges.swap(remainingSeams);
+  }
+  chunk.mPendingCutters.clear();
+}
+
+void ChunkedTerrain::CarvePiece(Chunk& chunk, Clipper& clipper, const PointContour& piece, const Array<bool>& pieceSeams, const PointContour& cutter, bool allowSplit,
+  PointContourList& remaining, Array<Array<bool>>& remainingSeams)
+{
+  if(!clipper.Intersects(piece, cutter))
+  {
+    remaining.push_back(piece);
+    remainingSeams.push_back(pieceSeams);
+    return;
+  }
+  if(clipper.Contains(cutter, piece))
+    return;
+
+  if(clipper.FindFirstContact(piece, cutter, EdgeContact::Cross) == EdgeContact::Cross)
+  {
+    PointContourList carved;
+    clipper.Subtract(piece, cutter, carved);
+    AppendPieces(carved, *clipper.mProvenance, pieceSeams, false, remaining, remainingSeams);
+    return;
+  }
+
+  // The cutter is strictly inside the piece which would leave a hole, and holes aren't supported by the clipper.
+  if(!allowSplit)
+  {
+    remaining.push_back(piece);
+    remainingSeams.push_back(pieceSeams);
+    return;
+  }
+
+  // Split the piece with a vertical line through the middle of the widest gap between the cutter's vertices so that
+  // both halves cross the cutter. No cutter edge can lie along the line, which the clipper couldn't handle. The
+  // edges along the split line are marked as seams so that stitching removes them again.
+  Array<float> vertexXs;
+  for(const Vec2& point : cutter)
+    vertexXs.push_back(point.x);
+  std::sort(vertexXs.begin(), vertexXs.end());
+  float splitX = vertexXs[0];
+  float widestGap = 0;
+  for(size_t i = 1; i < vertexXs.size(); ++i)
+  {
+    if(vertexXs[i] - vertexXs[i - 1] > widestGap)
+    {
+      widestGap = vertexXs[i] - vertexXs[i - 1];
+      splitX = (vertexXs[i] + vertexXs[i - 1]) * 0.5f;
+    }
+  }
+  ++chunk.mSplitCount;
+
+  // The halves reach past the chunk so that only the split line crosses the piece. Edges shared with the chunk
+  // border would overlap the piece's own edges, which the clipper can't handle.
+  Vec2 margin(mCellSize, mCellSize);
+  Aabb left(chunk.mBounds.mMin - margin, chunk.mBounds.mMax + margin);
+  Aabb right = left;
+  left.mMax.x = splitX;
+  right.mMin.x = splitX;
+  PointContourList halves;
+  Array<Array<bool>> halfSeams;
+  PointContourList clipped;
+  clipper.IntersectWithContainment(piece, MakeRectangle(left), clipped);
+  AppendPieces(clipped, *clipper.mProvenance, pieceSeams, true, halves, halfSeams);
+  clipper.IntersectWithContainment(piece, MakeRectangle(right), clipped);
+  AppendPieces(clipped, *clipper.mProvenance, pieceSeams, true, halves, halfSeams);
+  for(size_t i = 0; i < halves.size(); ++i)
+    CarvePiece(chunk, clipper, halves[i], halfSeams[i], cutter, false, remaining, remainingSeams);
+}
+
+void ChunkedTerrain::Stitch()
+{
+  mContours.clear();
+
+  // Every edge of a piece that isn't a seam is part of the real outline, as is any part of a seam that the
+  // neighboring pieces don't cancel. Since all pieces wind the same way, those edges chain together end to start
+  // into the closed outline (and hole) loops.
+  struct Edge
+  {
+    Vec2 mStart;
+    Vec2 mEnd;
+    bool mUsed;
+  };
+  float epsilon = mCellSize * 1e-4f;
+  Array<Edge> edges;
+  Array<SeamSpan> seamSpans;
+  for(const Chunk& chunk : mChunks)
+  {
+    for(size_t pieceIndex = 0; pieceIndex < chunk.mPieces.size(); ++pieceIndex)
+    {
+      const PointContour& piece = chunk.mPieces[pieceIndex];
+      const Array<bool>& seams = chunk.mSeamEdges[pieceIndex];
+      size_t count = piece.size();
+      for(size_t i = 0; i < count; ++i)
+      {
+        const Vec2& start = piece[i];
+        const Vec2& end = piece[(i + 1) % count];
+        if(start == end)
+          continue;
+        if(!seams[i])
+          edges.push_back(Edge{start, end, false});
+        else if(std::abs(end.x - start.x) <= epsilon)
+          seamSpans.push_back(SeamSpan{true, (start.x + end.x) * 0.5f, start.y, end.y});
+        else
+          seamSpans.push_back(SeamSpan{false, (start.y + end.y) * 0.5f, start.x, end.x});
+      }
+    }
+  }
+  Array<SeamSpan> leftovers;
+  CancelSeamSpans(seamSpans, epsilon, leftovers);
+  for(const SeamSpan& span : leftovers)
+  {
+    if(span.mVertical)
+      edges.push_back(Edge{Vec2(span.mLine, span.mStart), Vec2(span.mLine, span.mEnd), false});
+    else
+      edges.push_back(Edge{Vec2(span.mStart, span.mLine), Vec2(span.mEnd, span.mLine), false});
+  }
+
+  // Bucket edges by their start point. Points on seams are computed separately in each chunk so they only match within a tolerance.
+  float bucketScale = 1.0f / (epsilon * 4.0f);
+  auto getKey = [bucketScale](const Vec2& point, int offsetX, int offsetY)
+  {
+    long long x = static_cast<long long>(std::floor(point.x * bucketScale)) + offsetX;
+    long long y = static_cast<long long>(std::floor(point.y * bucketScale)) + offsetY;
+    return (x * 73856093) ^ (y * 19349663);
+  };
+  std::unordered_multimap<long long, size_t> startBuckets;
+  for(size_t i = 0; i < edges.size(); ++i)
+    startBuckets.emplace(getKey(edges[i].mStart, 0, 0), i);
+
+  auto findNextEdge = [&](const Vec2& point)
+  {
+    for(int offsetY = -1; offsetY <= 1; ++offsetY)
+    {
+      for(int offsetX = -1; offsetX <= 1; ++offsetX)
+      {
+        auto range = startBuckets.equal_range(getKey(point, offsetX, offsetY));
+        for(auto it = range.first; it != range.second; ++it)
+        {
+          const Edge& edge = edges[it->second];
+          if(!edge.mUsed && Vec2::DistanceSq(edge.mStart, point) <= epsilon * epsilon)
+            return it->second;
+        }
+      }
+    }
+    return edges.size();
+  };
+
+  for(size_t i = 0; i < edges.size(); ++i)
+  {
+    if(edges[i].mUsed)
+      continue;
+
+    PointContour contour;
+    size_t edgeIndex = i;
+    while(edgeIndex < edges.size())
+    {
+      Edge& edge = edges[edgeIndex];
+      edge.mUsed = true;
+      contour.push_back(edge.mStart);
+      edgeIndex = findNextEdge(edge.mEnd);
+    }
+
+    // Where the outline crossed a seam there's an extra vertex in the middle of a straight edge, remove those
+    ContourSimplifier::RemoveRedundantPoints(contour, 0, 1e-5f);
+    if(contour.size() >= 3)
+      mContours.push_back(std::move(contour));
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+//-------------------------------------------------------------------ChunkedTerrainStats
+struct ChunkedTerrainStats
+{
+  size_t mChunksTouched = 0;
+  size_t mPiecesClipped = 0;
+  size_t mPiecesSplit = 0;
+};
+
+//-------------------------------------------------------------------ChunkedTerrain
+// Destructible terrain partitioned into a grid of chunks. Each chunk stores the pieces of the terrain that fall
+// inside its cell, so carving only has to re-clip the chunks the cutter's aabb touches instead of the whole terrain.
+// The pieces are stitched back together into the full outline lazily, only when the outline is requested.
+struct ChunkedTerrain
+{
+  // Partitions the terrain polygons into square cells of the given size.
+  void Build(const PointContourList& terrain, float cellSize);
+  // Carves a single cutter out of the terrain immediately.
+  void Carve(const PointContour& cutter);
+  // Queues a cutter to be carved on the next flush. All queued cutters are applied in a single pass per chunk.
+  void QueueCarve(const PointContour& cutter);
+  void Flush();
+
+  // Returns the stitched terrain outline. Holes come back as contours with the opposite winding.
+  const PointContourList& GetContours();
+  size_t GetChunkCount() const { return mChunks.size(); }
+  const PointContourList& GetChunkPieces(size_t chunkIndex) const { return mChunks[chunkIndex].mPieces; }
+
+  // Stats for the most recent flush.
+  ChunkedTerrainStats mStats;
+  // Number of threads used to process chunks during a flush. Zero uses the hardware concurrency.
+  size_t mThreadCount = 1;
+
+private:
+  struct Chunk
+  {
+    Aabb mBounds;
+    PointContourList mPieces;
+    // Parallel to mPieces, whether each edge of a piece came from a chunk border or a split line rather than the
+    // terrain or a cutter. Stitching drops these edges, so a real edge that happens to lie on a seam survives.
+    Array<Array<bool>> mSeamEdges;
+    // Number of times a piece had to be split to avoid creating a hole.
+    size_t mSplitCount = 0;
+    Array<size_t> mPendingCutters;
+  };
+
+  PointContour MakeRectangle(const Aabb& aabb) const;
+  void CarveChunk(Chunk& chunk, Clipper& clipper);
+  // Carves the cutter out of a single piece, appending whatever is left to the remaining lists.
+  void CarvePiece(Chunk& chunk, Clipper& clipper, const PointContour& piece, const Array<bool>& pieceSeams, const PointContour& cutter, bool allowSplit,
+    PointContourList& remaining, Array<Array<bool>>& remainingSeams);
+  void Stitch();
+
+  Array<Chunk> mChunks;
+  size_t mCellCountX = 0;
+  size_t mCellCountY = 0;
+  Vec2 mOrigin = Vec2(0, 0);
+  float mCellSize = 1;
+  // True when the terrain winds clockwise. Everything clipped against it is made to wind the same way.
+  bool mClockwise = true;
+
+  PointContourList mPendingCutters;
+  PointContourList mContours;
+  bool mContoursDirty = true;
+};
@@ -0,0 +1,223 @@
+#include "ClipCostModel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Tests a strided sample of the larger operand's edges against every edge of the smaller one, only counting proper
+// crossings, and scales the count up to all of the larger operand's edges.
+static float EstimateCrossings(const PointContour& larger, const PointContour& smaller, const Aabb& overlap, size_t sampleCount)
+{
+  size_t largerCount = larger.size();
+  size_t smallerCount = smaller.size();
+  if(largerCount == 0 || smallerCount == 0 || sampleCount == 0)
+    return 0;
+
+  size_t stride = std::max(size_t(1), largerCount / sampleCount);
+  size_t sampled = 0;
+  size_t crossings = 0;
+  for(size_t i = 0; i < largerCount; i += stride)
+  {
+    ++sampled;
+    const Vec2& start = larger[i];
+    const Vec2& end = larger[(i + 1) % largerCount];
+    Aabb edgeAabb = Aabb::FromSegment(start, end);
+    // Edges outside of the overlap can't cross the other operand.
+    if(!edgeAabb.Overlaps(overlap))
+      continue;
+
+    for(size_t j = 0; j < smallerCount; ++j)
+    {
+      const Vec2& otherStart = smaller[j];
+      const Vec2& otherEnd = smaller[(j + 1) % smallerCount];
+      if(!edgeAabb.Overlaps(Aabb::FromSegment(otherStart, otherEnd)))
+        continue;
+      if(ComputeEdgeContact(start, end, otherStart, otherEnd) == EdgeContact::Cross)
+        ++crossings;
+    }
+  }
+  return float(crossings) * float(largerCount) / float(sampled);
+}
+
+// Tests whether an edge of one operand touches an edge of the other without properly crossing it, such as a vertex
+// lying on the other boundary or collinear edges overlapping. Edges are swept in y so only edges whose y ranges
+// overlap are tested against each other.
+static bool BoundariesTouch(const PointContour& polygonPoints, const PointContour& clipRegion)
+{
+  const PointContour* operands[2] = {&polygonPoints, &clipRegion};
+  Array<std::pair<size_t, size_t>> edges;
+  for(size_t operand = 0; operand < 2; ++operand)
+  {
+    for(size_t i = 0; i < operands[operand]->size(); ++i)
+      edges.push_back(std::make_pair(operand, i));
+  }
+  auto getStart = [&operands](const std::pair<size_t, size_t>& edge) -> const Vec2& { return (*operands[edge.first])[edge.second]; };
+  auto getEnd = [&operands](const std::pair<size_t, size_t>& edge) -> const Vec2&
+  {
+    const PointContour& points = *operands[edge.first];
+    return points[(edge.second + 1) % points.size()];
+  };
+  auto minY = [&](const std::pair<size_t, size_t>& edge) { return std::min(getStart(edge).y, getEnd(edge).y); };
+  auto maxY = [&](const std::pair<size_t, size_t>& edge) { return std::max(getStart(edge).y, getEnd(edge).y); };
+  std::sort(edges.begin(), edges.end(), [&minY](const std::pair<size_t, size_t>& lhs, const std::pair<size_t, size_t>& rhs) { return minY(lhs) < minY(rhs); });
+
+  // One active list per operand, as only edges of different operands are tested.
+  Array<std::pair<size_t, size_t>> activeEdges[2];
+  for(const std::pair<size_t, size_t>& edge : edges)
+  {
+    float y = minY(edge);
+    Array<std::pair<size_t, size_t>>& others = activeEdges[1 - edge.first];
+    others.erase(std::remove_if(others.begin(), others.end(), [&maxY, y](const std::pair<size_t, size_t>& active) { return maxY(active) < y; }), others.end());
+    for(const std::pair<size_t, size_t>& other : others)
+    {
+      if(ComputeEdgeContact(getStart(edge), getEnd(edge), getStart(other), getEnd(other)) == EdgeContact::Touch)
+        return true;
+    }
+    activeEdges[edge.first].push_back(edge);
+  }
+  return false;
+}
+
+static float ComputeAverageActiveEdges(const PointContour& points, const Aabb& aabb)
+{
+  float height = aabb.GetExtents().y;
+  if(height <= 0)
+    return 0;
+
+  float totalHeight = 0;
+  size_t count = points.size();
+  for(size_t i = 0; i < count; ++i)
+    totalHeight += std::abs(points[(i + 1) % count].y - points[i].y);
+  return totalHeight / height;
+}
+
+//-------------------------------------------------------------------ClipInputStats
+void ClipInputStats::Compute(const PointContour& polygonPoints, const PointContour& clipRegion, size_t crossingSampleCount)
+{
+  mPolygonVertexCount = polygonPoints.size();
+  mClipRegionVertexCount = clipRegion.size();
+  mPolygonConvex = IsConvex(polygonPoints);
+  mClipRegionConvex = IsConvex(clipRegion);
+  mClipRegionRectangle = IsAxisAlignedRectangle(clipRegion);
+
+  Aabb polygonAabb = ComputeAabb(polygonPoints);
+  Aabb clipAabb = ComputeAabb(clipRegion);
+  mAabbsOverlap = polygonAabb.Overlaps(clipAabb);
+  mAverageActiveEdges = ComputeAverageActiveEdges(polygonPoints, polygonAabb) + ComputeAverageActiveEdges(clipRegion, clipAabb);
+  mAabbOverlapRatio = 0;
+  mEstimatedCrossings = 0;
+  mBoundariesTouch = false;
+  if(!mAabbsOverlap)
+    return;
+  mBoundariesTouch = BoundariesTouch(polygonPoints, clipRegion);
+
+  Aabb overlap(Vec2(std::max(polygonAabb.mMin.x, clipAabb.mMin.x), std::max(polygonAabb.mMin.y, clipAabb.mMin.y)),
+               Vec2(std::min(polygonAabb.mMax.x, clipAabb.mMax.x), std::min(polygonAabb.mMax.y, clipAabb.mMax.y)));
+  float smallerArea = std::min(polygonAabb.GetArea(), clipAabb.GetArea());
+  if(smallerArea > 0)
+    mAabbOverlapRatio = overlap.GetArea() / smallerArea;
+
+  if(mPolygonVertexCount >= mClipRegionVertexCount)
+    mEstimatedCrossings = EstimateCrossings(polygonPoints, clipRegion, overlap, crossingSampleCount);
+  else
+    mEstimatedCrossings = EstimateCrossings(clipRegion, polygonPoints, overlap, crossingSampleCount);
+}
+
+//-------------------------------------------------------------------ClipCostModel
+void ClipCostModel::ComputeFeatures(ClipEngine engine, const ClipInputStats& stats, float* features)
+{
+  float n = float(stats.mPolygonVertexCount);
+  float m = float(stats.mClipRegionVertexCount);
+  float k = stats.mEstimatedCrossings;
+  float total = n + m;
+  std::fill(features, features + FeatureCount, 0.0f);
+  features[0] = 1;
+  switch(engine)
+  {
+    case ClipEngine::WeilerAtherton:
+      features[1] = n * m;
+      features[2] = total;
+      features[3] = k;
+      break;
+    case ClipEngine::Scanline:
+      features[1] = total * std::log2(std::max(total, 2.0f));
+      features[2] = k;
+      features[3] = (total + k) * stats.mAverageActiveEdges;
+      break;
+    case ClipEngine::Convex:
+      features[1] = n * m;
+      break;
+    case ClipEngine::Rectangle:
+      features[1] = n;
+      break;
+    case ClipEngine::Automatic:
+      break;
+  }
+}
+
+float ClipCostModel::Estimate(ClipEngine engine, const ClipInputStats& stats) const
+{
+  const float* coefficients = GetCoefficients(engine);
+  if(coefficients == nullptr)
+    return 0;
+
+  float features[FeatureCount];
+  ComputeFeatures(engine, stats, features);
+  float cost = 0;
+  for(size_t i = 0; i < FeatureCount; ++i)
+    cost += coefficients[i] * features[i];
+  return cost;
+}
+
+ClipEngine ClipCostModel::ChooseEngine(ClipOperation operation, const ClipInputStats& stats) const
+{
+  if(!stats.mAabbsOverlap)
+    return ClipEngine::Automatic;
+
+  // The scanline engine handles every input so it's the baseline.
+  ClipEngine best = ClipEngine::Scanline;
+  float bestCost = Estimate(best, stats);
+  auto consider = [&](ClipEngine engine)
+  {
+    float cost = Estimate(engine, stats);
+    if(cost < bestCost)
+    {
+      best = engine;
+      bestCost = cost;
+    }
+  };
+
+  if(operation == ClipOperation::Intersect && stats.mPolygonConvex)
+  {
+    if(stats.mClipRegionRectangle)
+      consider(ClipEngine::Rectangle);
+    if(stats.mClipRegionConvex)
+      consider(ClipEngine::Convex);
+  }
+  // Weiler-Atherton can't trace boundaries that touch without crossing.
+  if(!stats.mBoundariesTouch)
+    consider(ClipEngine::WeilerAtherton);
+  return best;
+}
+
+float* ClipCostModel::GetCoefficients(ClipEngine engine)
+{
+  return const_cast<float*>(static_cast<const ClipCostModel*>(this)->GetCoefficients(engine));
+}
+
+const float* ClipCostModel::GetCoefficients(ClipEngine engine) const
+{
+  switch(engine)
+  {
+    case ClipEngine::WeilerAtherton:
+      return mWeilerAtherton;
+    case ClipEngine::Scanline:
+      return mScanline;
+    case ClipEngine::Convex:
+      return mConvex;
+    case ClipEngine::Rectangle:
+      return mRectangle;
+    case ClipEngine::Automatic:
+      break;
+  }
+  return nullptr;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+//-------------------------------------------------------------------ClipInputStats
+// Cheap statistics about a pair of single contour operands. Everything is O(n + m) except the crossing
+// estimate, which tests a fixed number of edges from the larger operand against all of the smaller one, and the
+// contact test, which sweeps the edges of both in y.
+struct ClipInputStats
+{
+  void Compute(const PointContour& polygonPoints, const PointContour& clipRegion, size_t crossingSampleCount);
+
+  size_t mPolygonVertexCount = 0;
+  size_t mClipRegionVertexCount = 0;
+  bool mPolygonConvex = false;
+  bool mClipRegionConvex = false;
+  bool mClipRegionRectangle = false;
+  // False when the aabbs don't even touch, in which case the result is known without clipping.
+  bool mAabbsOverlap = false;
+  // The area of the aabb overlap relative to the smaller of the two aabbs.
+  float mAabbOverlapRatio = 0;
+  // The sampled crossing count scaled up to all edges.
+  float mEstimatedCrossings = 0;
+  // Whether an edge of one operand touches the other's without properly crossing it, such as a vertex lying on the
+  // other boundary or collinear edges overlapping.
+  bool mBoundariesTouch = false;
+  // How many edges of both operands a horizontal line crosses on average, which is the size of the scanline
+  // engine's active edge list. Each operand contributes the sum of its edge heights over its aabb height.
+  float mAverageActiveEdges = 0;
+};
+
+//-------------------------------------------------------------------ClipCostModel
+// A linear cost model per engine where the estimated time is the dot product of the coefficients with the
+// features from ComputeFeatures (n and m are the vertex counts, k the estimated crossings and a the average
+// active edge count):
+//   WeilerAtherton: 1, n * m, n + m, k
+//   Scanline:       1, (n + m) * log2(n + m), k, (n + m + k) * a
+//   Convex:         1, n * m
+//   Rectangle:      1, n
+// The defaults are in nanoseconds and were fitted by the calibration benchmark (see Benchmarks), which can be
+// rerun to fit the coefficients on a different machine.
+struct ClipCostModel
+{
+  static constexpr size_t FeatureCount = 4;
+
+  static void ComputeFeatures(ClipEngine engine, const ClipInputStats& stats, float* features);
+  float Estimate(ClipEngine engine, const ClipInputStats& stats) const;
+  // Returns the cheapest engine that can produce the operation's result for these inputs. Returns Automatic
+  // when the aabbs don't overlap, as then no engine needs to run.
+  ClipEngine ChooseEngine(ClipOperation operation, const ClipInputStats& stats) const;
+  float* GetCoefficients(ClipEngine engine);
+  const float* GetCoefficients(ClipEngine engine) const;
+
+  float mWeilerAtherton[FeatureCount] = {0.0f, 8.82f, 7.63f, 243.0f};
+  float mScanline[FeatureCount] = {0.0f, 0.0f, 0.0f, 62.5f};
+  float mConvex[FeatureCount] = {424.0f, 3.66f, 0.0f, 0.0f};
+  float mRectangle[FeatureCount] = {237.0f, 17.3f, 0.0f, 0.0f};
+};
+
+//-------------------------------------------------------------------ClipStats
+struct ClipStats
+{
+  // The engine that produced the result. This stays Automatic if the aabbs didn't overlap and the result was
+  // trivial. Forced engines that don't fit the inputs report the scanline engine they fell back to.
+  ClipEngine mEngineUsed = ClipEngine::Automatic;
+  // Only filled out when the engine was chosen automatically.
+  ClipInputStats mInputStats;
+  float mEstimatedCost = 0;
+};
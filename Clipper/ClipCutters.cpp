@@ -0,0 +1,185 @@
+#include "Clipper.hpp"
+
+#include "ScanlineClipper.hpp"
+#include "StrTree.hpp"
+
+#include <algorithm>
+
+static size_t FindGroup(Array<size_t>& parents, size_t index)
+{
+  while(parents[index] != index)
+  {
+    parents[index] = parents[parents[index]];
+    index = parents[index];
+  }
+  return index;
+}
+
+static Aabb ComputeAabb(const ClipVertexList& vertices)
+{
+  Aabb result;
+  ClipVertex::Traverse(vertices.mHead, [&result](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    result.Expand(vertex->mPoint);
+    return true;
+  });
+  return result;
+}
+
+static bool HasIntersections(const ClipVertexList& vertices)
+{
+  return ClipVertex::FindFirstIntersection(vertices.mHead) != nullptr;
+}
+
+// Even-odd test against every piece at once. The pieces don't overlap, so this is inside the merged cutters.
+static bool IsInsidePieces(const Array<ClipVertexList>& pieces, const Vec2& point)
+{
+  bool inside = false;
+  for(const ClipVertexList& piece : pieces)
+  {
+    ClipVertex::Traverse(piece.mHead, [&inside, &point](ClipVertex* vertex, ClipVertex*& nextVertex)
+    {
+      const Vec2& a = vertex->mPoint;
+      const Vec2& b = vertex->mNext->mPoint;
+      if((a.y > point.y) != (b.y > point.y))
+      {
+        float x = a.x + (point.y - a.y) * (b.x - a.x) / (b.y - a.y);
+        if(point.x < x)
+          inside = !inside;
+      }
+      return true;
+    });
+  }
+  return inside;
+}
+
+// Emits a whole vertex list as one contour, walking it in the given direction.
+static void EmitVertexList(const ClipVertexList& vertices, ClipVertexSearchDirection direction, ClipContourSink& sink)
+{
+  sink.BeginContour();
+  ClipVertex* vertex = vertices.mHead;
+  do
+  {
+    sink.AddVertex(*vertex);
+    vertex = vertex->GetNext(direction);
+  } while(vertex != vertices.mHead);
+  sink.EndContour();
+}
+
+//-------------------------------------------------------------------Clipper
+void Clipper::MergeCutters(const PointContourList& cutters, Array<ClipVertexList>& pieces)
+{
+  pieces.clear();
+  size_t count = cutters.size();
+  Array<Aabb> aabbs(count);
+  for(size_t i = 0; i < count; ++i)
+    aabbs[i] = ComputeAabb(cutters[i]);
+  StrTree tree;
+  tree.Build(aabbs);
+
+  // Group cutters that share any point with a union-find
+  Array<size_t> parents(count);
+  for(size_t i = 0; i < count; ++i)
+    parents[i] = i;
+  for(size_t i = 0; i < count; ++i)
+  {
+    tree.Query(aabbs[i], [&](size_t j)
+    {
+      if(j <= i)
+        return;
+      size_t groupI = FindGroup(parents, i);
+      size_t groupJ = FindGroup(parents, j);
+      if(groupI != groupJ && Intersects(cutters[i], cutters[j]))
+        parents[groupJ] = groupI;
+    });
+  }
+
+  // Orient every cutter clockwise so overlapping cutters add up under the non-zero rule
+  Array<PointContourList> groups(count);
+  for(size_t i = 0; i < count; ++i)
+  {
+    float area = ComputeSignedArea(cutters[i]);
+    if(cutters[i].size() < 3 || area == 0)
+      continue;
+    PointContourList& group = groups[FindGroup(parents, i)];
+    group.push_back(cutters[i]);
+    if(area > 0)
+      std::reverse(group.back().begin(), group.back().end());
+  }
+
+  ScanlineClipper scanline;
+  scanline.mFillRule = ClipFillRule::NonZero;
+  scanline.mClockwiseOutput = true;
+  for(const PointContourList& group : groups)
+  {
+    if(group.size() == 1)
+    {
+      pieces.emplace_back();
+      BuildVertexList(group[0], ClipOperand::ClipRegion, pieces.back());
+    }
+    else if(group.size() > 1)
+    {
+      scanline.Execute(ClipOperation::Union, group, PointContourList(), [this, &pieces](const PointContour& contour)
+      {
+        pieces.emplace_back();
+        BuildVertexList(contour, ClipOperand::ClipRegion, pieces.back());
+      });
+    }
+  }
+}
+
+void Clipper::Subtract(const PointContour& polygonPoints, const PointContourList& cutters, PointContourList& contours)
+{
+  ClearOutput(contours);
+  float polygonArea = ComputeSignedArea(polygonPoints);
+  if(polygonPoints.size() < 3 || polygonArea == 0)
+    return;
+
+  Array<ClipVertexList> pieces;
+  MergeCutters(cutters, pieces);
+  ClipVertexList polyList;
+  BuildVertexList(polygonPoints, polyList);
+  if(polygonArea > 0)
+    polyList.Reverse();
+
+  Array<Aabb> aabbs(pieces.size());
+  for(size_t i = 0; i < pieces.size(); ++i)
+    aabbs[i] = ComputeAabb(pieces[i]);
+  StrTree tree;
+  tree.Build(aabbs);
+
+  // One intersection phase against every cutter. Each edge gathers the intersections from all the cutters it
+  // could touch before any are linked in, as they all have to go into the edge in t-order.
+  Array<ClipEdgeIntersection> intersections;
+  ClipVertex::Traverse(polyList.mHead, [&](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    ClipVertex* end = vertex->mNext;
+    intersections.clear();
+    tree.Query(Aabb::FromSegment(vertex->mPoint, end->mPoint), [&](size_t pieceIndex)
+    {
+      FindEdgeIntersections(vertex, end, pieces[pieceIndex], intersections);
+    });
+    InsertEdgeIntersections(vertex, end, intersections);
+    return true;
+  });
+
+  PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+  CleanupContourSink sink(pointSink, mCleanup);
+  if(HasIntersections(polyList))
+  {
+    ClassifyVertices(polyList);
+    Subtract(polyList, sink);
+  }
+  else if(!IsInsidePieces(pieces, polygonPoints[0]))
+    EmitVertexList(polyList, ClipVertexSearchDirection::Forwards, sink);
+
+  // A piece that never crossed the polygon but is inside of it bounds the result on its own. Outer pieces
+  // become holes and the holes of merged cutters become islands, both reversed from the piece's winding.
+  for(const ClipVertexList& piece : pieces)
+  {
+    if(HasIntersections(piece) || !ContainsPoint(polygonPoints, piece.mHead->mPoint))
+      continue;
+
+    EmitVertexList(piece, ClipVertexSearchDirection::Backward, sink);
+  }
+}
@@ -0,0 +1,245 @@
+#include "ClipExpr.hpp"
+
+#include "ClipParallel.hpp"
+#include "ScanlineClipper.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static float ComputePiecesArea(const Array<ClipVertexList>& pieces)
+{
+  float area = 0;
+  for(const ClipVertexList& piece : pieces)
+  {
+    ClipVertex::Traverse(piece.mHead, [&area](ClipVertex* vertex, ClipVertex*& nextVertex)
+    {
+      area += Cross2d(vertex->mPoint, vertex->mNext->mPoint);
+      return true;
+    });
+  }
+  return std::abs(area * 0.5f);
+}
+
+static void MovePieces(Array<ClipVertexList>& source, Array<ClipVertexList>& destination)
+{
+  for(ClipVertexList& piece : source)
+    destination.push_back(std::move(piece));
+  source.clear();
+}
+
+// Runs the scanline engine and builds each result contour straight into a piece.
+template <typename OperandList>
+static void SweepIntoPieces(ClipOperation operation, ClipFillRule fillRule, const OperandList& subject, const OperandList& clip, Array<ClipVertexList>& results)
+{
+  ScanlineClipper scanline;
+  scanline.mFillRule = fillRule;
+  scanline.mClockwiseOutput = true;
+  Clipper clipper;
+  scanline.Execute(operation, subject, clip, [&results, &clipper](const PointContour& contour)
+  {
+    results.emplace_back();
+    clipper.BuildVertexList(contour, results.back());
+  });
+}
+
+//-------------------------------------------------------------------ClipExpr
+ClipExpr::NodeId ClipExpr::AddOperand(const PointContour& contour)
+{
+  return AddOperand(PointContourList{contour});
+}
+
+ClipExpr::NodeId ClipExpr::AddOperand(const PointContourList& contours)
+{
+  NodeId nodeId = AddNode(ClipExprType::Operand, 0, 0);
+  mNodes[nodeId].mContours = contours;
+  return nodeId;
+}
+
+ClipExpr::NodeId ClipExpr::Union(NodeId lhs, NodeId rhs)
+{
+  return AddNode(ClipExprType::Union, lhs, rhs);
+}
+
+ClipExpr::NodeId ClipExpr::Intersect(NodeId lhs, NodeId rhs)
+{
+  return AddNode(ClipExprType::Intersect, lhs, rhs);
+}
+
+ClipExpr::NodeId ClipExpr::Subtract(NodeId lhs, NodeId rhs)
+{
+  return AddNode(ClipExprType::Subtract, lhs, rhs);
+}
+
+ClipExpr::NodeId ClipExpr::Xor(NodeId lhs, NodeId rhs)
+{
+  return AddNode(ClipExprType::Xor, lhs, rhs);
+}
+
+void ClipExpr::Clear()
+{
+  mNodes.clear();
+}
+
+void ClipExpr::Evaluate(NodeId root, PointContourList& results)
+{
+  results.clear();
+  mSweeps = 0;
+  mFusedOperations = 0;
+
+  Pieces pieces;
+  EvaluateNode(root, mThreadCount, pieces);
+  mStats.mSweeps = mSweeps;
+  mStats.mFusedOperations = mFusedOperations;
+
+  for(const ClipVertexList& piece : pieces)
+  {
+    results.emplace_back();
+    PointContour& contour = results.back();
+    ClipVertex::Traverse(piece.mHead, [&contour](ClipVertex* vertex, ClipVertex*& nextVertex)
+    {
+      contour.push_back(vertex->mPoint);
+      return true;
+    });
+    // The pieces wind clockwise
+    if(!mClockwiseOutput)
+      std::reverse(contour.begin(), contour.end());
+  }
+}
+
+ClipExpr::NodeId ClipExpr::AddNode(ClipExprType type, NodeId lhs, NodeId rhs)
+{
+  Node node;
+  node.mType = type;
+  node.mLhs = lhs;
+  node.mRhs = rhs;
+  mNodes.push_back(node);
+  return mNodes.size() - 1;
+}
+
+void ClipExpr::EvaluateNode(NodeId nodeId, size_t threadCount, Pieces& pieces)
+{
+  const Node& node = mNodes[nodeId];
+  switch(node.mType)
+  {
+    case ClipExprType::Operand:
+      EvaluateOperand(node, pieces);
+      break;
+    case ClipExprType::Union:
+    case ClipExprType::Xor:
+    {
+      // Every operand is simple and wound clockwise, so inside an operand adds exactly -1 to the winding.
+      // The union is anywhere that's non-zero and the xor anywhere that's odd, so one sweep covers all operands.
+      Array<NodeId> operands;
+      CollectOperands(nodeId, node.mType, operands);
+      mFusedOperations += operands.size() - 2;
+      Array<Pieces> operandPieces;
+      EvaluateAll(operands, threadCount, operandPieces);
+
+      Pieces subject;
+      for(Pieces& operand : operandPieces)
+        MovePieces(operand, subject);
+      ClipFillRule fillRule = node.mType == ClipExprType::Union ? ClipFillRule::NonZero : ClipFillRule::EvenOdd;
+      Sweep(ClipOperation::Union, fillRule, subject, Pieces(), pieces);
+      break;
+    }
+    case ClipExprType::Subtract:
+    {
+      // (A - B) - C is A - (B u C), and subtracting a union subtracts each of its operands.
+      Array<NodeId> operands;
+      NodeId minuend = nodeId;
+      while(mNodes[minuend].mType == ClipExprType::Subtract)
+      {
+        CollectOperands(mNodes[minuend].mRhs, ClipExprType::Union, operands);
+        minuend = mNodes[minuend].mLhs;
+      }
+      mFusedOperations += operands.size() - 1;
+      operands.insert(operands.begin(), minuend);
+      Array<Pieces> operandPieces;
+      EvaluateAll(operands, threadCount, operandPieces);
+
+      Pieces clip;
+      for(size_t i = 1; i < operandPieces.size(); ++i)
+        MovePieces(operandPieces[i], clip);
+      Sweep(ClipOperation::Subtract, ClipFillRule::NonZero, operandPieces[0], clip, pieces);
+      break;
+    }
+    case ClipExprType::Intersect:
+    {
+      Array<NodeId> operands;
+      CollectOperands(nodeId, ClipExprType::Intersect, operands);
+      mFusedOperations += operands.size() - 2;
+      Array<Pieces> operandPieces;
+      EvaluateAll(operands, threadCount, operandPieces);
+
+      // Intersection is commutative, so start with the smallest operands to keep the intermediate results small
+      Array<std::pair<float, size_t>> order;
+      for(size_t i = 0; i < operandPieces.size(); ++i)
+        order.push_back(std::make_pair(ComputePiecesArea(operandPieces[i]), i));
+      std::sort(order.begin(), order.end());
+
+      pieces = std::move(operandPieces[order[0].second]);
+      for(size_t i = 1; i < order.size() && !pieces.empty(); ++i)
+      {
+        Pieces result;
+        Sweep(ClipOperation::Intersect, ClipFillRule::NonZero, pieces, operandPieces[order[i].second], result);
+        pieces = std::move(result);
+      }
+      break;
+    }
+  }
+}
+
+void ClipExpr::EvaluateOperand(const Node& node, Pieces& pieces)
+{
+  Clipper clipper;
+  // A single simple contour only needs its winding fixed, anything else is normalized with a sweep.
+  if(node.mContours.size() == 1 && !clipper.HasSelfIntersections(node.mContours[0]))
+  {
+    const PointContour& contour = node.mContours[0];
+    float area = ComputeSignedArea(contour);
+    if(area == 0)
+      return;
+    if((mFillRule == ClipFillRule::Positive && area < 0) || (mFillRule == ClipFillRule::Negative && area > 0))
+      return;
+
+    pieces.emplace_back();
+    clipper.BuildVertexList(contour, pieces.back());
+    if(area > 0)
+      pieces.back().Reverse();
+    return;
+  }
+
+  ++mSweeps;
+  SweepIntoPieces(ClipOperation::Union, mFillRule, node.mContours, PointContourList(), pieces);
+}
+
+void ClipExpr::EvaluateAll(const Array<NodeId>& nodeIds, size_t threadCount, Array<Pieces>& results)
+{
+  // The operands split the threads between them, so however deep the expression goes no more run at once than
+  // were asked for. Operands that get a single thread evaluate everything below them serially.
+  threadCount = ResolveThreadCount(threadCount);
+  size_t operandThreadCount = std::max(threadCount / std::max(nodeIds.size(), size_t(1)), size_t(1));
+  results.resize(nodeIds.size());
+  ParallelFor(nodeIds.size(), threadCount, [&](size_t index, size_t threadIndex)
+  {
+    EvaluateNode(nodeIds[index], operandThreadCount, results[index]);
+  });
+}
+
+void ClipExpr::CollectOperands(NodeId nodeId, ClipExprType type, Array<NodeId>& operands) const
+{
+  const Node& node = mNodes[nodeId];
+  if(node.mType != type)
+  {
+    operands.push_back(nodeId);
+    return;
+  }
+  CollectOperands(node.mLhs, type, operands);
+  CollectOperands(node.mRhs, type, operands);
+}
+
+void ClipExpr::Sweep(ClipOperation operation, ClipFillRule fillRule, const Pieces& subject, const Pieces& clip, Pieces& results)
+{
+  ++mSweeps;
+  SweepIntoPieces(operation, fillRule, subject, clip, results);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+#include <atomic>
+
+enum class ClipExprType
+{
+  Operand,
+  Union,
+  Intersect,
+  Subtract,
+  Xor
+};
+
+//-------------------------------------------------------------------ClipExprStats
+struct ClipExprStats
+{
+  // Scanline sweeps run, including the ones that normalize self-intersecting operands.
+  size_t mSweeps = 0;
+  // Binary operations that were folded into a larger sweep instead of running on their own.
+  size_t mFusedOperations = 0;
+};
+
+//-------------------------------------------------------------------ClipExpr
+// A lazily evaluated boolean expression over polygons, such as ((A u B) - C) n D. Nodes are added through the
+// builder functions and referenced by id, nothing is clipped until Evaluate. Intermediate results stay as
+// ClipVertexList pieces (clockwise outer contours and counter-clockwise holes) and are fed straight into the
+// next sweep, only the root is converted back to contours. Evaluation rewrites the expression where it's legal:
+// - Nested unions and xors flatten into one node, which takes a single sweep no matter how many operands it has.
+// - Chained subtractions ((A - B) - C) and subtracting a union (A - (B u C)) fuse into one sweep that subtracts
+//   every subtrahend at once.
+// - Nested intersections flatten and run smallest operand first, stopping as soon as the result is empty.
+// The operands of a node are independent, so they're evaluated in parallel when mThreadCount allows. Nested nodes
+// share out their parent's threads, so mThreadCount bounds the threads running at once for the whole expression.
+// Reusing a node in several places evaluates it once per use.
+struct ClipExpr
+{
+  typedef size_t NodeId;
+
+  NodeId AddOperand(const PointContour& contour);
+  // The contours are filled together with mFillRule, so they can describe holes or overlap.
+  NodeId AddOperand(const PointContourList& contours);
+  NodeId Union(NodeId lhs, NodeId rhs);
+  NodeId Intersect(NodeId lhs, NodeId rhs);
+  NodeId Subtract(NodeId lhs, NodeId rhs);
+  NodeId Xor(NodeId lhs, NodeId rhs);
+  void Clear();
+
+  void Evaluate(NodeId root, PointContourList& results);
+
+  // How each operand's contours are filled. Intermediate results are always simple so this only affects operands.
+  ClipFillRule mFillRule = ClipFillRule::EvenOdd;
+  // Results wind outer contours counter-clockwise and holes clockwise. This flips both.
+  bool mClockwiseOutput = false;
+  // The most threads the whole evaluation runs at once. Zero uses all hardware threads.
+  size_t mThreadCount = 1;
+  ClipExprStats mStats;
+
+private:
+  typedef Array<ClipVertexList> Pieces;
+
+  struct Node
+  {
+    ClipExprType mType = ClipExprType::Operand;
+    NodeId mLhs = 0;
+    NodeId mRhs = 0;
+    PointContourList mContours;
+  };
+
+  NodeId AddNode(ClipExprType type, NodeId lhs, NodeId rhs);
+  // Evaluates a node using up to threadCount threads for it and everything below it.
+  void EvaluateNode(NodeId nodeId, size_t threadCount, Pieces& pieces);
+  void EvaluateOperand(const Node& node, Pieces& pieces);
+  void EvaluateAll(const Array<NodeId>& nodeIds, size_t threadCount, Array<Pieces>& results);
+  // Collects the operands of nested nodes of the given type, so (A u B) u C gives A, B and C.
+  void CollectOperands(NodeId nodeId, ClipExprType type, Array<NodeId>& operands) const;
+  void Sweep(ClipOperation operation, ClipFillRule fillRule, const Pieces& subject, const Pieces& clip, Pieces& results);
+
+  Array<Node> mNodes;
+  std::atomic<size_t> mSweeps{0};
+  std::atomic<size_t> mFusedOperations{0};
+};
@@ -0,0 +1,230 @@
+#include "ClipJob.hpp"
+
+// How much work can go by between reads of the clock.
+static const size_t ClockCheckInterval = 256;
+
+//-------------------------------------------------------------------ClipJob
+ClipJob::ClipJob(Clipper& clipper, ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, ClipContourSink& sink)
+  : mClipper(clipper), mOperation(operation), mPolygonPoints(polygonPoints), mClipRegion(clipRegion),
+  mSink(sink, clipper.mCleanup), mPolyList(&clipper.mVertexPool), mClipRegionList(&clipper.mVertexPool)
+{
+}
+
+ClipJobStatus ClipJob::Run(const ClipJobBudget& budget)
+{
+  mBudget = budget;
+  mRunStart = std::chrono::steady_clock::now();
+  mWork = 0;
+  mWorkAtClockCheck = 0;
+  while(mStatus == ClipJobStatus::Running)
+  {
+    if(mPhase == Phase::Done)
+    {
+      mStatus = ClipJobStatus::Finished;
+      break;
+    }
+    if(mCancelRequested)
+    {
+      mStatus = ClipJobStatus::Cancelled;
+      break;
+    }
+
+    switch(mPhase)
+    {
+      case Phase::Build:
+        Build();
+        break;
+      case Phase::Clip:
+        Clip();
+        break;
+      case Phase::Trace:
+        Trace();
+        break;
+      case Phase::Done:
+        break;
+    }
+    if(mPhase != Phase::Done && IsBudgetSpent())
+      break;
+  }
+  if(mStatus == ClipJobStatus::Running && mCancelRequested)
+    mStatus = ClipJobStatus::Cancelled;
+  return mStatus;
+}
+
+void ClipJob::Build()
+{
+  if(mPolygonPoints.size() < 3 || mClipRegion.size() < 3)
+  {
+    mPhase = Phase::Done;
+    return;
+  }
+
+  mClipper.BuildVertexList(mPolygonPoints, ClipOperand::Polygon, mPolyList);
+  mClipper.BuildVertexList(mClipRegion, ClipOperand::ClipRegion, mClipRegionList);
+  if(ComputeSignedArea(mPolygonPoints) > 0)
+    mPolyList.Reverse();
+  if(ComputeSignedArea(mClipRegion) > 0)
+    mClipRegionList.Reverse();
+  mWork += mPolygonPoints.size() + mClipRegion.size();
+  mEdgeStart = mPolyList.mHead;
+  mEdgesLeft = mPolygonPoints.size();
+  mPhase = Phase::Clip;
+}
+
+void ClipJob::Clip()
+{
+  // The same edge by edge loop as Clipper::ClipPolygon. New vertices only go between the edge's own ends, so the
+  // end of one edge is always the start of the next original edge.
+  do
+  {
+    ClipVertex* end = mEdgeStart->mNext;
+    mClipper.ClipEdges(mEdgeStart, end, mClipRegionList);
+    mWork += mClipRegion.size();
+    mEdgeStart = end;
+    --mEdgesLeft;
+    if(mEdgesLeft == 0)
+    {
+      mClipper.ClassifyVertices(mPolyList);
+      mClipper.ClassifyVertices(mClipRegionList);
+      if(ClipVertex::FindFirstIntersection(mPolyList.mHead) == nullptr)
+      {
+        EmitUncrossed(mOperation, mPolygonPoints.data(), mPolygonPoints.size(), mClipRegion.data(), mClipRegion.size(), mSink);
+        mPhase = Phase::Done;
+      }
+      else
+        mPhase = BeginPass(mPolyList) ? Phase::Trace : Phase::Done;
+      return;
+    }
+  } while(!IsBudgetSpent());
+}
+
+void ClipJob::Trace()
+{
+  do
+  {
+    if(TraceVertex())
+    {
+      ++mWork;
+      continue;
+    }
+
+    // Xor traces the clip region minus the polygon next, from clean lists.
+    if(mOperation == ClipOperation::Xor && mPass == 0)
+    {
+      mPass = 1;
+      mClipper.ResetVisited(mPolyList);
+      mClipper.ResetVisited(mClipRegionList);
+      if(BeginPass(mClipRegionList))
+        continue;
+    }
+    mPhase = Phase::Done;
+    return;
+  } while(!IsBudgetSpent());
+}
+
+bool ClipJob::BeginPass(ClipVertexList& list)
+{
+  mContourStart = nullptr;
+  mVerticesToVisit.clear();
+  switch(mOperation)
+  {
+    case ClipOperation::Union:
+    {
+      // The outer loop goes last so it's traced first, then the polygon's exits that it didn't pass through are holes.
+      ClipVertex* start = ClipVertex::FindUnionStart(list.mHead);
+      if(start == nullptr)
+        return false;
+      ClipVertex::Traverse(list.mHead->mPrev, [this](ClipVertex* vertex, ClipVertex*& nextVertex)
+      {
+        if(vertex->mClassification == ClipVertexClassification::InToOut)
+          mVerticesToVisit.push_back(vertex);
+        nextVertex = vertex->mPrev;
+        return true;
+      });
+      mVerticesToVisit.push_back(start);
+      return true;
+    }
+    case ClipOperation::Subtract:
+    case ClipOperation::Xor:
+      mVerticesToVisit.push_back(ClipVertex::FindFirstOf(list.mHead, ClipVertexClassification::InToOut));
+      break;
+    case ClipOperation::Intersect:
+      mVerticesToVisit.push_back(ClipVertex::FindFirstOf(list.mHead, ClipVertexClassification::OutToIn));
+      break;
+  }
+  return mVerticesToVisit.back() != nullptr;
+}
+
+bool ClipJob::TraceVertex()
+{
+  // The tracers are TraceUnion, Clipper::Subtract and Clipper::Intersect unrolled one vertex at a time.
+  if(mContourStart == nullptr)
+  {
+    do
+    {
+      if(mVerticesToVisit.empty())
+        return false;
+      mContourStart = mVerticesToVisit.back();
+      mVerticesToVisit.pop_back();
+    } while(mContourStart->mVisited);
+    mVertex = mContourStart;
+    mDirection = ClipVertexSearchDirection::Forwards;
+    mSink.BeginContour();
+  }
+
+  mSink.AddVertex(*mVertex);
+  mVertex->mVisited = true;
+  if(mOperation == ClipOperation::Union)
+  {
+    // A union loop is closed at its first visited vertex.
+    mVertex = mVertex->GetNextOnUnion();
+    if(mVertex->mVisited)
+    {
+      mSink.EndContour();
+      mContourStart = nullptr;
+    }
+    return true;
+  }
+  if(mOperation == ClipOperation::Intersect)
+  {
+    mVertex = mVertex->mNext;
+    if(mVertex->mClassification == ClipVertexClassification::InToOut)
+    {
+      if(!mVertex->mVisited)
+        mVerticesToVisit.push_back(ClipVertex::FindFirstOf(mVertex, ClipVertexClassification::OutToIn));
+      mVertex = mVertex->mTwin;
+    }
+  }
+  else
+  {
+    mVertex = mVertex->GetNext(mDirection);
+    if(mVertex->mTwin != nullptr)
+    {
+      if(!mVertex->mVisited && mDirection == ClipVertexSearchDirection::Forwards && mVertex->mClassification == ClipVertexClassification::OutToIn)
+        mVerticesToVisit.push_back(ClipVertex::FindFirstOf(mVertex, ClipVertexClassification::InToOut));
+      mDirection = FlipSearchDirection(mDirection);
+      mVertex = mVertex->mTwin;
+    }
+  }
+  if(mVertex == mContourStart || mVertex->mTwin == mContourStart)
+  {
+    mSink.EndContour();
+    mContourStart = nullptr;
+  }
+  return true;
+}
+
+bool ClipJob::IsBudgetSpent()
+{
+  if(mCancelRequested)
+    return true;
+  if(mBudget.mMaxWork != 0 && mWork >= mBudget.mMaxWork)
+    return true;
+  if(mBudget.mMaxMilliseconds > 0 && mWork - mWorkAtClockCheck >= ClockCheckInterval)
+  {
+    mWorkAtClockCheck = mWork;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - mRunStart;
+    return elapsed.count() >= mBudget.mMaxMilliseconds;
+  }
+  return false;
+}
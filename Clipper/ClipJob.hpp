@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+#include <atomic>
+#include <chrono>
+
+enum class ClipJobStatus
+{
+  // The budget ran out. Call Run again to continue.
+  Running,
+  Finished,
+  Cancelled
+};
+
+//-------------------------------------------------------------------ClipJobBudget
+// How much a single ClipJob::Run may do before it yields. Zero means no limit. Work is counted in edge tests during
+// the intersection phase and in traced vertices afterwards. The clock is only read every so often, so a run can
+// overshoot the time by a fraction of the work between checks.
+struct ClipJobBudget
+{
+  size_t mMaxWork = 0;
+  double mMaxMilliseconds = 0;
+};
+
+//-------------------------------------------------------------------ClipJob
+// A Weiler-Atherton operation that can be spread over several frames. The intersection phase and the tracers keep
+// their cursor in the job, so each Run picks up where the last one stopped. Building and classifying the vertex
+// lists are linear and run without yielding. Results are the same as Clipper::Execute with a sink and go to the
+// sink as they're traced, so the sink and the clipper (whose pool, scratch buffers and cleanup options the job
+// uses) have to outlive the job. The operands are copied.
+struct ClipJob
+{
+  ClipJob(Clipper& clipper, ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, ClipContourSink& sink);
+  ClipJob(const ClipJob&) = delete;
+  ClipJob& operator=(const ClipJob&) = delete;
+
+  // Runs until the job finishes, is cancelled or the budget is spent. Every call makes some progress.
+  ClipJobStatus Run(const ClipJobBudget& budget = ClipJobBudget());
+  // Asks the job to stop at its next check, which may be from another thread. What the sink received from a
+  // cancelled job is incomplete and should be thrown away.
+  void Cancel() { mCancelRequested = true; }
+  ClipJobStatus GetStatus() const { return mStatus; }
+
+private:
+  enum class Phase
+  {
+    Build,
+    Clip,
+    Trace,
+    Done
+  };
+
+  void Build();
+  void Clip();
+  void Trace();
+  // Starts tracing a list, or returns false if the list has nothing to trace for the operation.
+  bool BeginPass(ClipVertexList& list);
+  // Moves along the current contour by one vertex. Returns false once the pass is done.
+  bool TraceVertex();
+  bool IsBudgetSpent();
+
+  Clipper& mClipper;
+  ClipOperation mOperation;
+  PointContour mPolygonPoints;
+  PointContour mClipRegion;
+  CleanupContourSink mSink;
+  ClipVertexList mPolyList;
+  ClipVertexList mClipRegionList;
+  Phase mPhase = Phase::Build;
+  ClipJobStatus mStatus = ClipJobStatus::Running;
+  std::atomic<bool> mCancelRequested{false};
+
+  // The next polygon edge to clip and how many are left.
+  ClipVertex* mEdgeStart = nullptr;
+  size_t mEdgesLeft = 0;
+
+  // The tracing cursor. Xor traces the polygon's list and then the clip region's.
+  size_t mPass = 0;
+  ClipVertex* mContourStart = nullptr;
+  ClipVertex* mVertex = nullptr;
+  ClipVertexSearchDirection mDirection = ClipVertexSearchDirection::Forwards;
+  Array<ClipVertex*> mVerticesToVisit;
+
+  ClipJobBudget mBudget;
+  std::chrono::steady_clock::time_point mRunStart;
+  size_t mWork = 0;
+  size_t mWorkAtClockCheck = 0;
+};
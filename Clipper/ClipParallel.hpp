@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Resolves a requested thread count, where zero means use all hardware threads.
+inline size_t ResolveThreadCount(size_t threadCount)
+{
+  if(threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  return threadCount;
+}
+
+// Runs the callback for every index in [0, count) across the given number of threads. Indices are handed out
+// dynamically so uneven work balances out. The callback receives (index, threadIndex) where the thread index
+// is in [0, threadCount) so callers can keep per-thread scratch data. Results should be written into per-index
+// slots so the output doesn't depend on scheduling.
+template <typename Callback>
+void ParallelFor(size_t count, size_t threadCount, Callback callback)
+{
+  threadCount = std::min(ResolveThreadCount(threadCount), count);
+  if(threadCount <= 1)
+  {
+    for(size_t i = 0; i < count; ++i)
+      callback(i, size_t(0));
+    return;
+  }
+
+  std::atomic<size_t> nextIndex{0};
+  auto worker = [&nextIndex, &callback, count](size_t threadIndex)
+  {
+    for(size_t i = nextIndex++; i < count; i = nextIndex++)
+      callback(i, threadIndex);
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for(size_t i = 1; i < threadCount; ++i)
+    threads.emplace_back(worker, i);
+  worker(0);
+  for(std::thread& thread : threads)
+    thread.join();
+}
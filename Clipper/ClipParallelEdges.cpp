@@ -0,0 +1,249 @@
+#include "Clipper.hpp"
+
+#include "ClipParallel.hpp"
+
+// Below this many edge pairs starting the threads costs more than the intersection phase itself.
+static const size_t ParallelMinEdgePairs = size_t(1) << 16;
+// Ranges per thread, so threads that finish early can pick up more work.
+static const size_t ChunksPerThread = 8;
+
+// A crossing between a polygon edge and a clip region edge, found before any vertices are created.
+struct EdgeCrossing
+{
+  size_t mPolygonEdge;
+  size_t mClipEdge;
+  float mTime;
+  float mClipTime;
+  ClipVertexClassification mPolygonFlags;
+  ClipVertexClassification mClipFlags;
+};
+
+// The original vertices of a list in list order. Edge i runs from vertex i to the next one.
+static void GatherVertices(ClipVertexList& list, Array<ClipVertex*>& vertices)
+{
+  ClipVertex::Traverse(list.mHead, [&vertices](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    vertices.push_back(vertex);
+    return true;
+  });
+}
+
+// Links the ordered vertices into a loop.
+static void LinkLoop(const Array<ClipVertex*>& vertices)
+{
+  size_t count = vertices.size();
+  for(size_t i = 0; i < count; ++i)
+  {
+    ClipVertex* next = vertices[(i + 1) % count];
+    vertices[i]->mNext = next;
+    next->mPrev = vertices[i];
+  }
+}
+
+static ClipVertex* AllocateVertex(ClipVertexPool* pool)
+{
+  if(pool != nullptr)
+    return pool->Allocate();
+  return new ClipVertex();
+}
+
+// The same labels as Clipper::ClassifyVertices. Walking from the first unclassified vertex, each one takes the
+// state of the last crossing before it, or inside before the first one, so each chunk only needs the last
+// crossing of the chunks before it. That's a prefix scan over the chunks' last crossings.
+static void ClassifyVerticesParallel(const Array<ClipVertex*>& order, size_t threadCount)
+{
+  size_t first = 0;
+  while(first < order.size() && order[first]->mClassification != ClipVertexClassification::None)
+    ++first;
+  if(first == order.size())
+    return;
+  Array<ClipVertex*> vertices(order.begin() + first, order.end());
+  vertices.insert(vertices.end(), order.begin(), order.begin() + first);
+
+  size_t count = vertices.size();
+  size_t chunkCount = std::min(count, threadCount * ChunksPerThread);
+  auto chunkBegin = [count, chunkCount](size_t chunk) { return chunk * count / chunkCount; };
+
+  Array<ClipVertexClassification> lastCrossings(chunkCount, ClipVertexClassification::None);
+  ParallelFor(chunkCount, threadCount, [&](size_t chunk, size_t threadIndex)
+  {
+    for(size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i)
+    {
+      ClipVertexClassification classification = vertices[i]->mClassification;
+      if(classification == ClipVertexClassification::InToOut || classification == ClipVertexClassification::OutToIn)
+        lastCrossings[chunk] = classification;
+    }
+  });
+
+  Array<ClipVertexClassification> startStates(chunkCount);
+  ClipVertexClassification state = ClipVertexClassification::Inside;
+  for(size_t chunk = 0; chunk < chunkCount; ++chunk)
+  {
+    startStates[chunk] = state;
+    if(lastCrossings[chunk] == ClipVertexClassification::InToOut)
+      state = ClipVertexClassification::Outside;
+    else if(lastCrossings[chunk] == ClipVertexClassification::OutToIn)
+      state = ClipVertexClassification::Inside;
+  }
+
+  ParallelFor(chunkCount, threadCount, [&](size_t chunk, size_t threadIndex)
+  {
+    ClipVertexClassification flags = startStates[chunk];
+    for(size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i)
+    {
+      ClipVertex* vertex = vertices[i];
+      if(vertex->mClassification == ClipVertexClassification::None)
+        vertex->mClassification = flags;
+      else if(vertex->mClassification == ClipVertexClassification::InToOut)
+        flags = ClipVertexClassification::Outside;
+      else if(vertex->mClassification == ClipVertexClassification::OutToIn)
+        flags = ClipVertexClassification::Inside;
+    }
+  });
+}
+
+//-------------------------------------------------------------------Clipper
+void Clipper::ClipPolygonParallel(ClipVertexList& polygonToClip, ClipVertexList& clipRegion)
+{
+  Array<ClipVertex*> polygonVertices;
+  Array<ClipVertex*> clipVertices;
+  GatherVertices(polygonToClip, polygonVertices);
+  GatherVertices(clipRegion, clipVertices);
+  size_t polygonCount = polygonVertices.size();
+  size_t clipCount = clipVertices.size();
+  size_t threadCount = std::min(ResolveThreadCount(mThreadCount), polygonCount);
+  if(threadCount <= 1 || polygonCount * clipCount < ParallelMinEdgePairs)
+  {
+    ClipPolygon(polygonToClip, clipRegion);
+    ClassifyVertices(polygonToClip);
+    ClassifyVertices(clipRegion);
+    return;
+  }
+
+  // Copy the points out so the inner loop runs over contiguous memory.
+  Array<Vec2> clipPoints(clipCount + 1);
+  for(size_t i = 0; i < clipCount; ++i)
+    clipPoints[i] = clipVertices[i]->mPoint;
+  clipPoints[clipCount] = clipPoints[0];
+
+  // Each range of polygon edges collects its own crossings, already in edge and time order, so concatenating the
+  // ranges gives the same order whichever thread ran them.
+  size_t chunkCount = std::min(polygonCount, threadCount * ChunksPerThread);
+  Array<Array<EdgeCrossing>> chunkCrossings(chunkCount);
+  ParallelFor(chunkCount, threadCount, [&](size_t chunk, size_t threadIndex)
+  {
+    Array<EdgeCrossing>& crossings = chunkCrossings[chunk];
+    size_t begin = chunk * polygonCount / chunkCount;
+    size_t end = (chunk + 1) * polygonCount / chunkCount;
+    for(size_t i = begin; i < end; ++i)
+    {
+      const Vec2& start = polygonVertices[i]->mPoint;
+      const Vec2& edgeEnd = polygonVertices[(i + 1) % polygonCount]->mPoint;
+      size_t edgeBegin = crossings.size();
+      for(size_t j = 0; j < clipCount; ++j)
+      {
+        EdgeCrossing crossing;
+        crossing.mTime = ComputeIntersectionPoint(start, edgeEnd, clipPoints[j], clipPoints[j + 1], crossing.mPolygonFlags, crossing.mClipFlags, crossing.mClipTime);
+        if(0 <= crossing.mTime && crossing.mTime <= 1)
+        {
+          crossing.mPolygonEdge = i;
+          crossing.mClipEdge = j;
+          crossings.push_back(crossing);
+        }
+      }
+      std::sort(crossings.begin() + edgeBegin, crossings.end(), [](const EdgeCrossing& lhs, const EdgeCrossing& rhs)
+      {
+        if(lhs.mTime != rhs.mTime)
+          return lhs.mTime < rhs.mTime;
+        return lhs.mClipEdge < rhs.mClipEdge;
+      });
+    }
+  });
+
+  size_t crossingCount = 0;
+  for(const Array<EdgeCrossing>& crossings : chunkCrossings)
+    crossingCount += crossings.size();
+  if(crossingCount == 0)
+  {
+    ClassifyVertices(polygonToClip);
+    ClassifyVertices(clipRegion);
+    return;
+  }
+
+  // Create the twin vertices and the polygon's new order. The pool isn't thread safe, so this part is serial.
+  Array<ClipVertex*> polygonOrder;
+  Array<ClipVertex*> clipTwins;
+  Array<size_t> clipEdgeCounts(clipCount + 1, 0);
+  polygonOrder.reserve(polygonCount + crossingCount);
+  clipTwins.reserve(crossingCount);
+  size_t nextPolygonVertex = 0;
+  for(const Array<EdgeCrossing>& crossings : chunkCrossings)
+  {
+    for(const EdgeCrossing& crossing : crossings)
+    {
+      while(nextPolygonVertex <= crossing.mPolygonEdge)
+        polygonOrder.push_back(polygonVertices[nextPolygonVertex++]);
+
+      ClipVertex* start = polygonVertices[crossing.mPolygonEdge];
+      ClipVertex* end = polygonVertices[(crossing.mPolygonEdge + 1) % polygonCount];
+      ClipVertex* clipStart = clipVertices[crossing.mClipEdge];
+      ClipVertex* clipNext = clipVertices[(crossing.mClipEdge + 1) % clipCount];
+      ClipVertex* clipVert = AllocateVertex(clipRegion.mPool);
+      clipVert->mPoint = start->mPoint + (end->mPoint - start->mPoint) * crossing.mTime;
+      clipVert->mClassification = crossing.mClipFlags;
+      clipVert->mSource = ComputeSource(clipStart, clipNext, crossing.mClipTime);
+      ClipVertex* edgeVert = AllocateVertex(clipRegion.mPool);
+      edgeVert->mPoint = clipVert->mPoint;
+      edgeVert->mClassification = crossing.mPolygonFlags;
+      edgeVert->mSource = ComputeSource(start, end, crossing.mTime);
+      clipVert->mTwin = edgeVert;
+      edgeVert->mTwin = clipVert;
+
+      polygonOrder.push_back(edgeVert);
+      clipTwins.push_back(clipVert);
+      ++clipEdgeCounts[crossing.mClipEdge + 1];
+    }
+  }
+  while(nextPolygonVertex < polygonCount)
+    polygonOrder.push_back(polygonVertices[nextPolygonVertex++]);
+
+  // Bucket the clip region's vertices by edge with a prefix sum, then order each edge's by time. Ties go to the
+  // lower polygon edge, which is the order they were created in.
+  for(size_t i = 0; i < clipCount; ++i)
+    clipEdgeCounts[i + 1] += clipEdgeCounts[i];
+  Array<size_t> clipBucketCursors(clipEdgeCounts.begin(), clipEdgeCounts.end() - 1);
+  Array<ClipVertex*> clipBuckets(crossingCount);
+  size_t twinIndex = 0;
+  Array<float> clipTimes(crossingCount);
+  for(const Array<EdgeCrossing>& crossings : chunkCrossings)
+  {
+    for(const EdgeCrossing& crossing : crossings)
+    {
+      size_t slot = clipBucketCursors[crossing.mClipEdge]++;
+      clipBuckets[slot] = clipTwins[twinIndex++];
+      clipTimes[slot] = crossing.mClipTime;
+    }
+  }
+
+  Array<ClipVertex*> clipOrder;
+  clipOrder.reserve(clipCount + crossingCount);
+  Array<size_t> bucket;
+  for(size_t j = 0; j < clipCount; ++j)
+  {
+    clipOrder.push_back(clipVertices[j]);
+    bucket.clear();
+    for(size_t slot = clipEdgeCounts[j]; slot < clipEdgeCounts[j + 1]; ++slot)
+      bucket.push_back(slot);
+    std::stable_sort(bucket.begin(), bucket.end(), [&clipTimes](size_t lhs, size_t rhs)
+    {
+      return clipTimes[lhs] < clipTimes[rhs];
+    });
+    for(size_t slot : bucket)
+      clipOrder.push_back(clipBuckets[slot]);
+  }
+
+  LinkLoop(polygonOrder);
+  LinkLoop(clipOrder);
+  ClassifyVerticesParallel(polygonOrder, threadCount);
+  ClassifyVerticesParallel(clipOrder, threadCount);
+}
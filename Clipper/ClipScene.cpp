@@ -0,0 +1,217 @@
+#include "ClipScene.hpp"
+
+#include "ClipParallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//-------------------------------------------------------------------ClipTransform
+Vec2 ClipTransform::Apply(const Vec2& point) const
+{
+  float c = std::cos(mRotation);
+  float s = std::sin(mRotation);
+  Vec2 scaled = point * mScale;
+  return Vec2(scaled.x * c - scaled.y * s, scaled.x * s + scaled.y * c) + mTranslation;
+}
+
+bool ClipTransform::operator==(const ClipTransform& rhs) const
+{
+  return mTranslation == rhs.mTranslation && mRotation == rhs.mRotation && mScale == rhs.mScale;
+}
+
+//-------------------------------------------------------------------ClipScene
+ClipScene::ObjectId ClipScene::AddObject(const PointContour& localPoints, const ClipTransform& transform)
+{
+  ObjectId objectId;
+  if(mFreeObjects.empty())
+  {
+    objectId = mObjects.size();
+    mObjects.push_back(Object());
+  }
+  else
+  {
+    objectId = mFreeObjects.back();
+    mFreeObjects.pop_back();
+    mObjects[objectId] = Object();
+  }
+
+  Object& object = mObjects[objectId];
+  object.mAlive = true;
+  object.mLocalPoints = localPoints;
+  object.mTransform = transform;
+  MarkDirty(objectId);
+  return objectId;
+}
+
+void ClipScene::RemoveObject(ObjectId objectId)
+{
+  Object& object = mObjects[objectId];
+  // Copy the partners as removing a pair modifies the list
+  Array<ObjectId> partners = object.mPartners;
+  for(ObjectId partner : partners)
+    RemovePair(objectId, partner);
+
+  if(object.mProxyId != AabbTree::NullNode)
+    mTree.DestroyProxy(object.mProxyId);
+  object = Object();
+  mFreeObjects.push_back(objectId);
+}
+
+void ClipScene::SetTransform(ObjectId objectId, const ClipTransform& transform)
+{
+  Object& object = mObjects[objectId];
+  if(object.mTransform == transform)
+    return;
+  object.mTransform = transform;
+  MarkDirty(objectId);
+}
+
+void ClipScene::SetGeometry(ObjectId objectId, const PointContour& localPoints)
+{
+  mObjects[objectId].mLocalPoints = localPoints;
+  MarkDirty(objectId);
+}
+
+const PointContour& ClipScene::GetWorldPoints(ObjectId objectId) const
+{
+  return mObjects[objectId].mWorldPoints;
+}
+
+void ClipScene::Update()
+{
+  mStats = ClipSceneStats();
+
+  // Bring every changed object up to date in the tree and flag all of its existing pairs
+  for(ObjectId objectId : mDirtyObjects)
+  {
+    Object& object = mObjects[objectId];
+    if(!object.mAlive)
+      continue;
+
+    object.mWorldPoints.resize(object.mLocalPoints.size());
+    for(size_t i = 0; i < object.mLocalPoints.size(); ++i)
+      object.mWorldPoints[i] = object.mTransform.Apply(object.mLocalPoints[i]);
+    object.mAabb = ComputeAabb(object.mWorldPoints);
+
+    if(object.mProxyId == AabbTree::NullNode)
+    {
+      object.mProxyId = mTree.CreateProxy(object.mAabb, objectId);
+      ++mStats.mTreeReinserts;
+    }
+    else if(mTree.MoveProxy(object.mProxyId, object.mAabb))
+      ++mStats.mTreeReinserts;
+    ++mStats.mObjectsUpdated;
+  }
+
+  // Pairs only change when one of their objects changed, so only the changed objects need to look for new or separated pairs.
+  for(ObjectId objectId : mDirtyObjects)
+  {
+    Object& object = mObjects[objectId];
+    if(!object.mAlive)
+      continue;
+    object.mDirty = false;
+
+    Array<ObjectId> partners = object.mPartners;
+    for(ObjectId partner : partners)
+    {
+      if(!object.mAabb.Overlaps(mObjects[partner].mAabb))
+        RemovePair(objectId, partner);
+      else
+      {
+        Pair& pair = mPairs[GetPairKey(objectId, partner)];
+        if(!pair.mDirty)
+        {
+          pair.mDirty = true;
+          mDirtyPairs.push_back(GetPairKey(objectId, partner));
+        }
+      }
+    }
+
+    mTree.Query(object.mAabb, [this, objectId, &object](size_t proxyId)
+    {
+      ObjectId partner = mTree.GetUserData(proxyId);
+      if(partner == objectId || !object.mAabb.Overlaps(mObjects[partner].mAabb))
+        return;
+      if(mPairs.find(GetPairKey(objectId, partner)) == mPairs.end())
+        AddPair(objectId, partner);
+    });
+  }
+  mDirtyObjects.clear();
+
+  // Re-clip only the dirty pairs, everything else keeps its cached result
+  Array<Pair*> dirtyPairs;
+  for(unsigned long long key : mDirtyPairs)
+  {
+    auto it = mPairs.find(key);
+    if(it != mPairs.end() && it->second.mDirty)
+      dirtyPairs.push_back(&it->second);
+  }
+  mDirtyPairs.clear();
+
+  ParallelFor(dirtyPairs.size(), mThreadCount, [this, &dirtyPairs](size_t i, size_t threadIndex)
+  {
+    Pair& pair = *dirtyPairs[i];
+    pair.mContours.clear();
+    Clipper clipper;
+    clipper.IntersectWithContainment(mObjects[pair.mObjectA].mWorldPoints, mObjects[pair.mObjectB].mWorldPoints, pair.mContours);
+    pair.mDirty = false;
+  });
+  mStats.mPairsRecomputed = dirtyPairs.size();
+  mStats.mPairsCached = mPairs.size() - dirtyPairs.size();
+}
+
+const PointContourList* ClipScene::FindIntersection(ObjectId objectA, ObjectId objectB) const
+{
+  auto it = mPairs.find(GetPairKey(objectA, objectB));
+  if(it == mPairs.end())
+    return nullptr;
+  return &it->second.mContours;
+}
+
+unsigned long long ClipScene::GetPairKey(ObjectId objectA, ObjectId objectB)
+{
+  unsigned long long low = std::min(objectA, objectB);
+  unsigned long long high = std::max(objectA, objectB);
+  return (high << 32) | low;
+}
+
+void ClipScene::MarkDirty(ObjectId objectId)
+{
+  Object& object = mObjects[objectId];
+  if(object.mDirty)
+    return;
+  object.mDirty = true;
+  mDirtyObjects.push_back(objectId);
+}
+
+void ClipScene::AddPair(ObjectId objectA, ObjectId objectB)
+{
+  // Keep the lower id first so the pair is the same regardless of which object found it
+  unsigned long long key = GetPairKey(objectA, objectB);
+  Pair& pair = mPairs[key];
+  pair.mObjectA = std::min(objectA, objectB);
+  pair.mObjectB = std::max(objectA, objectB);
+  pair.mDirty = true;
+  mDirtyPairs.push_back(key);
+
+  mObjects[objectA].mPartners.push_back(objectB);
+  mObjects[objectB].mPartners.push_back(objectA);
+  ++mStats.mPairsAdded;
+}
+
+void ClipScene::RemovePair(ObjectId objectA, ObjectId objectB)
+{
+  mPairs.erase(GetPairKey(objectA, objectB));
+
+  auto removePartner = [](Array<ObjectId>& partners, ObjectId partner)
+  {
+    auto it = std::find(partners.begin(), partners.end(), partner);
+    if(it == partners.end())
+      return;
+    *it = partners.back();
+    partners.pop_back();
+  };
+  removePartner(mObjects[objectA].mPartners, objectB);
+  removePartner(mObjects[objectB].mPartners, objectA);
+  ++mStats.mPairsRemoved;
+}
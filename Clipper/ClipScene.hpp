@@ -0,0 +1,99 @@
+#pragma once
+
+#include "AabbTree.hpp"
+#include <unordered_map>
+
+//-------------------------------------------------------------------ClipTransform
+struct ClipTransform
+{
+  Vec2 Apply(const Vec2& point) const;
+  bool operator==(const ClipTransform& rhs) const;
+  bool operator!=(const ClipTransform& rhs) const { return !((*this) == rhs); }
+
+  Vec2 mTranslation = Vec2(0, 0);
+  // Rotation in radians about the local origin, applied after the scale.
+  float mRotation = 0;
+  float mScale = 1;
+};
+
+//-------------------------------------------------------------------ClipSceneStats
+struct ClipSceneStats
+{
+  size_t mObjectsUpdated = 0;
+  size_t mTreeReinserts = 0;
+  size_t mPairsAdded = 0;
+  size_t mPairsRemoved = 0;
+  size_t mPairsRecomputed = 0;
+  size_t mPairsCached = 0;
+};
+
+//-------------------------------------------------------------------ClipScene
+// Keeps the intersections between every pair of overlapping polygons up to date as polygons move.
+// Polygons live in a dynamic aabb tree and the overlapping pairs are cached across updates. An update only
+// looks at objects whose geometry or transform changed since the last update: their pairs are found by querying
+// the tree and only those pairs are re-clipped, so the cost scales with the number of changes.
+struct ClipScene
+{
+  typedef size_t ObjectId;
+
+  ObjectId AddObject(const PointContour& localPoints, const ClipTransform& transform = ClipTransform());
+  void RemoveObject(ObjectId objectId);
+  void SetTransform(ObjectId objectId, const ClipTransform& transform);
+  void SetGeometry(ObjectId objectId, const PointContour& localPoints);
+  const PointContour& GetWorldPoints(ObjectId objectId) const;
+
+  // Processes all changes since the last update and recomputes the affected pairs.
+  void Update();
+
+  // Returns the cached intersection of the two objects, or null if their bounds don't overlap.
+  const PointContourList* FindIntersection(ObjectId objectA, ObjectId objectB) const;
+  // Calls the callback with (objectA, objectB, contours) for every overlapping pair with a non-empty intersection.
+  template <typename Callback>
+  void ForEachIntersection(Callback callback) const
+  {
+    for(auto& it : mPairs)
+    {
+      const Pair& pair = it.second;
+      if(!pair.mContours.empty())
+        callback(pair.mObjectA, pair.mObjectB, pair.mContours);
+    }
+  }
+
+  // Stats for the most recent update.
+  ClipSceneStats mStats;
+  // Number of threads used to re-clip dirty pairs. Zero uses the hardware concurrency.
+  size_t mThreadCount = 1;
+
+private:
+  struct Object
+  {
+    PointContour mLocalPoints;
+    PointContour mWorldPoints;
+    ClipTransform mTransform;
+    Aabb mAabb;
+    size_t mProxyId = AabbTree::NullNode;
+    Array<ObjectId> mPartners;
+    bool mAlive = false;
+    bool mDirty = false;
+  };
+
+  struct Pair
+  {
+    ObjectId mObjectA = 0;
+    ObjectId mObjectB = 0;
+    PointContourList mContours;
+    bool mDirty = true;
+  };
+
+  static unsigned long long GetPairKey(ObjectId objectA, ObjectId objectB);
+  void MarkDirty(ObjectId objectId);
+  void AddPair(ObjectId objectA, ObjectId objectB);
+  void RemovePair(ObjectId objectA, ObjectId objectB);
+
+  AabbTree mTree;
+  Array<Object> mObjects;
+  Array<ObjectId> mFreeObjects;
+  Array<ObjectId> mDirtyObjects;
+  std::unordered_map<unsigned long long, Pair> mPairs;
+  Array<unsigned long long> mDirtyPairs;
+};
@@ -0,0 +1,430 @@
+#include "ClipShape.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static const float Pi = 3.14159265358979f;
+static const float TwoPi = 2.0f * Pi;
+
+static Vec2 GetDirection(float angle)
+{
+  return Vec2(std::cos(angle), std::sin(angle));
+}
+
+static float GetAngle(const Vec2& direction)
+{
+  return std::atan2(direction.y, direction.x);
+}
+
+// Returns the angle wrapped into [0, 2pi).
+static float WrapAngle(float angle)
+{
+  angle = std::fmod(angle, TwoPi);
+  if(angle < 0)
+    angle += TwoPi;
+  return angle;
+}
+
+static ClipShapeSegment MakeLine(const Vec2& start, const Vec2& end)
+{
+  ClipShapeSegment segment;
+  segment.mType = ClipShapeSegmentType::Line;
+  segment.mStart = start;
+  segment.mEnd = end;
+  return segment;
+}
+
+static ClipShapeSegment MakeArc(const Vec2& center, float radius, float startAngle, float sweep)
+{
+  ClipShapeSegment segment;
+  segment.mType = ClipShapeSegmentType::Arc;
+  segment.mCenter = center;
+  segment.mRadius = radius;
+  segment.mStartAngle = startAngle;
+  segment.mSweep = sweep;
+  segment.mStart = segment.GetPoint(0);
+  segment.mEnd = segment.GetPoint(1);
+  return segment;
+}
+
+// Appends the points of the segment strictly between the two local parameters.
+static void AppendSegmentInterior(const ClipShapeSegment& segment, float startT, float endT, const ClipShapeOptions& options, PointContour& results)
+{
+  if(segment.mType == ClipShapeSegmentType::Line)
+    return;
+
+  // Choose the angle step so the chord never deviates from the arc by more than the tolerance
+  float tolerance = options.GetArcTolerance(segment.mRadius);
+  float maxStep = Pi * 0.5f;
+  if(tolerance < segment.mRadius)
+    maxStep = std::min(maxStep, 2.0f * std::acos(1.0f - tolerance / segment.mRadius));
+
+  float angle = std::abs(endT - startT) * segment.mSweep;
+  size_t steps = static_cast<size_t>(std::ceil(angle / maxStep));
+  for(size_t i = 1; i < steps; ++i)
+  {
+    float t = startT + (endT - startT) * (static_cast<float>(i) / steps);
+    results.push_back(segment.GetPoint(t));
+  }
+}
+
+// Walks the given parameter distance from the start along the boundary, appending every point passed (exclusive of both ends).
+static void AppendBoundaryDistance(const ClipShape& shape, float startParam, float distance, int direction, const ClipShapeOptions& options, PointContour& results)
+{
+  int segmentCount = static_cast<int>(shape.mSegments.size());
+  auto getSegment = [&shape, segmentCount](int index) -> const ClipShapeSegment&
+  {
+    return shape.mSegments[((index % segmentCount) + segmentCount) % segmentCount];
+  };
+
+  float position = startParam;
+  if(direction > 0)
+  {
+    float end = startParam + distance;
+    while(position < end)
+    {
+      int index = static_cast<int>(std::floor(position));
+      float segmentEnd = static_cast<float>(index + 1);
+      float stop = std::min(segmentEnd, end);
+      const ClipShapeSegment& segment = getSegment(index);
+      AppendSegmentInterior(segment, position - index, stop - index, options, results);
+      if(stop < end)
+        results.push_back(segment.mEnd);
+      position = stop;
+    }
+  }
+  else
+  {
+    float end = startParam - distance;
+    while(position > end)
+    {
+      int index = static_cast<int>(std::ceil(position)) - 1;
+      float segmentStart = static_cast<float>(index);
+      float stop = std::max(segmentStart, end);
+      const ClipShapeSegment& segment = getSegment(index);
+      AppendSegmentInterior(segment, position - index, stop - index, options, results);
+      if(stop > end)
+        results.push_back(segment.mStart);
+      position = stop;
+    }
+  }
+}
+
+//-------------------------------------------------------------------ClipShapeSegment
+Vec2 ClipShapeSegment::GetPoint(float t) const
+{
+  if(mType == ClipShapeSegmentType::Line)
+    return mStart + (mEnd - mStart) * t;
+  return mCenter + GetDirection(mStartAngle + mSweep * t) * mRadius;
+}
+
+//-------------------------------------------------------------------ClipShapeOptions
+float ClipShapeOptions::GetArcTolerance(float radius) const
+{
+  if(mArcTolerance > 0)
+    return mArcTolerance;
+  if(mOutputScale > 0)
+    return mOutputScale * 0.25f;
+  return radius * 0.001f;
+}
+
+//-------------------------------------------------------------------ClipShape
+ClipShape ClipShape::Circle(const Vec2& center, float radius)
+{
+  ClipShape shape;
+  shape.mType = ClipShapeType::Circle;
+  shape.mCenter = center;
+  shape.mRadius = radius;
+  shape.mSegments.push_back(MakeArc(center, radius, 0, TwoPi));
+  return shape;
+}
+
+ClipShape ClipShape::Capsule(const Vec2& start, const Vec2& end, float radius)
+{
+  Vec2 axis = end - start;
+  float length = std::sqrt(Vec2::Dot(axis, axis));
+  if(length == 0)
+    return Circle(start, radius);
+
+  ClipShape shape;
+  shape.mType = ClipShapeType::Capsule;
+  shape.mCenter = start;
+  shape.mEnd = end;
+  shape.mRadius = radius;
+
+  // Walk counter-clockwise: along the right side, around the end cap, back along the left side and around the start cap
+  Vec2 normal = Vec2(-axis.y, axis.x) * (radius / length);
+  float normalAngle = GetAngle(normal);
+  shape.mSegments.push_back(MakeLine(start - normal, end - normal));
+  shape.mSegments.push_back(MakeArc(end, radius, normalAngle - Pi, Pi));
+  shape.mSegments.push_back(MakeLine(end + normal, start + normal));
+  shape.mSegments.push_back(MakeArc(start, radius, normalAngle, Pi));
+  return shape;
+}
+
+ClipShape ClipShape::Sector(const Vec2& center, float radius, float startAngle, float sweep)
+{
+  if(sweep >= TwoPi)
+    return Circle(center, radius);
+
+  ClipShape shape;
+  shape.mType = ClipShapeType::Sector;
+  shape.mCenter = center;
+  shape.mRadius = radius;
+  shape.mStartAngle = startAngle;
+  shape.mSweep = sweep;
+  ClipShapeSegment arc = MakeArc(center, radius, startAngle, sweep);
+  shape.mSegments.push_back(MakeLine(center, arc.mStart));
+  shape.mSegments.push_back(arc);
+  shape.mSegments.push_back(MakeLine(arc.mEnd, center));
+  return shape;
+}
+
+bool ClipShape::ContainsPoint(const Vec2& point) const
+{
+  float radiusSq = mRadius * mRadius;
+  if(mType == ClipShapeType::Circle)
+    return Vec2::DistanceSq(point, mCenter) < radiusSq;
+
+  if(mType == ClipShapeType::Capsule)
+  {
+    Vec2 axis = mEnd - mCenter;
+    float t = Vec2::Dot(point - mCenter, axis) / Vec2::Dot(axis, axis);
+    t = std::max(0.0f, std::min(1.0f, t));
+    return Vec2::DistanceSq(point, mCenter + axis * t) < radiusSq;
+  }
+
+  if(Vec2::DistanceSq(point, mCenter) >= radiusSq)
+    return false;
+  float offset = WrapAngle(GetAngle(point - mCenter) - mStartAngle);
+  return 0 < offset && offset < mSweep;
+}
+
+Vec2 ClipShape::GetInteriorPoint() const
+{
+  if(mType == ClipShapeType::Sector)
+    return mCenter + GetDirection(mStartAngle + mSweep * 0.5f) * (mRadius * 0.5f);
+  return mCenter;
+}
+
+Aabb ClipShape::GetAabb() const
+{
+  Vec2 radius(mRadius, mRadius);
+  Aabb result(mCenter - radius, mCenter + radius);
+  if(mType == ClipShapeType::Capsule)
+    result.Expand(Aabb(mEnd - radius, mEnd + radius));
+  return result;
+}
+
+void ClipShape::AppendBoundary(float startParam, float endParam, int direction, const ClipShapeOptions& options, PointContour& results) const
+{
+  float segmentCount = static_cast<float>(mSegments.size());
+  float distance = std::fmod((endParam - startParam) * direction, segmentCount);
+  if(distance < 0)
+    distance += segmentCount;
+  AppendBoundaryDistance(*this, startParam, distance, direction, options, results);
+}
+
+void ClipShape::Tessellate(const ClipShapeOptions& options, bool clockwise, PointContour& results) const
+{
+  results.push_back(mSegments[0].mStart);
+  AppendBoundaryDistance(*this, 0, static_cast<float>(mSegments.size()), 1, options, results);
+  if(clockwise)
+    std::reverse(results.begin(), results.end());
+}
+
+//-------------------------------------------------------------------Clipper
+struct ClipShapeCrossing
+{
+  Vec2 mPoint;
+  // Edge index plus the t-value along the edge.
+  float mPolygonParam;
+  // Segment index plus the t-value along the segment.
+  float mShapeParam;
+  // Is the polygon entering the shape at this point?
+  bool mEntering;
+};
+
+static void FindShapeCrossings(const PointContour& polygonPoints, const ClipShape& clipShape, Array<ClipShapeCrossing>& crossings)
+{
+  Aabb shapeAabb = clipShape.GetAabb();
+  size_t count = polygonPoints.size();
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& start = polygonPoints[i];
+    const Vec2& end = polygonPoints[(i + 1) % count];
+    if(!Aabb::FromSegment(start, end).Overlaps(shapeAabb))
+      continue;
+
+    Vec2 dir = end - start;
+    // Parameters are half-open ([0, 1)) so a crossing exactly on a shared endpoint is only found once
+    auto addCrossing = [&](float t, size_t segmentIndex, float segmentT, bool entering)
+    {
+      if(t < 0 || t >= 1 || segmentT < 0 || segmentT >= 1)
+        return;
+      ClipShapeCrossing crossing;
+      crossing.mPoint = start + dir * t;
+      crossing.mPolygonParam = i + t;
+      crossing.mShapeParam = segmentIndex + segmentT;
+      crossing.mEntering = entering;
+      crossings.push_back(crossing);
+    };
+
+    for(size_t segmentIndex = 0; segmentIndex < clipShape.mSegments.size(); ++segmentIndex)
+    {
+      const ClipShapeSegment& segment = clipShape.mSegments[segmentIndex];
+      if(segment.mType == ClipShapeSegmentType::Line)
+      {
+        if(ComputeEdgeContact(start, end, segment.mStart, segment.mEnd) != EdgeContact::Cross)
+          continue;
+        Vec2 segmentDir = segment.mEnd - segment.mStart;
+        float denominator = Cross2d(dir, segmentDir);
+        float t = Cross2d(segment.mStart - start, segmentDir) / denominator;
+        float segmentT = Cross2d(segment.mStart - start, dir) / denominator;
+        // The shape winds counter-clockwise so its outward normal is on the right of each segment
+        Vec2 outward(segmentDir.y, -segmentDir.x);
+        addCrossing(t, segmentIndex, segmentT, Vec2::Dot(dir, outward) < 0);
+        continue;
+      }
+
+      // Solve |start + dir * t - center| = radius. Tangent hits don't cross so they're ignored.
+      Vec2 offset = start - segment.mCenter;
+      float a = Vec2::Dot(dir, dir);
+      float b = 2.0f * Vec2::Dot(dir, offset);
+      float c = Vec2::Dot(offset, offset) - segment.mRadius * segment.mRadius;
+      float discriminant = b * b - 4.0f * a * c;
+      if(discriminant <= 0 || a == 0)
+        continue;
+
+      float root = std::sqrt(discriminant);
+      float roots[2] = {(-b - root) / (2.0f * a), (-b + root) / (2.0f * a)};
+      for(float t : roots)
+      {
+        Vec2 point = start + dir * t;
+        float angleOffset = WrapAngle(GetAngle(point - segment.mCenter) - segment.mStartAngle);
+        addCrossing(t, segmentIndex, angleOffset / segment.mSweep, Vec2::Dot(dir, point - segment.mCenter) < 0);
+      }
+    }
+  }
+}
+
+// Shared implementation of the shape boolean operations. This is the same contour tracing as the vertex list version
+// (walk the polygon until a crossing, then hop onto the clip region) but the crossings are kept in two sorted arrays
+// as the shape's boundary is never turned into vertices.
+static void ClipAgainstShape(const PointContour& polygonPoints, const ClipShape& clipShape, const ClipShapeOptions& options, bool subtract, PointContourList& contours)
+{
+  contours.clear();
+  if(polygonPoints.size() < 3 || clipShape.mSegments.empty())
+    return;
+
+  bool polygonCcw = ComputeSignedArea(polygonPoints) > 0;
+  Array<ClipShapeCrossing> crossings;
+  FindShapeCrossings(polygonPoints, clipShape, crossings);
+
+  // Without any crossings one is either inside the other or they're disjoint
+  if(crossings.empty())
+  {
+    bool polygonInside = clipShape.ContainsPoint(polygonPoints[0]);
+    bool shapeInside = !polygonInside && ContainsPoint(polygonPoints, clipShape.GetInteriorPoint());
+    if(subtract)
+    {
+      if(polygonInside)
+        return;
+      contours.push_back(polygonPoints);
+      // The hole winds opposite to the polygon
+      if(shapeInside)
+      {
+        contours.push_back(PointContour());
+        clipShape.Tessellate(options, polygonCcw, contours.back());
+      }
+    }
+    else
+    {
+      if(polygonInside)
+        contours.push_back(polygonPoints);
+      else if(shapeInside)
+      {
+        contours.push_back(PointContour());
+        clipShape.Tessellate(options, !polygonCcw, contours.back());
+      }
+    }
+    return;
+  }
+
+  size_t crossingCount = crossings.size();
+  Array<size_t> polygonOrder(crossingCount);
+  Array<size_t> shapeOrder(crossingCount);
+  for(size_t i = 0; i < crossingCount; ++i)
+    polygonOrder[i] = shapeOrder[i] = i;
+  std::sort(polygonOrder.begin(), polygonOrder.end(), [&crossings](size_t lhs, size_t rhs)
+  {
+    return crossings[lhs].mPolygonParam < crossings[rhs].mPolygonParam;
+  });
+  std::sort(shapeOrder.begin(), shapeOrder.end(), [&crossings](size_t lhs, size_t rhs)
+  {
+    return crossings[lhs].mShapeParam < crossings[rhs].mShapeParam;
+  });
+  Array<size_t> polygonRank(crossingCount);
+  Array<size_t> shapeRank(crossingCount);
+  for(size_t i = 0; i < crossingCount; ++i)
+  {
+    polygonRank[polygonOrder[i]] = i;
+    shapeRank[shapeOrder[i]] = i;
+  }
+
+  // Intersections walk the shape the same way as the polygon winds, subtractions walk it backwards
+  int direction = polygonCcw ? 1 : -1;
+  if(subtract)
+    direction = -direction;
+  // Intersections start where the polygon enters the shape, subtractions where it leaves
+  bool startEntering = !subtract;
+
+  size_t vertexCount = polygonPoints.size();
+  Array<bool> visited(crossingCount, false);
+  for(size_t start : polygonOrder)
+  {
+    if(visited[start] || crossings[start].mEntering != startEntering)
+      continue;
+
+    contours.push_back(PointContour());
+    PointContour& contour = contours.back();
+    size_t current = start;
+    while(!visited[current])
+    {
+      // Walk the polygon to the next crossing
+      const ClipShapeCrossing& from = crossings[current];
+      size_t next = polygonOrder[(polygonRank[current] + 1) % crossingCount];
+      const ClipShapeCrossing& to = crossings[next];
+      visited[current] = visited[next] = true;
+      contour.push_back(from.mPoint);
+
+      size_t fromEdge = static_cast<size_t>(from.mPolygonParam);
+      size_t toEdge = static_cast<size_t>(to.mPolygonParam);
+      size_t verticesToAdd = (toEdge + vertexCount - fromEdge) % vertexCount;
+      if(verticesToAdd == 0 && to.mPolygonParam <= from.mPolygonParam)
+        verticesToAdd = vertexCount;
+      for(size_t i = 1; i <= verticesToAdd; ++i)
+        contour.push_back(polygonPoints[(fromEdge + i) % vertexCount]);
+      contour.push_back(to.mPoint);
+
+      // Then hop onto the shape's boundary until the next crossing
+      size_t after = shapeOrder[(shapeRank[next] + crossingCount + direction) % crossingCount];
+      clipShape.AppendBoundary(to.mShapeParam, crossings[after].mShapeParam, direction, options, contour);
+      current = after;
+    }
+  }
+}
+
+void Clipper::Subtract(const PointContour& polygonPoints, const ClipShape& clipShape, const ClipShapeOptions& options, PointContourList& contours)
+{
+  // The shape's boundary has no input edges, so no provenance is recorded.
+  ClearOutput(contours);
+  ClipAgainstShape(polygonPoints, clipShape, options, true, contours);
+}
+
+void Clipper::Intersect(const PointContour& polygonPoints, const ClipShape& clipShape, const ClipShapeOptions& options, PointContourList& contours)
+{
+  // The shape's boundary has no input edges, so no provenance is recorded.
+  ClearOutput(contours);
+  ClipAgainstShape(polygonPoints, clipShape, options, false, contours);
+}
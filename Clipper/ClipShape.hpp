@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+enum class ClipShapeType
+{
+  Circle,
+  Capsule,
+  Sector
+};
+
+enum class ClipShapeSegmentType
+{
+  Line,
+  Arc
+};
+
+//-------------------------------------------------------------------ClipShapeSegment
+struct ClipShapeSegment
+{
+  Vec2 GetPoint(float t) const;
+
+  ClipShapeSegmentType mType = ClipShapeSegmentType::Line;
+  Vec2 mStart;
+  Vec2 mEnd;
+  // Arcs only. The sweep is always positive (counter-clockwise).
+  Vec2 mCenter;
+  float mRadius = 0;
+  float mStartAngle = 0;
+  float mSweep = 0;
+};
+
+//-------------------------------------------------------------------ClipShapeOptions
+struct ClipShapeOptions
+{
+  // Returns the max distance a tessellated arc is allowed to deviate from the true arc.
+  float GetArcTolerance(float radius) const;
+
+  // Explicit arc tolerance. Zero chooses one from the output scale.
+  float mArcTolerance = 0;
+  // Size of one output unit (e.g. a pixel) in world units. Arcs are emitted to a quarter of this.
+  // If neither value is set the tolerance is a small fraction of the radius.
+  float mOutputScale = 0;
+};
+
+//-------------------------------------------------------------------ClipShape
+// An analytic clip region whose boundary is made of lines and circular arcs, wound counter-clockwise.
+// Polygon edges are intersected with the exact boundary and arc points are only emitted for the parts of the
+// boundary that end up in the output, at a tolerance chosen from the output scale, instead of tessellating the
+// whole shape up front.
+struct ClipShape
+{
+  static ClipShape Circle(const Vec2& center, float radius);
+  // The shape swept by a circle moving from start to end.
+  static ClipShape Capsule(const Vec2& start, const Vec2& end, float radius);
+  // A pie slice of a circle, starting at the given angle and sweeping counter-clockwise.
+  static ClipShape Sector(const Vec2& center, float radius, float startAngle, float sweep);
+
+  bool ContainsPoint(const Vec2& point) const;
+  Vec2 GetInteriorPoint() const;
+  Aabb GetAabb() const;
+  // Appends the boundary points between the two boundary parameters, exclusive of both ends. The parameter is the
+  // segment index plus the fraction along that segment. A direction of 1 walks counter-clockwise, -1 clockwise.
+  void AppendBoundary(float startParam, float endParam, int direction, const ClipShapeOptions& options, PointContour& results) const;
+  // Tessellates the whole shape, wound counter-clockwise unless told otherwise.
+  void Tessellate(const ClipShapeOptions& options, bool clockwise, PointContour& results) const;
+
+  ClipShapeType mType = ClipShapeType::Circle;
+  Vec2 mCenter;
+  // Capsules only, the center is the start of the capsule.
+  Vec2 mEnd;
+  float mRadius = 0;
+  // Sectors only.
+  float mStartAngle = 0;
+  float mSweep = 0;
+  Array<ClipShapeSegment> mSegments;
+};
@@ -1,6 +1,12 @@
 #include "Clipper.hpp"
 
+#include "ClipCostModel.hpp"
+#include "ContourSimplifier.hpp"
+#include "ConvexClipper.hpp"
+#include "ScanlineClipper.hpp"
+
 #include <algorithm>
+#include <cmath>
 
 float Cross2d(const Vec2& lhs, const Vec2& rhs)
 {
@@ -14,9 +20,21 @@ float SignedArea(const Vec2& a, const Vec2& b, const Vec2& c)
   return Cross2d(ac, bc);
 }
 
+bool IsCollinear(const Vec2& prev, const Vec2& point, const Vec2& next, float tolerance)
+{
+  return std::abs(SignedArea(prev, point, next)) <= tolerance * Vec2::DistanceSq(prev, next);
+}
+
 float ComputeIntersectionPoint(const Vec2& start0, const Vec2& end0, const Vec2& start1, const Vec2& end1, ClipVertexClassification& line0Flags, ClipVertexClassification& line1Flags)
+{
+  float line1Time;
+  return ComputeIntersectionPoint(start0, end0, start1, end1, line0Flags, line1Flags, line1Time);
+}
+
+float ComputeIntersectionPoint(const Vec2& start0, const Vec2& end0, const Vec2& start1, const Vec2& end1, ClipVertexClassification& line0Flags, ClipVertexClassification& line1Flags, float& line1Time)
 {
   line1Flags = line0Flags = ClipVertexClassification::None;
+  line1Time = -1;
   float a1 = SignedArea(start0, end0, end1);
   float a2 = SignedArea(start0, end0, start1);
   float a3 = SignedArea(start1, end1, start0);
@@ -27,6 +45,8 @@ float ComputeIntersectionPoint(const Vec2& start0, const Vec2& end0, const Vec2&
   {
     line0Flags = a3 < 0 ? ClipVertexClassification::InToOut : ClipVertexClassification::OutToIn;
     line1Flags = a2 < 0 ? ClipVertexClassification::InToOut : ClipVertexClassification::OutToIn;
+    // a2 and a1 are the (scaled) distances of the second line's endpoints from the first line.
+    line1Time = a2 / (a2 - a1);
     return a3 / (a3 - a4);
   }
   return -1;
@@ -39,7 +59,255 @@ ClipVertexSearchDirection FlipSearchDirection(ClipVertexSearchDirection directio
   return ClipVertexSearchDirection::Forwards;
 }
 
+static bool IsWithinSegmentBounds(const Vec2& start, const Vec2& end, const Vec2& point)
+{
+  return Aabb::FromSegment(start, end).Contains(point);
+}
+
+EdgeContact ComputeEdgeContact(const Vec2& start0, const Vec2& end0, const Vec2& start1, const Vec2& end1)
+{
+  float d1 = SignedArea(start0, end0, start1);
+  float d2 = SignedArea(start0, end0, end1);
+  float d3 = SignedArea(start1, end1, start0);
+  float d4 = SignedArea(start1, end1, end0);
+  if(d1 * d2 < 0 && d3 * d4 < 0)
+    return EdgeContact::Cross;
+
+  // A zero area means the point is collinear with the other line, it only touches if it's also within that segment.
+  if(d1 == 0 && IsWithinSegmentBounds(start0, end0, start1))
+    return EdgeContact::Touch;
+  if(d2 == 0 && IsWithinSegmentBounds(start0, end0, end1))
+    return EdgeContact::Touch;
+  if(d3 == 0 && IsWithinSegmentBounds(start1, end1, start0))
+    return EdgeContact::Touch;
+  if(d4 == 0 && IsWithinSegmentBounds(start1, end1, end0))
+    return EdgeContact::Touch;
+  return EdgeContact::None;
+}
+
+Aabb ComputeAabb(const PointContour& points)
+{
+  Aabb result;
+  for(const Vec2& point : points)
+    result.Expand(point);
+  return result;
+}
+
+float ComputeSignedArea(const PointContour& points)
+{
+  return ComputeSignedArea(points.data(), points.size());
+}
+
+float ComputeSignedArea(const Vec2* points, size_t count)
+{
+  float area = 0;
+  for(size_t i = 0; i < count; ++i)
+    area += Cross2d(points[i], points[(i + 1) % count]);
+  return area * 0.5f;
+}
+
+bool ContainsPoint(const PointContour& polygon, const Vec2& point)
+{
+  return ContainsPoint(polygon.data(), polygon.size(), point);
+}
+
+bool ContainsPoint(const Vec2* polygon, size_t count, const Vec2& point)
+{
+  bool inside = false;
+  for(size_t i = 0, j = count - 1; i < count; j = i++)
+  {
+    const Vec2& a = polygon[i];
+    const Vec2& b = polygon[j];
+    if((a.y > point.y) != (b.y > point.y))
+    {
+      float x = a.x + (point.y - a.y) * (b.x - a.x) / (b.y - a.y);
+      if(point.x < x)
+        inside = !inside;
+    }
+  }
+  return inside;
+}
+
+bool IsConvex(const PointContour& points)
+{
+  size_t count = points.size();
+  if(count < 3)
+    return false;
+
+  // Consistent turns alone still allow star shapes that wind several times. A polygon that only winds once
+  // reverses its x direction exactly twice.
+  float turnSign = 0;
+  float xSign = 0;
+  size_t xFlips = 0;
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& a = points[i];
+    const Vec2& b = points[(i + 1) % count];
+    const Vec2& c = points[(i + 2) % count];
+    float turn = Cross2d(b - a, c - b);
+    if(turn != 0)
+    {
+      if(turnSign * turn < 0)
+        return false;
+      turnSign = turn;
+    }
+
+    float dx = b.x - a.x;
+    if(dx != 0)
+    {
+      if(xSign * dx < 0)
+        ++xFlips;
+      xSign = dx;
+    }
+  }
+  // The loop above never compares the last x direction with the first one.
+  for(size_t i = 0; i < count; ++i)
+  {
+    float dx = points[(i + 1) % count].x - points[i].x;
+    if(dx != 0)
+    {
+      if(xSign * dx < 0)
+        ++xFlips;
+      break;
+    }
+  }
+  return turnSign != 0 && xFlips <= 2;
+}
+
+bool IsAxisAlignedRectangle(const PointContour& points)
+{
+  if(points.size() != 4)
+    return false;
+
+  const Vec2& p0 = points[0];
+  const Vec2& p1 = points[1];
+  const Vec2& p2 = points[2];
+  const Vec2& p3 = points[3];
+  bool horizontalFirst = p0.y == p1.y && p1.x == p2.x && p2.y == p3.y && p3.x == p0.x;
+  bool verticalFirst = p0.x == p1.x && p1.y == p2.y && p2.x == p3.x && p3.y == p0.y;
+  return (horizontalFirst || verticalFirst) && ComputeSignedArea(points) != 0;
+}
+
+static bool IsOnBoundary(const Vec2* polygon, size_t count, const Vec2& point)
+{
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& start = polygon[i];
+    const Vec2& end = polygon[(i + 1) % count];
+    // Use a tolerance relative to the edge length so edge midpoints of collinear edges still count.
+    float area = SignedArea(start, end, point);
+    if(std::abs(area) <= 1e-5f * Vec2::DistanceSq(start, end) && IsWithinSegmentBounds(start, end, point))
+      return true;
+  }
+  return false;
+}
+
+static bool IsOnBoundary(const PointContour& polygon, const Vec2& point)
+{
+  return IsOnBoundary(polygon.data(), polygon.size(), point);
+}
+
+bool ContainsUncrossed(const Vec2* polygon, size_t polygonCount, const Vec2* region, size_t regionCount)
+{
+  for(size_t i = 0; i < regionCount; ++i)
+  {
+    const Vec2& start = region[i];
+    Vec2 midPoint = (start + region[(i + 1) % regionCount]) * 0.5f;
+    if(!IsOnBoundary(polygon, polygonCount, start))
+      return ContainsPoint(polygon, polygonCount, start);
+    if(!IsOnBoundary(polygon, polygonCount, midPoint))
+      return ContainsPoint(polygon, polygonCount, midPoint);
+  }
+  // The region runs along the polygon's boundary the whole way round.
+  return true;
+}
+
+// Visits every vertex and edge midpoint of the sample polygon that isn't on the region's boundary.
+// These points are guaranteed to be strictly inside or outside the region once the boundaries are known to not cross.
+template <typename Callback>
+static bool AnySampleOffBoundary(const PointContour& samples, const PointContour& region, Callback callback)
+{
+  size_t count = samples.size();
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& start = samples[i];
+    const Vec2& end = samples[(i + 1) % count];
+    Vec2 midPoint = (start + end) * 0.5f;
+    if(!IsOnBoundary(region, start) && callback(start))
+      return true;
+    if(!IsOnBoundary(region, midPoint) && callback(midPoint))
+      return true;
+  }
+  return false;
+}
+
+// Nudges each edge midpoint of the polygon just into its interior and checks whether it lands inside the region.
+// Once every sample is on the other boundary the edges coincide, as with identical polygons, and only the side
+// each interior is on tells overlapping apart from touching.
+static bool InteriorsMeetAlongBoundary(const PointContour& polygon, const PointContour& region)
+{
+  // Counter-clockwise polygons have their interior to the left of each edge.
+  float side = ComputeSignedArea(polygon) > 0 ? 1.0f : -1.0f;
+  size_t count = polygon.size();
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& start = polygon[i];
+    const Vec2& end = polygon[(i + 1) % count];
+    Vec2 edge = end - start;
+    Vec2 inward = Vec2(-edge.y, edge.x) * (side * 1e-3f);
+    Vec2 point = (start + end) * 0.5f + inward;
+    // Thin features can push the point out the other side, and those edges can't tell anything.
+    if(!ContainsPoint(polygon, point) || IsOnBoundary(region, point))
+      continue;
+    if(ContainsPoint(region, point))
+      return true;
+  }
+  return false;
+}
+
 //-------------------------------------------------------------------ClipVertex
+// The time along the given input edge of a vertex on it. Original vertices either start the edge or end it.
+static float GetTimeOnEdge(const ClipVertex* vertex, size_t edgeIndex)
+{
+  if(vertex->mTwin != nullptr)
+    return vertex->mSource.mTime;
+  return vertex->mSource.mEdgeIndex == edgeIndex ? 0.0f : 1.0f;
+}
+
+ClipVertexSource ComputeSource(const ClipVertex* start, const ClipVertex* end, float time)
+{
+  size_t startIndex = start->mSource.mEdgeIndex;
+  size_t endIndex = end->mSource.mEdgeIndex;
+  size_t edgeIndex = startIndex;
+  if(start->mTwin == nullptr)
+  {
+    if(end->mTwin != nullptr)
+      edgeIndex = endIndex;
+    // Two original vertices. With at least three points the edge runs forwards exactly when the end is the next
+    // point, which may wrap around to zero.
+    else if(!(endIndex == startIndex + 1 || (endIndex == 0 && startIndex > 1)))
+      edgeIndex = endIndex;
+  }
+
+  float startTime = GetTimeOnEdge(start, edgeIndex);
+  float endTime = GetTimeOnEdge(end, edgeIndex);
+  ClipVertexSource result;
+  result.mOperand = start->mSource.mOperand;
+  result.mEdgeIndex = edgeIndex;
+  result.mTime = startTime + (endTime - startTime) * time;
+  return result;
+}
+
+// Copies the points of a vertex list in its order.
+static void CopyPoints(const ClipVertexList& list, PointContour& points)
+{
+  ClipVertex::Traverse(list.mHead, [&points](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    points.push_back(vertex->mPoint);
+    return true;
+  });
+}
+
 ClipVertex* ClipVertex::FindFirstOf(ClipVertex* vertexList, ClipVertexClassification classification)
 {
   ClipVertex* result = nullptr;
@@ -71,6 +339,28 @@ ClipVertex* ClipVertex::FindFirstIntersection(ClipVertex* vertexList)
   return result;
 }
 
+ClipVertex* ClipVertex::FindUnionStart(ClipVertex* vertexList)
+{
+  ClipVertex* firstIntersection = FindFirstIntersection(vertexList);
+  if(firstIntersection == nullptr)
+    return nullptr;
+
+  ClipVertex* leftmost = firstIntersection;
+  auto findLeftmost = [&leftmost](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    const Vec2& point = vertex->mPoint;
+    if(point.x < leftmost->mPoint.x || (point.x == leftmost->mPoint.x && point.y < leftmost->mPoint.y))
+      leftmost = vertex;
+    return true;
+  };
+  Traverse(vertexList, findLeftmost);
+  Traverse(firstIntersection->mTwin, findLeftmost);
+  // From a crossing the union continues along whichever list is leaving the other polygon.
+  if(leftmost->mClassification == ClipVertexClassification::OutToIn)
+    leftmost = leftmost->mTwin;
+  return leftmost;
+}
+
 ClipVertex* ClipVertex::GetNext(ClipVertexSearchDirection direction)
 {
   if(direction == ClipVertexSearchDirection::Forwards)
@@ -78,40 +368,321 @@ ClipVertex* ClipVertex::GetNext(ClipVertexSearchDirection direction)
   return mPrev;
 }
 
+ClipVertex* ClipVertex::GetNextOnUnion()
+{
+  ClipVertex* next = mNext;
+  if(next->mTwin == nullptr)
+    return next;
+  next->mVisited = true;
+  return next->mTwin;
+}
+
+// Traces the union loop through the start. Every vertex of a loop is visited once, so the loop is closed at the
+// first visited vertex, which also stops a degenerate walk that never makes it back to the start.
+static void TraceUnionContour(ClipVertex* start, ClipContourSink& sink)
+{
+  ClipVertex* vertex = start;
+  sink.BeginContour();
+  do
+  {
+    sink.AddVertex(*vertex);
+    vertex->mVisited = true;
+    vertex = vertex->GetNextOnUnion();
+  } while(!vertex->mVisited);
+  sink.EndContour();
+}
+
+void TraceUnion(ClipVertex* polygon, ClipContourSink& sink)
+{
+  ClipVertex* start = ClipVertex::FindUnionStart(polygon);
+  if(start == nullptr)
+    return;
+  TraceUnionContour(start, sink);
+
+  // Every other loop is a hole. Each one follows the polygon out of the clip region somewhere.
+  ClipVertex::Traverse(polygon, [&sink](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    if(vertex->mClassification == ClipVertexClassification::InToOut && !vertex->mVisited)
+      TraceUnionContour(vertex, sink);
+    return true;
+  });
+}
+
+//-------------------------------------------------------------------ClipVertexPool
+ClipVertex* ClipVertexPool::Allocate()
+{
+  if(mFree.empty())
+    Reserve(std::max(mCapacity * 2, size_t(64)));
+  ClipVertex* vertex = mFree.back();
+  mFree.pop_back();
+  *vertex = ClipVertex();
+  return vertex;
+}
+
+void ClipVertexPool::Release(ClipVertex* vertex)
+{
+  mFree.push_back(vertex);
+}
+
+void ClipVertexPool::Reserve(size_t count)
+{
+  if(count <= mCapacity)
+    return;
+
+  size_t blockSize = count - mCapacity;
+  mBlocks.emplace_back(new ClipVertex[blockSize]);
+  mFree.reserve(count);
+  ClipVertex* block = mBlocks.back().get();
+  for(size_t i = 0; i < blockSize; ++i)
+    mFree.push_back(block + i);
+  mCapacity = count;
+}
+
+void ClipVertexPool::ShrinkToFit()
+{
+  if(mFree.size() != mCapacity)
+    return;
+
+  mBlocks.clear();
+  mBlocks.shrink_to_fit();
+  mFree.clear();
+  mFree.shrink_to_fit();
+  mCapacity = 0;
+}
+
 //-------------------------------------------------------------------ClipVertexList
 ClipVertexList::~ClipVertexList()
 {
+  Clear();
+}
+
+ClipVertexList& ClipVertexList::operator=(ClipVertexList&& rhs)
+{
+  if(this != &rhs)
+  {
+    Clear();
+    mHead = rhs.mHead;
+    mPool = rhs.mPool;
+    rhs.mHead = nullptr;
+  }
+  return *this;
+}
+
+void ClipVertexList::Clear()
+{
+  if(mHead == nullptr)
+    return;
+
   ClipVertex* node = mHead;
   do
   {
     ClipVertex* next = node->mNext;
-    delete node;
+    if(mPool != nullptr)
+      mPool->Release(node);
+    else
+      delete node;
     node = next;
   } while(node != mHead);
   mHead = nullptr;
 }
 
+void ClipVertexList::Reverse()
+{
+  if(mHead == nullptr)
+    return;
+
+  ClipVertex::Traverse(mHead, [](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    std::swap(vertex->mNext, vertex->mPrev);
+    return true;
+  });
+}
+
+//-------------------------------------------------------------------ClipProvenance
+void ClipProvenance::Clear()
+{
+  mSources.clear();
+  mContourStarts.clear();
+}
+
+size_t ClipProvenance::GetContourEnd(size_t contourIndex) const
+{
+  if(contourIndex + 1 < mContourStarts.size())
+    return mContourStarts[contourIndex + 1];
+  return mSources.size();
+}
+
+void ClipProvenance::ReverseContour(size_t contourIndex)
+{
+  std::reverse(mSources.begin() + GetContourBegin(contourIndex), mSources.begin() + GetContourEnd(contourIndex));
+}
+
+void ClipProvenance::Compact(const Array<size_t>& keptIndices, const PointContourList& contours)
+{
+  // Nothing was recorded when another engine ran.
+  if(mSources.empty())
+    return;
+  // The indices only increase, so each source is read before it could be overwritten.
+  for(size_t i = 0; i < keptIndices.size(); ++i)
+    mSources[i] = mSources[keptIndices[i]];
+  mSources.resize(keptIndices.size());
+
+  mContourStarts.clear();
+  size_t start = 0;
+  for(const PointContour& contour : contours)
+  {
+    mContourStarts.push_back(start);
+    start += contour.size();
+  }
+}
+
+//-------------------------------------------------------------------PointContourSink
+void PointContourSink::BeginContour()
+{
+  mContours.emplace_back();
+  if(mContourLengths != nullptr)
+    mContours.back().reserve((*mContourLengths)[mContours.size() - 1]);
+  if(mProvenance != nullptr)
+    mProvenance->mContourStarts.push_back(mProvenance->mSources.size());
+}
+
+void PointContourSink::AddVertex(const ClipVertex& vertex)
+{
+  mContours.back().push_back(vertex.mPoint);
+  if(mProvenance != nullptr)
+    mProvenance->mSources.push_back(vertex.mSource);
+  if(mChannels != nullptr)
+  {
+    for(ClipAttributeChannelBase* channel : *mChannels)
+      channel->Emit(vertex.mSource);
+  }
+}
+
+//-------------------------------------------------------------------CleanupContourSink
+void CleanupContourSink::BeginContour()
+{
+  if(mOptions == nullptr)
+  {
+    mTarget.BeginContour();
+    return;
+  }
+  mVertices.clear();
+  mStart = 0;
+  mDoubleArea = 0;
+}
+
+void CleanupContourSink::AddVertex(const ClipVertex& vertex)
+{
+  if(mOptions == nullptr)
+  {
+    mTarget.AddVertex(vertex);
+    return;
+  }
+
+  float epsilonSq = mOptions->mDuplicateEpsilon * mOptions->mDuplicateEpsilon;
+  if(!mVertices.empty() && Vec2::DistanceSq(mVertices.back().mPoint, vertex.mPoint) <= epsilonSq)
+    return;
+  while(mVertices.size() >= 2 && IsCollinear(mVertices[mVertices.size() - 2].mPoint, mVertices.back().mPoint, vertex.mPoint, mOptions->mCollinearTolerance))
+    PopBack();
+  if(!mVertices.empty())
+    mDoubleArea += Cross2d(mVertices.back().mPoint, vertex.mPoint);
+  mVertices.push_back(vertex);
+}
+
+void CleanupContourSink::EndContour()
+{
+  if(mOptions == nullptr)
+  {
+    mTarget.EndContour();
+    return;
+  }
+
+  // The start of the loop can also be a duplicate or in the middle of a straight run
+  float epsilonSq = mOptions->mDuplicateEpsilon * mOptions->mDuplicateEpsilon;
+  float tolerance = mOptions->mCollinearTolerance;
+  while(mVertices.size() - mStart >= 3)
+  {
+    const Vec2& front = mVertices[mStart].mPoint;
+    const Vec2& back = mVertices.back().mPoint;
+    if(Vec2::DistanceSq(back, front) > epsilonSq && !IsCollinear(mVertices[mVertices.size() - 2].mPoint, back, front, tolerance))
+      break;
+    PopBack();
+  }
+  while(mVertices.size() - mStart >= 3 && IsCollinear(mVertices.back().mPoint, mVertices[mStart].mPoint, mVertices[mStart + 1].mPoint, tolerance))
+  {
+    mDoubleArea -= Cross2d(mVertices[mStart].mPoint, mVertices[mStart + 1].mPoint);
+    ++mStart;
+  }
+  if(mVertices.size() - mStart < 3)
+    return;
+  float area = 0.5f * (mDoubleArea + Cross2d(mVertices.back().mPoint, mVertices[mStart].mPoint));
+  if(std::abs(area) < mOptions->mMinArea)
+    return;
+
+  mTarget.BeginContour();
+  for(size_t i = mStart; i < mVertices.size(); ++i)
+    mTarget.AddVertex(mVertices[i]);
+  mTarget.EndContour();
+}
+
+void CleanupContourSink::PopBack()
+{
+  size_t count = mVertices.size();
+  mDoubleArea -= Cross2d(mVertices[count - 2].mPoint, mVertices[count - 1].mPoint);
+  mVertices.pop_back();
+}
+
+//-------------------------------------------------------------------ClipResultSet
+void ClipResultSet::Clear()
+{
+  mComputed = ClipResultFlags::None;
+  mUnion.clear();
+  mSubtraction.clear();
+  mReverseSubtraction.clear();
+  mIntersection.clear();
+  mXor.clear();
+}
+
+static ClipVertex* AllocateVertex(ClipVertexPool* pool)
+{
+  if(pool != nullptr)
+    return pool->Allocate();
+  return new ClipVertex();
+}
+
 //-------------------------------------------------------------------Clipper
 void Clipper::BuildVertexList(const PointContour& points, ClipVertexList& result)
 {
-  result.mHead = nullptr;
+  BuildVertexList(points, ClipOperand::Polygon, result);
+}
+
+void Clipper::BuildVertexList(const PointContour& points, ClipOperand operand, ClipVertexList& result)
+{
+  result.Clear();
   if(points.empty())
     return;
 
-  size_t count = points.size();
-  Array<ClipVertex*> vertices;
-  vertices.resize(count);
-  for(size_t i = 0; i < count; ++i)
-  {
-    vertices[i] = new ClipVertex();
-    vertices[i]->mPoint = points[i];
-  }
-  for(size_t i = 0; i < count; ++i)
+  // Each vertex is linked to the previous one as it's created and the loop is closed at the end.
+  ClipVertex* head = nullptr;
+  ClipVertex* prev = nullptr;
+  for(size_t i = 0; i < points.size(); ++i)
   {
-    vertices[i]->mNext = vertices[(i + 1) % count];
-    vertices[i]->mPrev = vertices[(i + count - 1) % count];
+    ClipVertex* vertex = AllocateVertex(result.mPool);
+    vertex->mPoint = points[i];
+    vertex->mSource.mOperand = operand;
+    vertex->mSource.mEdgeIndex = i;
+    if(prev != nullptr)
+    {
+      prev->mNext = vertex;
+      vertex->mPrev = prev;
+    }
+    else
+      head = vertex;
+    prev = vertex;
   }
-  result.mHead = vertices[0];
+  prev->mNext = head;
+  head->mPrev = prev;
+  result.mHead = head;
 }
 
 void Clipper::ClassifyVertices(ClipVertexList& vertices)
@@ -146,6 +717,13 @@ void Clipper::ClassifyVertices(ClipVertexList& vertices)
 }
 
 void Clipper::ClipEdges(ClipVertex* start, ClipVertex* end, ClipVertexList& clipRegion)
+{
+  mEdgeIntersections.clear();
+  FindEdgeIntersections(start, end, clipRegion, mEdgeIntersections);
+  InsertEdgeIntersections(start, end, mEdgeIntersections);
+}
+
+void Clipper::FindEdgeIntersections(ClipVertex* start, ClipVertex* end, ClipVertexList& clipRegion, Array<ClipEdgeIntersection>& intersections)
 {
   // This algorithm effectively works by checking each edge in the clip region against this edge,
   // inserting new vertices on the edge when there's an intersection point. These edges need to
@@ -153,26 +731,21 @@ void Clipper::ClipEdges(ClipVertex* start, ClipVertex* end, ClipVertexList& clip
   // one new intersection point, but the given edge could have multiple intersection points and 
   // we'll find them in traversal order (not t-order). To fix this, store them and then sort
   // by t-value so we can be guaranteed to have a valid line.
-  struct IntersectionVerts
-  {
-    ClipVertex* mVertex;
-    float mTime;
-  };
-  Array<IntersectionVerts> newVerts;
-
   ClipVertex* clipStart = clipRegion.mHead;
   do
   {
     ClipVertex* clipNext = clipStart->mNext;
 
     ClipVertexClassification line0Flags, line1Flags;
-    float time = ComputeIntersectionPoint(start->mPoint, end->mPoint, clipStart->mPoint, clipNext->mPoint, line0Flags, line1Flags);
+    float clipTime;
+    float time = ComputeIntersectionPoint(start->mPoint, end->mPoint, clipStart->mPoint, clipNext->mPoint, line0Flags, line1Flags, clipTime);
     if(0 <= time && time <= 1)
     {
       // Create the vertex we're inserting into the clip region list
-      ClipVertex* clipVert = new ClipVertex();
+      ClipVertex* clipVert = AllocateVertex(clipRegion.mPool);
       clipVert->mPoint = start->mPoint + (end->mPoint - start->mPoint) * time;
       clipVert->mClassification = line1Flags;
+      clipVert->mSource = ComputeSource(clipStart, clipNext, clipTime);
       // Link it into the clip list
       clipStart->mNext = clipVert;
       clipVert->mPrev = clipStart;
@@ -180,41 +753,45 @@ void Clipper::ClipEdges(ClipVertex* start, ClipVertex* end, ClipVertexList& clip
       clipNext->mPrev = clipVert;
 
       // Also create the vertex for the given edge, but defer adding it until the end.
-      ClipVertex* edgeVert = new ClipVertex();
+      ClipVertex* edgeVert = AllocateVertex(clipRegion.mPool);
       edgeVert->mPoint = clipVert->mPoint;
       edgeVert->mClassification = line0Flags;
+      edgeVert->mSource = ComputeSource(start, end, time);
       // Make sure to link the two edges together
       clipVert->mTwin = edgeVert;
       edgeVert->mTwin = clipVert;
 
-      IntersectionVerts iVert;
-      iVert.mVertex = edgeVert;
-      iVert.mTime = time;
-      newVerts.push_back(iVert);
+      ClipEdgeIntersection intersection;
+      intersection.mVertex = edgeVert;
+      intersection.mTime = time;
+      intersections.push_back(intersection);
     }
 
     clipStart = clipNext;
   } while(clipStart != clipRegion.mHead);
+}
 
+void Clipper::InsertEdgeIntersections(ClipVertex* start, ClipVertex* end, Array<ClipEdgeIntersection>& intersections)
+{
   // Sort the vertices in t-first order so we can create a valid line
-  std::sort(newVerts.begin(), newVerts.end(), [](const IntersectionVerts& lhs, const IntersectionVerts& rhs)
+  std::sort(intersections.begin(), intersections.end(), [](const ClipEdgeIntersection& lhs, const ClipEdgeIntersection& rhs)
   {
     return lhs.mTime < rhs.mTime;
   });
 
   // Insert all of the vertices into the given edge list
   ClipVertex* prevVertex = start;
-  size_t newVertCount = newVerts.size();
+  size_t newVertCount = intersections.size();
   for(size_t i = 0; i < newVertCount; ++i)
   {
-    ClipVertex* newVertex = newVerts[i].mVertex;
+    ClipVertex* newVertex = intersections[i].mVertex;
     newVertex->mPrev = prevVertex;
     prevVertex->mNext = newVertex;
     prevVertex = newVertex;
   }
   if(newVertCount != 0)
   {
-    ClipVertex* lastNewVertex = newVerts[newVertCount - 1].mVertex;
+    ClipVertex* lastNewVertex = intersections[newVertCount - 1].mVertex;
     lastNewVertex->mNext = end;
     end->mPrev = lastNewVertex;
   }
@@ -235,8 +812,19 @@ void Clipper::ClipPolygon(ClipVertexList& polygonToClip , ClipVertexList& clipRe
 void Clipper::BuildClipList(const PointContour& polygonPoints, const PointContour& clipRegionPoints, ClipVertexList& polyList, ClipVertexList& clipRegionList)
 {
   // Build the individual vertex lists for each polygon
-  BuildVertexList(clipRegionPoints, clipRegionList);
-  BuildVertexList(polygonPoints, polyList);
+  BuildVertexList(clipRegionPoints, ClipOperand::ClipRegion, clipRegionList);
+  BuildVertexList(polygonPoints, ClipOperand::Polygon, polyList);
+
+  BuildClipList(polyList, clipRegionList);
+}
+
+void Clipper::BuildClipList(ClipVertexList& polyList, ClipVertexList& clipRegionList)
+{
+  if(mThreadCount != 1)
+  {
+    ClipPolygonParallel(polyList, clipRegionList);
+    return;
+  }
 
   // Clip them against each other and then classify all vertices. Classification is needed to know how to start certain algorithms
   ClipPolygon(polyList, clipRegionList);
@@ -244,32 +832,97 @@ void Clipper::BuildClipList(const PointContour& polygonPoints, const PointContou
   ClassifyVertices(clipRegionList);
 }
 
-void Clipper::Union(ClipVertexList& polygon, PointContour& results)
+void Clipper::Normalize(const PointContour& points, ClipFillRule fillRule, Array<ClipVertexList>& pieces)
 {
-  // To start the algorithm, we need a point on the original polygon that will not be clipped away.
-  // The only guarantee for this is a intersection point, in particular we need one that is entering the clip region.
-  // If there is no intersection point then there's no union to do.
-  ClipVertex* firstIntersection = ClipVertex::FindFirstOf(polygon.mHead, ClipVertexClassification::OutToIn);
-  if(firstIntersection == nullptr)
-    return;
+  pieces.clear();
+  ScanlineClipper scanline;
+  scanline.mFillRule = fillRule;
+  scanline.mClockwiseOutput = true;
+  // Each piece is built straight from the sweep's scratch contour.
+  scanline.Execute(ClipOperation::Union, PointContourList{points}, PointContourList(), [this, &pieces](const PointContour& contour)
+  {
+    pieces.emplace_back();
+    BuildVertexList(contour, pieces.back());
+  });
+}
+
+void Clipper::Normalize(const PointContour& points, ClipFillRule fillRule, PointContourList& contours)
+{
+  ScanlineClipper scanline;
+  scanline.mFillRule = fillRule;
+  scanline.mClockwiseOutput = true;
+  scanline.Execute(ClipOperation::Union, PointContourList{points}, PointContourList(), contours);
+}
+
+bool Clipper::HasSelfIntersections(const PointContour& points)
+{
+  size_t count = points.size();
+  if(count < 4)
+    return false;
+
+  Array<size_t> edges(count);
+  for(size_t i = 0; i < count; ++i)
+    edges[i] = i;
+  auto minY = [&points, count](size_t edge) { return std::min(points[edge].y, points[(edge + 1) % count].y); };
+  auto maxY = [&points, count](size_t edge) { return std::max(points[edge].y, points[(edge + 1) % count].y); };
+  std::sort(edges.begin(), edges.end(), [&minY](size_t lhs, size_t rhs) { return minY(lhs) < minY(rhs); });
 
-  // Traverse the vertex list, adding each point to the result. If a vertex has a twin, walk that list until they meet back up again.
-  ClipVertex::Traverse(firstIntersection, [&results](ClipVertex* vertex, ClipVertex*& nextVertex)
+  Array<size_t> activeEdges;
+  for(size_t edge : edges)
   {
-    results.push_back(vertex->mPoint);
-    if(vertex->mTwin != nullptr)
+    float y = minY(edge);
+    activeEdges.erase(std::remove_if(activeEdges.begin(), activeEdges.end(), [&maxY, y](size_t active) { return maxY(active) < y; }), activeEdges.end());
+
+    const Vec2& start = points[edge];
+    const Vec2& end = points[(edge + 1) % count];
+    for(size_t active : activeEdges)
     {
-      ClipVertex* next = ClipVertex::WalkTwinListForwards(vertex, [&results](ClipVertex* v)
-      {
-        results.push_back(v->mPoint);
-      });
-      nextVertex = next->mNext;
+      // Neighboring edges always share a vertex
+      if((active + 1) % count == edge || (edge + 1) % count == active)
+        continue;
+      if(ComputeEdgeContact(start, end, points[active], points[(active + 1) % count]) != EdgeContact::None)
+        return true;
     }
-    return true;
-  });
+    activeEdges.push_back(edge);
+  }
+  return false;
+}
+
+void Clipper::Union(ClipVertexList& polygon, PointContour& results)
+{
+  // The results only have room for the outer loop, so holes aren't traced.
+  ClipVertex* start = ClipVertex::FindUnionStart(polygon.mHead);
+  if(start == nullptr)
+    return;
+  PointContourList contours;
+  PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+  CleanupContourSink sink(pointSink, mCleanup);
+  TraceUnionContour(start, sink);
+  if(!contours.empty())
+    results = std::move(contours[0]);
 }
 
 void Clipper::Subtract(ClipVertexList& polygon, PointContourList& contours)
+{
+  PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+  CleanupContourSink sink(pointSink, mCleanup);
+  Subtract(polygon, sink);
+}
+
+void Clipper::Intersect(ClipVertexList& polygon, PointContourList& contours)
+{
+  PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+  CleanupContourSink sink(pointSink, mCleanup);
+  Intersect(polygon, sink);
+}
+
+void Clipper::Union(ClipVertexList& polygon, ClipContourSink& sink)
+{
+  // The union's boundary is every part of either polygon that's outside of the other one.
+  TraceUnion(polygon.mHead, sink);
+}
+
+void Clipper::Subtract(ClipVertexList& polygon, ClipContourSink& sink)
 {
   // To do a subtraction, we need to trace all contours on the original polygon
   // that start from any vertex that leaves the clip region.
@@ -281,24 +934,23 @@ void Clipper::Subtract(ClipVertexList& polygon, PointContourList& contours)
   // Keep track of all potential contour starting points (any point that leaves the clip region).
   // The algorithm will find new points during traversal and will finish once this is empty.
   // Every new point in here that hasn't already been visited is a new contour.
-  Array<ClipVertex*> verticesToVisit{head};
-  while(!verticesToVisit.empty())
+  mVerticesToVisit.assign(1, head);
+  while(!mVerticesToVisit.empty())
   {
-    ClipVertex* contourStart = verticesToVisit.back();
-    verticesToVisit.pop_back();
+    ClipVertex* contourStart = mVerticesToVisit.back();
+    mVerticesToVisit.pop_back();
 
     if(contourStart->mVisited)
       continue;
 
     ClipVertex* vertex = contourStart;
     ClipVertexSearchDirection direction = ClipVertexSearchDirection::Forwards;
-    contours.push_back(PointContour());
-    PointContour& currentContour = contours.back();
+    sink.BeginContour();
     
     // Trace this contour by hoping between the polygon and clip region every time we hit an intersection point.
     do
     {
-      currentContour.push_back(vertex->mPoint);
+      sink.AddVertex(*vertex);
       vertex->mVisited = true;
       vertex = vertex->GetNext(direction);
 
@@ -311,7 +963,7 @@ void Clipper::Subtract(ClipVertexList& polygon, PointContourList& contours)
         if(!vertex->mVisited && direction == ClipVertexSearchDirection::Forwards && vertex->mClassification == ClipVertexClassification::OutToIn)
         {
           ClipVertex* nextVertToLeaveClipRegion = ClipVertex::FindFirstOf(vertex, ClipVertexClassification::InToOut);
-          verticesToVisit.push_back(nextVertToLeaveClipRegion);
+          mVerticesToVisit.push_back(nextVertToLeaveClipRegion);
         }
         // Every time we switch between the polygon and clip region we need to change our winding order as we have to traverse the clip region backwards
         direction = FlipSearchDirection(direction);
@@ -319,10 +971,11 @@ void Clipper::Subtract(ClipVertexList& polygon, PointContourList& contours)
       }
       // If we reach the starting vertex (or it's twin) then we've finished the loop of this contour.
     } while(vertex != contourStart && vertex->mTwin != contourStart);
+    sink.EndContour();
   }
 }
 
-void Clipper::Intersect(ClipVertexList& polygon, PointContourList& contours)
+void Clipper::Intersect(ClipVertexList& polygon, ClipContourSink& sink)
 {
   // To compute an intersection, we need to trace along the intersection of the two regions.
   // To do this, start with a vertex that is going into the clip region.
@@ -331,23 +984,22 @@ void Clipper::Intersect(ClipVertexList& polygon, PointContourList& contours)
   if(head == nullptr)
     return;
 
-  Array<ClipVertex*> verticesToVisit{head};
-  while(!verticesToVisit.empty())
+  mVerticesToVisit.assign(1, head);
+  while(!mVerticesToVisit.empty())
   {
-    ClipVertex* contourStart = verticesToVisit.back();
-    verticesToVisit.pop_back();
+    ClipVertex* contourStart = mVerticesToVisit.back();
+    mVerticesToVisit.pop_back();
     
     if(contourStart->mVisited)
       continue;
 
     ClipVertex* vertex = contourStart;
-    contours.push_back(PointContour());
-    PointContour& currentContour = contours.back();
+    sink.BeginContour();
 
     // Trace this contour by hoping between polygons any time we try to leave the interior of one of them.
     do
     {
-      currentContour.push_back(vertex->mPoint);
+      sink.AddVertex(*vertex);
       vertex->mVisited = true;
       vertex = vertex->mNext;
 
@@ -358,22 +1010,54 @@ void Clipper::Intersect(ClipVertexList& polygon, PointContourList& contours)
         if(!vertex->mVisited)
         {
           ClipVertex* nextVertToLeaveClipRegion = ClipVertex::FindFirstOf(vertex, ClipVertexClassification::OutToIn);
-          verticesToVisit.push_back(nextVertToLeaveClipRegion);
+          mVerticesToVisit.push_back(nextVertToLeaveClipRegion);
         }
         
         vertex = vertex->mTwin;
       }
       // If we reach the starting vertex (or it's twin) then we've finished the loop of this contour.
     } while(vertex != contourStart && vertex->mTwin != contourStart);
+    sink.EndContour();
   }
 }
 
+void Clipper::Xor(ClipVertexList& polygon, ClipVertexList& clipRegion, PointContourList& contours)
+{
+  PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+  CleanupContourSink sink(pointSink, mCleanup);
+  Xor(polygon, clipRegion, sink);
+}
+
+void Clipper::Xor(ClipVertexList& polygon, ClipVertexList& clipRegion, ClipContourSink& sink)
+{
+  Subtract(polygon, sink);
+  ResetVisited(polygon);
+  ResetVisited(clipRegion);
+  Subtract(clipRegion, sink);
+}
+
+void Clipper::ResetVisited(ClipVertexList& vertices)
+{
+  if(vertices.IsEmpty())
+    return;
+
+  ClipVertex::Traverse(vertices.mHead, [](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    vertex->mVisited = false;
+    return true;
+  });
+}
+
 void Clipper::Union(const PointContour& polygonPoints, const PointContour& clipRegion, PointContour& results)
 {
   results.clear();
+  if(mProvenance != nullptr)
+    mProvenance->Clear();
+  for(ClipAttributeChannelBase* channel : mAttributeChannels)
+    channel->Clear();
 
-  ClipVertexList clipList;
-  ClipVertexList polyList;
+  ClipVertexList clipList(&mVertexPool);
+  ClipVertexList polyList(&mVertexPool);
   BuildClipList(polygonPoints, clipRegion, polyList, clipList);
 
   Union(polyList, results);
@@ -381,10 +1065,10 @@ void Clipper::Union(const PointContour& polygonPoints, const PointContour& clipR
 
 void Clipper::Subtract(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours)
 {
-  contours.clear();
+  ClearOutput(contours);
 
-  ClipVertexList clipList;
-  ClipVertexList polyList;
+  ClipVertexList clipList(&mVertexPool);
+  ClipVertexList polyList(&mVertexPool);
   BuildClipList(polygonPoints, clipRegion, polyList, clipList);
 
   Subtract(polyList, contours);
@@ -392,11 +1076,552 @@ void Clipper::Subtract(const PointContour& polygonPoints, const PointContour& cl
 
 void Clipper::Intersect(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours)
 {
-  contours.clear();
+  ClearOutput(contours);
 
-  ClipVertexList clipList;
-  ClipVertexList polyList;
+  ClipVertexList clipList(&mVertexPool);
+  ClipVertexList polyList(&mVertexPool);
   BuildClipList(polygonPoints, clipRegion, polyList, clipList);
 
   Intersect(polyList, contours);
 }
+
+void Clipper::Xor(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours)
+{
+  ClearOutput(contours);
+
+  ClipVertexList clipList(&mVertexPool);
+  ClipVertexList polyList(&mVertexPool);
+  BuildClipList(polygonPoints, clipRegion, polyList, clipList);
+
+  Xor(polyList, clipList, contours);
+}
+
+void Clipper::ComputeAll(const PointContour& polygonPoints, const PointContour& clipRegion, unsigned resultFlags, ClipResultSet& results)
+{
+  results.Clear();
+  results.mComputed = resultFlags & ClipResultFlags::All;
+  if(results.mComputed == ClipResultFlags::None)
+    return;
+
+  ClipVertexList clipList(&mVertexPool);
+  ClipVertexList polyList(&mVertexPool);
+  BuildClipList(polygonPoints, clipRegion, polyList, clipList);
+
+  // Only the first trace starts from clean lists
+  bool needsReset = false;
+  auto resetIfNeeded = [&]()
+  {
+    if(needsReset)
+    {
+      ResetVisited(polyList);
+      ResetVisited(clipList);
+    }
+    needsReset = true;
+  };
+
+  // The results go to several lists, so no provenance is recorded.
+  if(resultFlags & ClipResultFlags::Union)
+  {
+    resetIfNeeded();
+    PointContourSink pointSink(results.mUnion);
+    CleanupContourSink sink(pointSink, mCleanup);
+    Union(polyList, sink);
+  }
+  if(resultFlags & ClipResultFlags::Intersection)
+  {
+    resetIfNeeded();
+    PointContourSink pointSink(results.mIntersection);
+    CleanupContourSink sink(pointSink, mCleanup);
+    Intersect(polyList, sink);
+  }
+
+  bool needsXor = (resultFlags & ClipResultFlags::Xor) != 0;
+  if(needsXor || (resultFlags & ClipResultFlags::Subtraction))
+  {
+    resetIfNeeded();
+    PointContourSink pointSink(results.mSubtraction);
+    CleanupContourSink sink(pointSink, mCleanup);
+    Subtract(polyList, sink);
+  }
+  if(needsXor || (resultFlags & ClipResultFlags::ReverseSubtraction))
+  {
+    resetIfNeeded();
+    PointContourSink pointSink(results.mReverseSubtraction);
+    CleanupContourSink sink(pointSink, mCleanup);
+    Subtract(clipList, sink);
+  }
+  if(needsXor)
+  {
+    results.mXor = results.mSubtraction;
+    results.mXor.insert(results.mXor.end(), results.mReverseSubtraction.begin(), results.mReverseSubtraction.end());
+    // The subtractions were only traced to build the xor
+    if(!(resultFlags & ClipResultFlags::Subtraction))
+      results.mSubtraction.clear();
+    if(!(resultFlags & ClipResultFlags::ReverseSubtraction))
+      results.mReverseSubtraction.clear();
+  }
+}
+
+void Clipper::Union(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours)
+{
+  Execute(ClipOperation::Union, PointContourList{polygonPoints}, PointContourList{clipRegion}, options, contours);
+}
+
+void Clipper::Subtract(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours)
+{
+  Execute(ClipOperation::Subtract, PointContourList{polygonPoints}, PointContourList{clipRegion}, options, contours);
+}
+
+void Clipper::Intersect(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours)
+{
+  Execute(ClipOperation::Intersect, PointContourList{polygonPoints}, PointContourList{clipRegion}, options, contours);
+}
+
+void Clipper::Xor(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours)
+{
+  Execute(ClipOperation::Xor, PointContourList{polygonPoints}, PointContourList{clipRegion}, options, contours);
+}
+
+void Clipper::Execute(ClipOperation operation, const PointContourList& polygons, const PointContourList& clipRegions, const ClipOptions& options, PointContourList& contours)
+{
+  if(options.mSimplifyInput != nullptr)
+  {
+    PointContourList simplifiedPolygons = polygons;
+    PointContourList simplifiedClipRegions = clipRegions;
+    options.mSimplifyInput->Simplify(simplifiedPolygons);
+    options.mSimplifyInput->Simplify(simplifiedClipRegions);
+    ClipOptions simplifiedOptions = options;
+    simplifiedOptions.mSimplifyInput = nullptr;
+    Execute(operation, simplifiedPolygons, simplifiedClipRegions, simplifiedOptions, contours);
+    return;
+  }
+
+  ClearOutput(contours);
+  ClipStats stats;
+  ClipEngine engine = options.mEngine;
+  bool singleContours = polygons.size() == 1 && clipRegions.size() == 1;
+  if(!singleContours)
+    engine = ClipEngine::Scanline;
+  else if(engine == ClipEngine::Automatic)
+  {
+    ClipCostModel defaultCostModel;
+    const ClipCostModel& costModel = options.mCostModel != nullptr ? *options.mCostModel : defaultCostModel;
+    stats.mInputStats.Compute(polygons[0], clipRegions[0], options.mCrossingSampleCount);
+    engine = costModel.ChooseEngine(operation, stats.mInputStats);
+    stats.mEstimatedCost = costModel.Estimate(engine, stats.mInputStats);
+  }
+  else if(engine == ClipEngine::Convex || engine == ClipEngine::Rectangle)
+  {
+    bool qualifies = operation == ClipOperation::Intersect && IsConvex(polygons[0]);
+    if(engine == ClipEngine::Convex)
+      qualifies = qualifies && IsConvex(clipRegions[0]);
+    else
+      qualifies = qualifies && IsAxisAlignedRectangle(clipRegions[0]);
+    if(!qualifies)
+      engine = ClipEngine::Scanline;
+  }
+
+  // The Weiler-Atherton engine needs a single simple clockwise polygon per operand.
+  Array<ClipVertexList> polygonPieces;
+  Array<ClipVertexList> clipPieces;
+  if(engine == ClipEngine::WeilerAtherton)
+  {
+    if(options.mNormalizeInput)
+    {
+      Normalize(polygons[0], options.mFillRule, polygonPieces);
+      Normalize(clipRegions[0], options.mFillRule, clipPieces);
+      if(polygonPieces.size() != 1 || clipPieces.size() != 1)
+        engine = ClipEngine::Scanline;
+      else
+      {
+        ClipVertex::Traverse(clipPieces[0].mHead, [](ClipVertex* vertex, ClipVertex*& nextVertex)
+        {
+          vertex->mSource.mOperand = ClipOperand::ClipRegion;
+          return true;
+        });
+      }
+    }
+    else if(options.mEngine == ClipEngine::Automatic && (HasSelfIntersections(polygons[0]) || HasSelfIntersections(clipRegions[0])))
+      engine = ClipEngine::Scanline;
+    else
+    {
+      polygonPieces.emplace_back(&mVertexPool);
+      clipPieces.emplace_back(&mVertexPool);
+      BuildVertexList(polygons[0], ClipOperand::Polygon, polygonPieces[0]);
+      BuildVertexList(clipRegions[0], ClipOperand::ClipRegion, clipPieces[0]);
+      if(ComputeSignedArea(polygons[0]) > 0)
+        polygonPieces[0].Reverse();
+      if(ComputeSignedArea(clipRegions[0]) > 0)
+        clipPieces[0].Reverse();
+    }
+  }
+  stats.mEngineUsed = engine;
+  if(options.mStats != nullptr)
+    *options.mStats = stats;
+
+  switch(engine)
+  {
+    case ClipEngine::Automatic:
+      ExecuteDisjoint(operation, polygons[0], clipRegions[0], options, contours);
+      break;
+    case ClipEngine::Scanline:
+    {
+      ScanlineClipper scanline;
+      scanline.mFillRule = options.mFillRule;
+      scanline.mClockwiseOutput = options.mClockwiseOutput;
+      scanline.Execute(operation, polygons, clipRegions, contours);
+      break;
+    }
+    case ClipEngine::Convex:
+    case ClipEngine::Rectangle:
+    {
+      ConvexClipper convex;
+      PointContour result;
+      if(engine == ClipEngine::Convex)
+        convex.Intersect(polygons[0], clipRegions[0], result);
+      else
+        convex.Intersect(polygons[0], ComputeAabb(clipRegions[0]), result);
+      if(result.empty())
+        break;
+      // Match the winding the scanline engine would have produced.
+      if((ComputeSignedArea(result) < 0) != options.mClockwiseOutput)
+        std::reverse(result.begin(), result.end());
+      contours.push_back(std::move(result));
+      break;
+    }
+    case ClipEngine::WeilerAtherton:
+    {
+      // Operands whose boundaries don't cross come back by containment. Normalized pieces can differ from the
+      // operands, so it's their points that are emitted then.
+      PointContour polygonPiece;
+      PointContour clipPiece;
+      if(options.mNormalizeInput)
+      {
+        CopyPoints(polygonPieces[0], polygonPiece);
+        CopyPoints(clipPieces[0], clipPiece);
+      }
+      const PointContour& polygonPoints = options.mNormalizeInput ? polygonPiece : polygons[0];
+      const PointContour& clipRegion = options.mNormalizeInput ? clipPiece : clipRegions[0];
+      PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+      CleanupContourSink sink(pointSink, mCleanup);
+      BuildClipList(polygonPieces[0], clipPieces[0]);
+      ExecuteClipped(operation, polygonPoints, clipRegion, polygonPieces[0], clipPieces[0], sink);
+      // The traced contours follow the clockwise operands.
+      if(!options.mClockwiseOutput)
+        ReverseOutput(contours);
+      break;
+    }
+  }
+
+  if(options.mSimplifyOutput != nullptr)
+    SimplifyOutput(*options.mSimplifyOutput, contours);
+}
+
+void Clipper::Execute(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, ClipContourSink& sink)
+{
+  CleanupContourSink cleanupSink(sink, mCleanup);
+  ClipVertexList polyList(&mVertexPool);
+  ClipVertexList clipRegionList(&mVertexPool);
+  BuildOrientedClipList(polygonPoints, clipRegion, polyList, clipRegionList);
+  ExecuteClipped(operation, polygonPoints, clipRegion, polyList, clipRegionList, cleanupSink);
+}
+
+void Clipper::ExecuteExact(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours, ClipExactSizes* sizes)
+{
+  ClearOutput(contours);
+  ClipExactSizes counted;
+  counted.mCrossingCount = CountCrossings(polygonPoints, clipRegion);
+  counted.mVertexCount = polygonPoints.size() + clipRegion.size() + 2 * counted.mCrossingCount;
+  Reserve(counted.mVertexCount);
+
+  ClipVertexList polyList(&mVertexPool);
+  ClipVertexList clipRegionList(&mVertexPool);
+  BuildOrientedClipList(polygonPoints, clipRegion, polyList, clipRegionList);
+
+  // The counting trace goes through the same cleanup so the lengths match what's kept.
+  mContourLengths.clear();
+  CountingContourSink countingSink(mContourLengths);
+  CleanupContourSink countingCleanupSink(countingSink, mCleanup);
+  ExecuteClipped(operation, polygonPoints, clipRegion, polyList, clipRegionList, countingCleanupSink);
+  ResetVisited(polyList);
+  ResetVisited(clipRegionList);
+
+  counted.mContourCount = mContourLengths.size();
+  for(size_t length : mContourLengths)
+    counted.mOutputVertexCount += length;
+  contours.reserve(counted.mContourCount);
+  if(mProvenance != nullptr)
+  {
+    mProvenance->mSources.reserve(counted.mOutputVertexCount);
+    mProvenance->mContourStarts.reserve(counted.mContourCount);
+  }
+  for(ClipAttributeChannelBase* channel : mAttributeChannels)
+    channel->Reserve(counted.mOutputVertexCount);
+
+  PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+  pointSink.mContourLengths = &mContourLengths;
+  CleanupContourSink sink(pointSink, mCleanup);
+  ExecuteClipped(operation, polygonPoints, clipRegion, polyList, clipRegionList, sink);
+  if(sizes != nullptr)
+    *sizes = counted;
+}
+
+size_t Clipper::CountCrossings(const PointContour& polygonPoints, const PointContour& clipRegion) const
+{
+  // The same test FindEdgeIntersections runs, on the original edges.
+  size_t polygonCount = polygonPoints.size();
+  size_t clipRegionCount = clipRegion.size();
+  size_t crossings = 0;
+  for(size_t i = 0; i < polygonCount; ++i)
+  {
+    const Vec2& start = polygonPoints[i];
+    const Vec2& end = polygonPoints[(i + 1) % polygonCount];
+    for(size_t j = 0; j < clipRegionCount; ++j)
+    {
+      ClipVertexClassification line0Flags, line1Flags;
+      float time = ComputeIntersectionPoint(start, end, clipRegion[j], clipRegion[(j + 1) % clipRegionCount], line0Flags, line1Flags);
+      if(0 <= time && time <= 1)
+        ++crossings;
+    }
+  }
+  return crossings;
+}
+
+void Clipper::BuildOrientedClipList(const PointContour& polygonPoints, const PointContour& clipRegion, ClipVertexList& polyList, ClipVertexList& clipRegionList)
+{
+  BuildVertexList(polygonPoints, ClipOperand::Polygon, polyList);
+  BuildVertexList(clipRegion, ClipOperand::ClipRegion, clipRegionList);
+  if(ComputeSignedArea(polygonPoints) > 0)
+    polyList.Reverse();
+  if(ComputeSignedArea(clipRegion) > 0)
+    clipRegionList.Reverse();
+  BuildClipList(polyList, clipRegionList);
+}
+
+void Clipper::ExecuteClipped(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, ClipVertexList& polyList, ClipVertexList& clipRegionList, ClipContourSink& sink)
+{
+  if(ClipVertex::FindFirstIntersection(polyList.mHead) != nullptr)
+  {
+    Trace(operation, polyList, clipRegionList, sink);
+    return;
+  }
+
+  EmitUncrossed(operation, polygonPoints.data(), polygonPoints.size(), clipRegion.data(), clipRegion.size(), sink);
+}
+
+void Clipper::Trace(ClipOperation operation, ClipVertexList& polyList, ClipVertexList& clipRegionList, ClipContourSink& sink)
+{
+  switch(operation)
+  {
+    case ClipOperation::Union:
+      Union(polyList, sink);
+      break;
+    case ClipOperation::Subtract:
+      Subtract(polyList, sink);
+      break;
+    case ClipOperation::Intersect:
+      Intersect(polyList, sink);
+      break;
+    case ClipOperation::Xor:
+      Xor(polyList, clipRegionList, sink);
+      break;
+  }
+}
+
+void Clipper::ExecuteDisjoint(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours)
+{
+  switch(operation)
+  {
+    case ClipOperation::Union:
+    case ClipOperation::Xor:
+      AppendFilled(polygonPoints, options, contours);
+      AppendFilled(clipRegion, options, contours);
+      break;
+    case ClipOperation::Subtract:
+      AppendFilled(polygonPoints, options, contours);
+      break;
+    case ClipOperation::Intersect:
+      break;
+  }
+}
+
+void Clipper::AppendFilled(const PointContour& points, const ClipOptions& options, PointContourList& contours)
+{
+  if(HasSelfIntersections(points))
+  {
+    PointContourList pieces;
+    ScanlineClipper scanline;
+    scanline.mFillRule = options.mFillRule;
+    scanline.mClockwiseOutput = options.mClockwiseOutput;
+    scanline.Execute(ClipOperation::Union, PointContourList{points}, PointContourList(), pieces);
+    for(PointContour& piece : pieces)
+      contours.push_back(std::move(piece));
+    return;
+  }
+
+  float area = ComputeSignedArea(points);
+  if(area == 0)
+    return;
+  // A simple polygon is filled under every rule except the signed rule that doesn't match its winding.
+  if((options.mFillRule == ClipFillRule::Positive && area < 0) || (options.mFillRule == ClipFillRule::Negative && area > 0))
+    return;
+  contours.push_back(points);
+  if((area < 0) != options.mClockwiseOutput)
+    std::reverse(contours.back().begin(), contours.back().end());
+}
+
+void Clipper::IntersectWithContainment(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours)
+{
+  Intersect(polygonPoints, clipRegion, contours);
+  if(!contours.empty())
+    return;
+
+  // Without a result or any crossing, one operand is either inside the other or they're apart.
+  if(FindFirstContact(polygonPoints, clipRegion, EdgeContact::Cross) == EdgeContact::Cross)
+    return;
+  PointContourSink pointSink(contours, mProvenance, &mAttributeChannels);
+  CleanupContourSink sink(pointSink, mCleanup);
+  EmitUncrossed(ClipOperation::Intersect, polygonPoints.data(), polygonPoints.size(), clipRegion.data(), clipRegion.size(), sink);
+}
+
+EdgeContact Clipper::FindFirstContact(const PointContour& polygonPoints, const PointContour& clipRegion, EdgeContact stopAt)
+{
+  EdgeContact result = EdgeContact::None;
+  if(polygonPoints.empty() || clipRegion.empty())
+    return result;
+
+  Aabb clipAabb = ComputeAabb(clipRegion);
+  size_t polygonCount = polygonPoints.size();
+  size_t clipCount = clipRegion.size();
+  for(size_t i = 0; i < polygonCount; ++i)
+  {
+    const Vec2& start0 = polygonPoints[i];
+    const Vec2& end0 = polygonPoints[(i + 1) % polygonCount];
+    // Edges that can't reach the clip region don't need to be tested against every clip edge
+    if(!Aabb::FromSegment(start0, end0).Overlaps(clipAabb))
+      continue;
+
+    for(size_t j = 0; j < clipCount; ++j)
+    {
+      EdgeContact contact = ComputeEdgeContact(start0, end0, clipRegion[j], clipRegion[(j + 1) % clipCount]);
+      if(contact > result)
+        result = contact;
+      if(result != EdgeContact::None && result >= stopAt)
+        return result;
+    }
+  }
+  return result;
+}
+
+bool Clipper::Intersects(const PointContour& polygonPoints, const PointContour& clipRegion)
+{
+  if(polygonPoints.empty() || clipRegion.empty())
+    return false;
+  if(!ComputeAabb(polygonPoints).Overlaps(ComputeAabb(clipRegion)))
+    return false;
+
+  if(FindFirstContact(polygonPoints, clipRegion, EdgeContact::Touch) != EdgeContact::None)
+    return true;
+  // The boundaries never meet so the only way to intersect is for one polygon to be fully inside the other.
+  return ContainsPoint(polygonPoints, clipRegion[0]) || ContainsPoint(clipRegion, polygonPoints[0]);
+}
+
+bool Clipper::Contains(const PointContour& polygonPoints, const PointContour& clipRegion)
+{
+  if(polygonPoints.empty() || clipRegion.empty())
+    return false;
+  if(!ComputeAabb(polygonPoints).Contains(ComputeAabb(clipRegion)))
+    return false;
+
+  EdgeContact contact = FindFirstContact(polygonPoints, clipRegion, EdgeContact::Cross);
+  if(contact == EdgeContact::Cross)
+    return false;
+  if(contact == EdgeContact::None)
+    return ContainsPoint(polygonPoints, clipRegion[0]);
+
+  // The boundaries touch, so the clip region could leave the polygon at a touching point. Every point not on the boundary has to be inside.
+  bool anyOutside = AnySampleOffBoundary(clipRegion, polygonPoints, [&polygonPoints](const Vec2& point)
+  {
+    return !ContainsPoint(polygonPoints, point);
+  });
+  return !anyOutside;
+}
+
+bool Clipper::Touches(const PointContour& polygonPoints, const PointContour& clipRegion)
+{
+  if(polygonPoints.empty() || clipRegion.empty())
+    return false;
+  if(!ComputeAabb(polygonPoints).Overlaps(ComputeAabb(clipRegion)))
+    return false;
+
+  // A crossing means the interiors overlap and no contact means the boundaries never meet
+  if(FindFirstContact(polygonPoints, clipRegion, EdgeContact::Cross) != EdgeContact::Touch)
+    return false;
+
+  auto insidePolygon = [&polygonPoints](const Vec2& point) { return ContainsPoint(polygonPoints, point); };
+  auto insideClipRegion = [&clipRegion](const Vec2& point) { return ContainsPoint(clipRegion, point); };
+  if(AnySampleOffBoundary(clipRegion, polygonPoints, insidePolygon) || AnySampleOffBoundary(polygonPoints, clipRegion, insideClipRegion))
+    return false;
+  return !InteriorsMeetAlongBoundary(polygonPoints, clipRegion);
+}
+
+bool Clipper::Disjoint(const PointContour& polygonPoints, const PointContour& clipRegion)
+{
+  return !Intersects(polygonPoints, clipRegion);
+}
+
+void Clipper::ClearOutput(PointContourList& contours)
+{
+  contours.clear();
+  if(mProvenance != nullptr)
+    mProvenance->Clear();
+  for(ClipAttributeChannelBase* channel : mAttributeChannels)
+    channel->Clear();
+}
+
+void Clipper::ReverseOutput(PointContourList& contours)
+{
+  size_t begin = 0;
+  for(size_t i = 0; i < contours.size(); ++i)
+  {
+    size_t end = begin + contours[i].size();
+    std::reverse(contours[i].begin(), contours[i].end());
+    if(mProvenance != nullptr)
+      mProvenance->ReverseContour(i);
+    for(ClipAttributeChannelBase* channel : mAttributeChannels)
+      channel->Reverse(begin, end);
+    begin = end;
+  }
+}
+
+void Clipper::SimplifyOutput(ContourSimplifier& simplifier, PointContourList& contours)
+{
+  if(mProvenance == nullptr && mAttributeChannels.empty())
+  {
+    simplifier.Simplify(contours);
+    return;
+  }
+
+  Array<size_t> keptIndices;
+  simplifier.Simplify(contours, &keptIndices);
+  if(mProvenance != nullptr)
+    mProvenance->Compact(keptIndices, contours);
+  for(ClipAttributeChannelBase* channel : mAttributeChannels)
+    channel->Compact(keptIndices);
+}
+
+void Clipper::Reserve(size_t maxVertices)
+{
+  mVertexPool.Reserve(maxVertices);
+  mEdgeIntersections.reserve(maxVertices);
+  mVerticesToVisit.reserve(maxVertices);
+}
+
+void Clipper::ShrinkToFit()
+{
+  mVertexPool.ShrinkToFit();
+  mEdgeIntersections.clear();
+  mEdgeIntersections.shrink_to_fit();
+  mVerticesToVisit.clear();
+  mVerticesToVisit.shrink_to_fit();
+}
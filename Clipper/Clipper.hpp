@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Vector2.hpp"
+#include "Aabb.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
 #include <vector>
 
 template <typename T, typename...Extra>
@@ -21,18 +25,94 @@ enum class ClipVertexSearchDirection
   Forwards
 };
 
+enum class ClipEngine
+{
+  // Picks one of the engines below per call from cheap input statistics and a cost model (see ClipCostModel).
+  Automatic,
+  // The twin-linked vertex list implementation. Fast for small inputs but assumes each operand is a single
+  // simple polygon without holes, and that the boundaries only meet where they properly cross.
+  WeilerAtherton,
+  // Vatti style scanline sweep. Handles holes, self-intersections and multiple contours per operand.
+  Scanline,
+  // Sutherland-Hodgman against each edge of the clip region. Only valid to intersect two convex polygons.
+  Convex,
+  // Sutherland-Hodgman against the four sides of an axis aligned rectangle clip region. Only valid to intersect
+  // a convex polygon with the rectangle.
+  Rectangle
+};
+
+// Which winding numbers count as inside. Counter-clockwise loops add one to the winding number and clockwise
+// loops subtract one, so Positive keeps counter-clockwise regions and Negative keeps clockwise ones.
+enum class ClipFillRule
+{
+  EvenOdd,
+  NonZero,
+  Positive,
+  Negative
+};
+
+enum class ClipOperation
+{
+  Union,
+  Subtract,
+  Intersect,
+  // The symmetric difference, everything inside exactly one of the operands.
+  Xor
+};
+
+// Which input of a two operand operation a vertex came from.
+enum class ClipOperand
+{
+  Polygon,
+  ClipRegion
+};
+
+enum class EdgeContact
+{
+  None,
+  // The edges share a point (endpoint or collinear overlap) but don't properly cross.
+  Touch,
+  // The edges cross at a single point interior to both edges.
+  Cross
+};
+
 float Cross2d(const Vec2& lhs, const Vec2& rhs);
 float SignedArea(const Vec2& a, const Vec2& b, const Vec2& c);
+// Whether the point is on the line through its neighbors: the area they span is at most the tolerance times the
+// squared distance between the neighbors, so the test doesn't depend on scale.
+bool IsCollinear(const Vec2& prev, const Vec2& point, const Vec2& next, float tolerance);
 // Finds the interesction of the given two lines. The resultant t-value for the first line (line0).
 // If there was an intersection, then the the flags for each line are filled out to indicate if it went
 // from inside to out, or the opposite (where the inside is determined using the right-hand rule).
 float ComputeIntersectionPoint(const Vec2& start0, const Vec2& end0, const Vec2& start1, const Vec2& end1, ClipVertexClassification& line0Flags, ClipVertexClassification& line1Flags);
+// Same as above, but also returns the t-value of the intersection along the second line.
+float ComputeIntersectionPoint(const Vec2& start0, const Vec2& end0, const Vec2& start1, const Vec2& end1, ClipVertexClassification& line0Flags, ClipVertexClassification& line1Flags, float& line1Time);
 ClipVertexSearchDirection FlipSearchDirection(ClipVertexSearchDirection direction);
+// Determines how the two given lines touch. Unlike ComputeIntersectionPoint this is exact with respect
+// to endpoints, which is what the predicate queries need to tell touching apart from crossing.
+EdgeContact ComputeEdgeContact(const Vec2& start0, const Vec2& end0, const Vec2& start1, const Vec2& end1);
+
+struct ClipShape;
+struct ClipShapeOptions;
+struct ClipCostModel;
+struct ClipStats;
+struct ContourSimplifier;
+
+//-------------------------------------------------------------------ClipVertexSource
+// Where a vertex lies on its input contour: mTime along the edge from input point mEdgeIndex to the next one.
+// Original vertices are at time zero on the edge they start.
+struct ClipVertexSource
+{
+  ClipOperand mOperand = ClipOperand::Polygon;
+  size_t mEdgeIndex = 0;
+  float mTime = 0;
+};
 
 //-------------------------------------------------------------------ClipVertex
 struct ClipVertex
 {
   Vec2 mPoint;
+  ClipVertexSource mSource;
   ClipVertexClassification mClassification = ClipVertexClassification::None;
   bool mVisited = false;
   ClipVertex* mTwin = nullptr;
@@ -85,7 +165,50 @@ struct ClipVertex
   }
   static ClipVertex* FindFirstOf(ClipVertex* vertexList, ClipVertexClassification classification);
   static ClipVertex* FindFirstIntersection(ClipVertex* vertexList);
+  // The vertex to start the outer loop of a union from, given the polygon's list, or null if the lists don't cross.
+  // The leftmost point of both lists can't be inside the other polygon, so it's always on the outer loop.
+  static ClipVertex* FindUnionStart(ClipVertex* vertexList);
   ClipVertex* GetNext(ClipVertexSearchDirection direction);
+  // The next vertex along the boundary of a union. Both lists are followed forwards and the boundary swaps lists
+  // at every crossing, marking the crossing's vertex on the list it leaves as visited.
+  ClipVertex* GetNextOnUnion();
+};
+
+// The source of the point at the given time from start to end. Both vertices lie on one input edge, but either can
+// be an intersection partway along it, and the list may run against the input order after a Reverse.
+ClipVertexSource ComputeSource(const ClipVertex* start, const ClipVertex* end, float time);
+
+//-------------------------------------------------------------------ClipEdgeIntersection
+// An intersection vertex found on an edge that hasn't been linked into the edge yet.
+struct ClipEdgeIntersection
+{
+  ClipVertex* mVertex = nullptr;
+  float mTime = 0;
+};
+
+//-------------------------------------------------------------------ClipVertexPool
+// Recycles vertices so repeated operations stop going through the allocator. Vertices are allocated in blocks that
+// stay alive until the pool is destroyed or shrunk, so a pool has to outlive every list built from it.
+struct ClipVertexPool
+{
+  ClipVertexPool() {}
+  // Copies start out empty, as the vertices belong to the lists built from the original.
+  ClipVertexPool(const ClipVertexPool&) {}
+  ClipVertexPool& operator=(const ClipVertexPool&) { return *this; }
+
+  ClipVertex* Allocate();
+  void Release(ClipVertex* vertex);
+  // Makes sure at least count vertices exist in total so the next allocations don't need a new block.
+  void Reserve(size_t count);
+  // Frees every block, but only when all the vertices are back in the pool.
+  void ShrinkToFit();
+  size_t GetCapacity() const { return mCapacity; }
+  size_t GetFreeCount() const { return mFree.size(); }
+
+private:
+  Array<std::unique_ptr<ClipVertex[]>> mBlocks;
+  Array<ClipVertex*> mFree;
+  size_t mCapacity = 0;
 };
 
 //-------------------------------------------------------------------ClipVertexList
@@ -93,9 +216,23 @@ struct ClipVertexList
 {
   ClipVertexList() {}
   ClipVertexList(ClipVertex* vertex) : mHead(vertex) {}
+  explicit ClipVertexList(ClipVertexPool* pool) : mPool(pool) {}
+  // The list owns its vertices so it can only be moved, which lets lists live in an Array.
+  ClipVertexList(const ClipVertexList&) = delete;
+  ClipVertexList(ClipVertexList&& rhs) : mHead(rhs.mHead), mPool(rhs.mPool) { rhs.mHead = nullptr; }
   ~ClipVertexList();
+  ClipVertexList& operator=(const ClipVertexList&) = delete;
+  ClipVertexList& operator=(ClipVertexList&& rhs);
+
+  bool IsEmpty() const { return mHead == nullptr; }
+  void Clear();
+  // Flips the winding by swapping every vertex's next and previous pointers.
+  void Reverse();
 
   ClipVertex* mHead = nullptr;
+  // Where the list's vertices come from and go back to, or null to use new and delete. Lists that are clipped
+  // against each other have to share a pool, as the intersection vertices come from the clip region's.
+  ClipVertexPool* mPool = nullptr;
 };
 
 //-------------------------------------------------------------------PointContour
@@ -105,6 +242,20 @@ struct PointContour : public Array<Vec2>
   using BaseType::BaseType;
 };
 
+Aabb ComputeAabb(const PointContour& points);
+// Computes the signed area of the contour. Clockwise contours (such as the test data) are negative.
+float ComputeSignedArea(const PointContour& points);
+float ComputeSignedArea(const Vec2* points, size_t count);
+// Tests if the point is inside the polygon using the even-odd rule. Points exactly on the boundary may go either way.
+bool ContainsPoint(const PointContour& polygon, const Vec2& point);
+bool ContainsPoint(const Vec2* polygon, size_t count, const Vec2& point);
+// Tests if the region is within the polygon, given that their boundaries don't cross. They may still touch, so the
+// first vertex or edge midpoint of the region that's off the polygon's boundary decides.
+bool ContainsUncrossed(const Vec2* polygon, size_t polygonCount, const Vec2* region, size_t regionCount);
+// Tests if every turn of the contour goes the same way and it only winds once. Collinear points are allowed.
+bool IsConvex(const PointContour& points);
+bool IsAxisAlignedRectangle(const PointContour& points);
+
 //-------------------------------------------------------------------PointContourList
 struct PointContourList : public Array<PointContour>
 {
@@ -112,26 +263,468 @@ struct PointContourList : public Array<PointContour>
   using BaseType::BaseType;
 };
 
+//-------------------------------------------------------------------ClipProvenance
+// The source of every traced vertex, stored in one array parallel to the traced contours rather than per point.
+struct ClipProvenance
+{
+  void Clear();
+  size_t GetContourCount() const { return mContourStarts.size(); }
+  // The sources of contour i are mSources[GetContourBegin(i)] up to GetContourEnd(i).
+  size_t GetContourBegin(size_t contourIndex) const { return mContourStarts[contourIndex]; }
+  size_t GetContourEnd(size_t contourIndex) const;
+  // Keeps a contour's sources in step after the contour's points were reversed.
+  void ReverseContour(size_t contourIndex);
+  // Keeps the sources at the increasing keptIndices (see ContourSimplifier::Simplify) and splits them up again by
+  // the sizes of the simplified contours.
+  void Compact(const Array<size_t>& keptIndices, const PointContourList& contours);
+
+  Array<ClipVertexSource> mSources;
+  Array<size_t> mContourStarts;
+};
+
+//-------------------------------------------------------------------ClipAttributeChannelBase
+// A per-vertex attribute (uvs, colors, heights) carried through the Weiler-Atherton operations. The output is
+// appended as each vertex is traced, in one array parallel to the traced contours like ClipProvenance.
+struct ClipAttributeChannelBase
+{
+  virtual ~ClipAttributeChannelBase() {}
+  virtual void Clear() = 0;
+  // Appends the attribute at the given point of the inputs.
+  virtual void Emit(const ClipVertexSource& source) = 0;
+  // Copies the attribute at the given point of the inputs to memory that may not be aligned for it.
+  virtual void Write(const ClipVertexSource& source, void* destination) const = 0;
+  // Keeps the output in step after the points of one contour were reversed.
+  virtual void Reverse(size_t begin, size_t end) = 0;
+  // Keeps only the output at the increasing keptIndices, after the contours were simplified.
+  virtual void Compact(const Array<size_t>& keptIndices) = 0;
+  // Makes room for count more values in the output.
+  virtual void Reserve(size_t count) = 0;
+};
+
+//-------------------------------------------------------------------ClipAttributeChannel
+// Holds an operand's attributes parallel to its points. Original vertices copy their attribute and intersection
+// vertices lerp between the two ends of the edge they were found on, which needs T + (T - T) * float. Vertices
+// whose operand has no attributes (or whose source doesn't index the input, see Clipper::mProvenance) get T().
+template <typename T>
+struct ClipAttributeChannel : public ClipAttributeChannelBase
+{
+  void Clear() override
+  {
+    mOutput.clear();
+  }
+  void Emit(const ClipVertexSource& source) override
+  {
+    mOutput.push_back(Interpolate(source));
+  }
+  void Write(const ClipVertexSource& source, void* destination) const override
+  {
+    T value = Interpolate(source);
+    std::memcpy(destination, &value, sizeof(T));
+  }
+  T Interpolate(const ClipVertexSource& source) const
+  {
+    const Array<T>& input = source.mOperand == ClipOperand::Polygon ? mPolygon : mClipRegion;
+    size_t count = input.size();
+    if(source.mEdgeIndex >= count)
+      return T();
+
+    const T& start = input[source.mEdgeIndex];
+    if(source.mTime == 0)
+      return start;
+    const T& end = input[(source.mEdgeIndex + 1) % count];
+    return start + (end - start) * source.mTime;
+  }
+  void Reverse(size_t begin, size_t end) override
+  {
+    std::reverse(mOutput.begin() + begin, mOutput.begin() + end);
+  }
+  void Compact(const Array<size_t>& keptIndices) override
+  {
+    // Nothing was recorded when another engine ran.
+    if(mOutput.empty())
+      return;
+    for(size_t i = 0; i < keptIndices.size(); ++i)
+      mOutput[i] = mOutput[keptIndices[i]];
+    mOutput.resize(keptIndices.size());
+  }
+  void Reserve(size_t count) override
+  {
+    mOutput.reserve(mOutput.size() + count);
+  }
+
+  Array<T> mPolygon;
+  Array<T> mClipRegion;
+  Array<T> mOutput;
+};
+
+//-------------------------------------------------------------------ClipOptions
+struct ClipOptions
+{
+  ClipEngine mEngine = ClipEngine::Automatic;
+  // How the scanline engine decides what is inside an operand with overlapping or self-intersecting contours.
+  ClipFillRule mFillRule = ClipFillRule::EvenOdd;
+  // Results wind outer contours counter-clockwise and holes clockwise. This flips both.
+  bool mClockwiseOutput = false;
+  // Resolves self-intersections in the operands under mFillRule before the Weiler-Atherton engine runs. Operands
+  // that don't normalize into a single piece each go through the scanline engine, which handles them natively.
+  // Without this, automatic selection still avoids the Weiler-Atherton engine for self-intersecting operands.
+  bool mNormalizeInput = false;
+  // The cost model used by the automatic engine selection. Null uses the default coefficients.
+  const ClipCostModel* mCostModel = nullptr;
+  // How many edges are tested against the other operand to estimate the number of crossings.
+  size_t mCrossingSampleCount = 32;
+  // If set, receives which engine ran and the input statistics that decided it.
+  ClipStats* mStats = nullptr;
+  // If set, simplifies copies of the operands before they're clipped and the traced results afterwards. Each
+  // simplifier accumulates its removal counts. Provenance and attribute channels refer to the simplified operands
+  // and are compacted along with the vertices that output simplification removes.
+  ContourSimplifier* mSimplifyInput = nullptr;
+  ContourSimplifier* mSimplifyOutput = nullptr;
+};
+
+//-------------------------------------------------------------------ClipResultFlags
+// Selects which results ComputeAll traces.
+struct ClipResultFlags
+{
+  enum Enum : unsigned
+  {
+    None = 0,
+    Union = 1 << 0,
+    // The polygon minus the clip region.
+    Subtraction = 1 << 1,
+    // The clip region minus the polygon.
+    ReverseSubtraction = 1 << 2,
+    Intersection = 1 << 3,
+    Xor = 1 << 4,
+    All = Union | Subtraction | ReverseSubtraction | Intersection | Xor
+  };
+};
+
+//-------------------------------------------------------------------ClipResultSet
+struct ClipResultSet
+{
+  void Clear();
+
+  // The flags of the results that were computed. The other lists are left empty.
+  unsigned mComputed = ClipResultFlags::None;
+  PointContourList mUnion;
+  PointContourList mSubtraction;
+  PointContourList mReverseSubtraction;
+  PointContourList mIntersection;
+  PointContourList mXor;
+};
+
+//-------------------------------------------------------------------ClipContourSink
+// Receives contours as the Weiler-Atherton tracers walk them, so results can go straight to wherever the caller
+// needs them instead of through a PointContourList.
+struct ClipContourSink
+{
+  virtual ~ClipContourSink() {}
+  virtual void BeginContour() = 0;
+  virtual void AddVertex(const ClipVertex& vertex) = 0;
+  virtual void EndContour() = 0;
+};
+
+// Traces every loop of the union of two clipped and classified lists: the outer loop first, then each hole.
+void TraceUnion(ClipVertex* polygon, ClipContourSink& sink);
+
+// Emits an operand unchanged, wound clockwise as an outer contour or counter-clockwise as a hole.
+template <typename Sink>
+void EmitOperand(const Vec2* points, size_t count, ClipOperand operand, bool hole, Sink& sink)
+{
+  bool reversed = (ComputeSignedArea(points, count) <= 0) == hole;
+  ClipVertex vertex;
+  vertex.mSource.mOperand = operand;
+  sink.BeginContour();
+  for(size_t i = 0; i < count; ++i)
+  {
+    size_t index = reversed ? count - 1 - i : i;
+    vertex.mPoint = points[index];
+    vertex.mSource.mEdgeIndex = index;
+    sink.AddVertex(vertex);
+  }
+  sink.EndContour();
+}
+
+// Emits the result of an operation whose operands' boundaries don't cross, which leaves nothing to trace. The
+// result is made of the operands themselves, depending on which contains the other. Nothing is allocated, so
+// every Weiler-Atherton front end shares this.
+template <typename Sink>
+void EmitUncrossed(ClipOperation operation, const Vec2* polygonPoints, size_t polygonCount, const Vec2* clipRegion, size_t clipRegionCount, Sink& sink)
+{
+  bool polygonContainsClipRegion = ContainsUncrossed(polygonPoints, polygonCount, clipRegion, clipRegionCount);
+  bool clipRegionContainsPolygon = !polygonContainsClipRegion && ContainsUncrossed(clipRegion, clipRegionCount, polygonPoints, polygonCount);
+  switch(operation)
+  {
+    case ClipOperation::Union:
+      if(!clipRegionContainsPolygon)
+        EmitOperand(polygonPoints, polygonCount, ClipOperand::Polygon, false, sink);
+      if(!polygonContainsClipRegion)
+        EmitOperand(clipRegion, clipRegionCount, ClipOperand::ClipRegion, false, sink);
+      break;
+    case ClipOperation::Subtract:
+      if(!clipRegionContainsPolygon)
+        EmitOperand(polygonPoints, polygonCount, ClipOperand::Polygon, false, sink);
+      if(polygonContainsClipRegion)
+        EmitOperand(clipRegion, clipRegionCount, ClipOperand::ClipRegion, true, sink);
+      break;
+    case ClipOperation::Intersect:
+      if(polygonContainsClipRegion)
+        EmitOperand(clipRegion, clipRegionCount, ClipOperand::ClipRegion, false, sink);
+      else if(clipRegionContainsPolygon)
+        EmitOperand(polygonPoints, polygonCount, ClipOperand::Polygon, false, sink);
+      break;
+    case ClipOperation::Xor:
+      EmitOperand(polygonPoints, polygonCount, ClipOperand::Polygon, clipRegionContainsPolygon, sink);
+      EmitOperand(clipRegion, clipRegionCount, ClipOperand::ClipRegion, polygonContainsClipRegion, sink);
+      break;
+  }
+}
+
+//-------------------------------------------------------------------PointContourSink
+// Appends the traced contours to a list, their vertices' sources to the provenance and their attributes to the
+// channels, each if given.
+struct PointContourSink : public ClipContourSink
+{
+  PointContourSink(PointContourList& contours, ClipProvenance* provenance = nullptr, const Array<ClipAttributeChannelBase*>* channels = nullptr)
+    : mContours(contours), mProvenance(provenance), mChannels(channels) {}
+
+  void BeginContour() override;
+  void AddVertex(const ClipVertex& vertex) override;
+  void EndContour() override {}
+
+  PointContourList& mContours;
+  ClipProvenance* mProvenance;
+  const Array<ClipAttributeChannelBase*>* mChannels;
+  // If set, each new contour reserves the length at its index here, as measured by a CountingContourSink.
+  const Array<size_t>* mContourLengths = nullptr;
+};
+
+//-------------------------------------------------------------------CountingContourSink
+// Only records how many vertices each contour has, so the real outputs can be allocated at their exact size.
+struct CountingContourSink : public ClipContourSink
+{
+  CountingContourSink(Array<size_t>& contourLengths) : mContourLengths(contourLengths) {}
+
+  void BeginContour() override { mContourLengths.push_back(0); }
+  void AddVertex(const ClipVertex& vertex) override { ++mContourLengths.back(); }
+  void EndContour() override {}
+
+  Array<size_t>& mContourLengths;
+};
+
+//-------------------------------------------------------------------ClipExactSizes
+// What the counting pass of Clipper::ExecuteExact measured.
+struct ClipExactSizes
+{
+  size_t mCrossingCount = 0;
+  // The vertices of both clipped lists: the operands' points and two per crossing.
+  size_t mVertexCount = 0;
+  size_t mContourCount = 0;
+  size_t mOutputVertexCount = 0;
+};
+
+//-------------------------------------------------------------------ClipCleanupOptions
+struct ClipCleanupOptions
+{
+  // Points within this distance of the previous kept point are skipped. Crossings that land on a vertex insert a
+  // second vertex at the same spot, which zero already removes.
+  float mDuplicateEpsilon = 0;
+  // Points in the middle of straight runs are merged away (see IsCollinear). Negative keeps them.
+  float mCollinearTolerance = 1e-5f;
+  // Contours with a smaller absolute area are discarded. Contours under three points always are.
+  float mMinArea = 0;
+};
+
+//-------------------------------------------------------------------CleanupContourSink
+// Cleans contours on their way to another sink. Each contour is held back until it ends, as the start of the loop
+// can still be merged and its area decides whether it's kept, so the target receives the kept vertices in one go.
+// Without options everything goes straight through.
+struct CleanupContourSink : public ClipContourSink
+{
+  CleanupContourSink(ClipContourSink& target, const ClipCleanupOptions* options)
+    : mTarget(target), mOptions(options) {}
+
+  void BeginContour() override;
+  void AddVertex(const ClipVertex& vertex) override;
+  void EndContour() override;
+
+  ClipContourSink& mTarget;
+  const ClipCleanupOptions* mOptions;
+
+private:
+  void PopBack();
+
+  // The contour so far, starting at mStart, and twice its area without the closing edge.
+  Array<ClipVertex> mVertices;
+  size_t mStart = 0;
+  float mDoubleArea = 0;
+};
+
 //-------------------------------------------------------------------Clipper
 struct Clipper
 {
   // Converts the given points into a vertex list
   void BuildVertexList(const PointContour& points, ClipVertexList& result);
+  // Same as above, tagging every vertex's source with the operand.
+  void BuildVertexList(const PointContour& points, ClipOperand operand, ClipVertexList& result);
   // Classifies each vertex in the given list as being inside or outside.
   // This assumes that the list has already been clipped so that intersection points are tagged.
   void ClassifyVertices(ClipVertexList& vertices);
   // Clips the given edge against the provided clip polygon. Intersection point vertices are inserted into each polygon list.
   void ClipEdges(ClipVertex* start, ClipVertex* end, ClipVertexList& clipRegion);
+  // The two halves of ClipEdges. The clip region's intersection vertices are linked in right away while the edge's
+  // are only collected, so intersections against several clip regions can be inserted into the edge together.
+  void FindEdgeIntersections(ClipVertex* start, ClipVertex* end, ClipVertexList& clipRegion, Array<ClipEdgeIntersection>& intersections);
+  void InsertEdgeIntersections(ClipVertex* start, ClipVertex* end, Array<ClipEdgeIntersection>& intersections);
   // Clips the provided polygon against the clip region polygon, creating all intersection points.
   // Both polygons are assumed to not contain self-intersections.
   void ClipPolygon(ClipVertexList& polygonToClip, ClipVertexList& clipRegion);
   // Convertex the given point lists into two clipped lists, full of all the intersection points and classifications.
   void BuildClipList(const PointContour& polygonPoints, const PointContour& clipRegionPoints, ClipVertexList& polyList, ClipVertexList& clipRegionList);
+  // Same as above for lists that were already built, such as the pieces from Normalize.
+  void BuildClipList(ClipVertexList& polyList, ClipVertexList& clipRegionList);
+  // The intersection phase and classification of BuildClipList spread across mThreadCount threads. Each thread
+  // tests a range of polygon edges against the clip region's original edges and keeps its crossings to itself.
+  // The crossings are then linked into both lists in edge and time order, and the classification runs as a
+  // prefix scan over chunks of each list. Lists that don't have enough edge pairs to be worth it run serially.
+  void ClipPolygonParallel(ClipVertexList& polygonToClip, ClipVertexList& clipRegion);
+
+  // Splits a polygon that may intersect itself into simple pieces under the fill rule. This runs the scanline
+  // sweep, so edges are only tested against their neighbors in the active edge list rather than every other
+  // edge. Outer pieces wind clockwise as the Weiler-Atherton engine expects and holes wind counter-clockwise.
+  void Normalize(const PointContour& points, ClipFillRule fillRule, Array<ClipVertexList>& pieces);
+  void Normalize(const PointContour& points, ClipFillRule fillRule, PointContourList& contours);
+  // Sweeps the edges along y and tests each one against the edges overlapping it in y. Edges that touch
+  // anywhere other than their shared vertex count as an intersection.
+  bool HasSelfIntersections(const PointContour& points);
   void Union(ClipVertexList& polygon, PointContour& results);
   void Subtract(ClipVertexList& polygon, PointContourList& contours);
   void Intersect(ClipVertexList& polygon, PointContourList& contours);
+  // The tracers behind the above, emitting into a sink.
+  void Union(ClipVertexList& polygon, ClipContourSink& sink);
+  void Subtract(ClipVertexList& polygon, ClipContourSink& sink);
+  void Intersect(ClipVertexList& polygon, ClipContourSink& sink);
+  // Traces both differences from one set of clipped lists. The polygon minus the clip region is traced from the
+  // polygon's list and the clip region minus the polygon from the clip region's list, with the visited flags
+  // reset in between, so the intersection phase only runs once.
+  void Xor(ClipVertexList& polygon, ClipVertexList& clipRegion, PointContourList& contours);
+  void Xor(ClipVertexList& polygon, ClipVertexList& clipRegion, ClipContourSink& sink);
+  // Clears the visited flags so the lists can be traced again.
+  void ResetVisited(ClipVertexList& vertices);
 
   void Union(const PointContour& polygonPoints, const PointContour& clipRegion, PointContour& results);
   void Subtract(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours);
   void Intersect(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours);
+  void Xor(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours);
+  // Builds and classifies the lists once and traces every result selected by the flags (see ClipResultFlags)
+  // from them, resetting the visited flags between traces. The xor is put together from the two subtractions.
+  void ComputeAll(const PointContour& polygonPoints, const PointContour& clipRegion, unsigned resultFlags, ClipResultSet& results);
+  // Same as Intersect, but also handles the case where there are no crossings because one polygon is fully inside the other
+  // (see EmitUncrossed).
+  void IntersectWithContainment(const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours);
+
+  // Runs the operation with the engine chosen in the options. Every operation can return several contours
+  // as the scanline engine supports holes (wound opposite to the outer contours).
+  void Union(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours);
+  void Subtract(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours);
+  void Intersect(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours);
+  void Xor(const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours);
+  // Runs the operation on operands made of several contours. The Weiler-Atherton engine only supports
+  // a single contour per operand, so anything else always runs through the scanline engine. The convex and
+  // rectangle engines also fall back to the scanline engine when the inputs don't qualify for them.
+  void Execute(ClipOperation operation, const PointContourList& polygons, const PointContourList& clipRegions, const ClipOptions& options, PointContourList& contours);
+  // Runs the operation with the Weiler-Atherton engine into a sink, so the results can be written straight to
+  // where they're needed. Operands of either winding are accepted and results wind clockwise with
+  // counter-clockwise holes. When the boundaries don't cross, the result is made of the operands themselves
+  // depending on which contains the other. The operands must not self-intersect.
+  void Execute(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, ClipContourSink& sink);
+  // Exact-allocation version of the above for threads that can't allocate without bound. A first pass counts the
+  // crossings, which sizes the vertex store before any vertices are built, then traces the clipped lists only to
+  // count the length of every output contour. The outputs, provenance and attributes are then allocated once at
+  // their exact size and filled by a second trace. Only the scratch buffers can still grow, and only until they
+  // reach the largest operation seen (see Reserve). The sizes that were counted are returned if asked for.
+  void ExecuteExact(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, PointContourList& contours, ClipExactSizes* sizes = nullptr);
+  // Counts the crossings the intersection phase will find, without building any vertices. Crossings exactly at a
+  // vertex can come out differently once the clip region's edges are split, so the count is a close estimate.
+  size_t CountCrossings(const PointContour& polygonPoints, const PointContour& clipRegion) const;
+  // Builds the vertex lists for Execute, both wound clockwise, and clips them.
+  void BuildOrientedClipList(const PointContour& polygonPoints, const PointContour& clipRegion, ClipVertexList& polyList, ClipVertexList& clipRegionList);
+  // Traces clipped clockwise lists, such as those from BuildOrientedClipList, or emits the operands when they
+  // don't cross.
+  void ExecuteClipped(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, ClipVertexList& polyList, ClipVertexList& clipRegionList, ClipContourSink& sink);
+  // Runs the tracer for the operation on lists that were already clipped.
+  void Trace(ClipOperation operation, ClipVertexList& polyList, ClipVertexList& clipRegionList, ClipContourSink& sink);
+  // The result when the operands' aabbs don't overlap. Union and xor keep both operands and subtract keeps the polygon.
+  void ExecuteDisjoint(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, const ClipOptions& options, PointContourList& contours);
+  // Appends the region the fill rule covers for a single operand, wound as the options ask.
+  void AppendFilled(const PointContour& points, const ClipOptions& options, PointContourList& contours);
+
+  // Subtracts every cutter from the polygon with one intersection phase and one trace, instead of re-clipping the
+  // growing result once per cutter. Overlapping cutters are merged first (see MergeCutters) and every polygon edge
+  // is only tested against the cutters an aabb tree says it could touch. Cutters that don't cross the polygon but
+  // are inside of it leave holes, which come back as separate contours wound opposite to the polygon's clockwise
+  // outer contours. Like the other Weiler-Atherton operations the polygon and cutters must not self-intersect.
+  void Subtract(const PointContour& polygonPoints, const PointContourList& cutters, PointContourList& contours);
+  // Unions each group of overlapping cutters so the resulting pieces never overlap. Outer pieces wind clockwise
+  // and any holes left in a group wind counter-clockwise.
+  void MergeCutters(const PointContourList& cutters, Array<ClipVertexList>& pieces);
+
+  // Clips the polygon against an analytic shape (see ClipShape). A shape strictly inside the polygon
+  // leaves a hole which comes back as a separate contour wound opposite to the polygon.
+  void Subtract(const PointContour& polygonPoints, const ClipShape& clipShape, const ClipShapeOptions& options, PointContourList& contours);
+  void Intersect(const PointContour& polygonPoints, const ClipShape& clipShape, const ClipShapeOptions& options, PointContourList& contours);
+
+  // Predicate queries. These only run the intersection phase and stop at the first edge contact found,
+  // falling back to an aabb and single point-in-polygon test when there is none. No vertex lists are built.
+  // Do the two polygons share any point (boundaries or interiors)?
+  bool Intersects(const PointContour& polygonPoints, const PointContour& clipRegion);
+  // Is the clip region entirely within the polygon? Boundaries are allowed to touch.
+  bool Contains(const PointContour& polygonPoints, const PointContour& clipRegion);
+  // Do the boundaries meet without the interiors overlapping?
+  bool Touches(const PointContour& polygonPoints, const PointContour& clipRegion);
+  bool Disjoint(const PointContour& polygonPoints, const PointContour& clipRegion);
+
+  // Finds the first contact between the edges of the two polygons. The search stops as soon as a contact
+  // at least as strong as stopAt is found, otherwise the strongest contact found is returned.
+  EdgeContact FindFirstContact(const PointContour& polygonPoints, const PointContour& clipRegion, EdgeContact stopAt);
+
+  // Clears the contours, the provenance and the attribute channels' output before an operation writes its results.
+  void ClearOutput(PointContourList& contours);
+  // Reverses every output contour along with its provenance and attributes.
+  void ReverseOutput(PointContourList& contours);
+  // Simplifies the output contours and drops the provenance and attributes of the vertices that were removed.
+  void SimplifyOutput(ContourSimplifier& simplifier, PointContourList& contours);
+
+  // If set, the operations that return a PointContourList record where each output vertex came from, parallel to
+  // the contours. Intersection vertices are found on both operands and report the one they were traced along.
+  // Only the Weiler-Atherton traces record sources, so it's left empty by ComputeAll, the shape operations and
+  // whenever Execute picks another engine. Normalized pieces and merged cutters report edges of the piece rather than of the input.
+  ClipProvenance* mProvenance = nullptr;
+  // Attributes to interpolate onto the output of the same operations that record provenance. The channels are
+  // owned by the caller and their outputs are parallel to the contours.
+  Array<ClipAttributeChannelBase*> mAttributeChannels;
+  // If set, the Weiler-Atherton traces clean their contours as they're emitted (see CleanupContourSink). Provenance
+  // and attributes are only recorded for the vertices that are kept.
+  const ClipCleanupOptions* mCleanup = nullptr;
+
+  // Makes room for operations of up to maxVertices vertices, counting the intersections, so they run without
+  // allocating. The operations on points reuse the same buffers and vertices from call to call, which keeps
+  // growing them as needed even without this.
+  void Reserve(size_t maxVertices);
+  // Frees the scratch buffers.
+  void ShrinkToFit();
+
+  // Scratch state owned by the clipper so it's reused across calls. The operations on points build their lists
+  // from the pool, while lists passed in by the caller keep allocating their own vertices. A clipper can't be used
+  // from several threads at once or from inside one of its own sinks.
+  ClipVertexPool mVertexPool;
+  Array<ClipEdgeIntersection> mEdgeIntersections;
+  Array<ClipVertex*> mVerticesToVisit;
+  Array<size_t> mContourLengths;
+  // Number of threads for the intersection phase of a single Weiler-Atherton operation (see ClipPolygonParallel).
+  // Zero uses the hardware concurrency. The parallel path tests the clip region's original edges rather than the
+  // pieces already split by earlier crossings, so results don't depend on the thread count but can differ from
+  // the serial path's in the last bits where crossings are very close together.
+  size_t mThreadCount = 1;
 };
@@ -0,0 +1,258 @@
+#include "ContourSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+static float DistanceSqToSegment(const Vec2& point, const Vec2& start, const Vec2& end)
+{
+  Vec2 direction = end - start;
+  float lengthSq = Vec2::Dot(direction, direction);
+  float t = lengthSq > 0 ? Vec2::Dot(point - start, direction) / lengthSq : 0.0f;
+  t = std::max(0.0f, std::min(1.0f, t));
+  return Vec2::DistanceSq(point, start + direction * t);
+}
+
+// Keeps the entries of an optional array parallel to the points where keep is set.
+static void CompactIndices(Array<size_t>* indices, const Array<bool>& keep)
+{
+  if(indices == nullptr)
+    return;
+  size_t kept = 0;
+  for(size_t i = 0; i < keep.size(); ++i)
+  {
+    if(keep[i])
+      (*indices)[kept++] = (*indices)[i];
+  }
+  indices->resize(kept);
+}
+
+//-------------------------------------------------------------------ContourSimplifier
+void ContourSimplifier::Simplify(PointContour& contour, Array<size_t>* indices)
+{
+  mStats.mInputVertexCount += contour.size();
+  RemoveRedundantPoints(contour, mDuplicateEpsilon, mCollinearTolerance, &mStats.mDuplicatesRemoved, &mStats.mCollinearRemoved, indices);
+  if(mTolerance <= 0)
+    return;
+
+  if(mMethod == SimplifyMethod::DouglasPeucker)
+    mStats.mSimplifiedRemoved += SimplifyDouglasPeucker(contour, mTolerance, indices);
+  else if(mMethod == SimplifyMethod::VisvalingamWhyatt)
+    mStats.mSimplifiedRemoved += SimplifyVisvalingamWhyatt(contour, mTolerance, indices);
+}
+
+void ContourSimplifier::Simplify(PointContourList& contours, Array<size_t>* keptIndices)
+{
+  if(keptIndices != nullptr)
+    keptIndices->clear();
+  Array<size_t> indices;
+  size_t firstIndex = 0;
+  size_t kept = 0;
+  for(size_t i = 0; i < contours.size(); ++i)
+  {
+    if(keptIndices != nullptr)
+    {
+      indices.resize(contours[i].size());
+      for(size_t j = 0; j < indices.size(); ++j)
+        indices[j] = firstIndex + j;
+      firstIndex += indices.size();
+    }
+    Simplify(contours[i], keptIndices != nullptr ? &indices : nullptr);
+    if(contours[i].size() < 3)
+      continue;
+    if(keptIndices != nullptr)
+      keptIndices->insert(keptIndices->end(), indices.begin(), indices.end());
+    if(kept != i)
+      contours[kept].swap(contours[i]);
+    ++kept;
+  }
+  contours.resize(kept);
+}
+
+void ContourSimplifier::RemoveRedundantPoints(PointContour& contour, float epsilon, float collinearTolerance, size_t* duplicatesRemoved, size_t* collinearRemoved, Array<size_t>* indices)
+{
+  size_t duplicates = 0;
+  size_t collinear = 0;
+  float epsilonSq = epsilon * epsilon;
+  PointContour result;
+  // Which input point each result point came from.
+  Array<size_t> sources;
+  for(size_t i = 0; i < contour.size(); ++i)
+  {
+    const Vec2& point = contour[i];
+    if(!result.empty() && Vec2::DistanceSq(result.back(), point) <= epsilonSq)
+    {
+      ++duplicates;
+      continue;
+    }
+    while(result.size() >= 2 && IsCollinear(result[result.size() - 2], result.back(), point, collinearTolerance))
+    {
+      result.pop_back();
+      sources.pop_back();
+      ++collinear;
+    }
+    result.push_back(point);
+    sources.push_back(i);
+  }
+  // The start of the loop can also be a duplicate or in the middle of a straight run
+  while(result.size() >= 3)
+  {
+    if(Vec2::DistanceSq(result.back(), result[0]) <= epsilonSq)
+      ++duplicates;
+    else if(IsCollinear(result[result.size() - 2], result.back(), result[0], collinearTolerance))
+      ++collinear;
+    else
+      break;
+    result.pop_back();
+    sources.pop_back();
+  }
+  size_t start = 0;
+  while(result.size() - start >= 3 && IsCollinear(result.back(), result[start], result[start + 1], collinearTolerance))
+  {
+    ++start;
+    ++collinear;
+  }
+  result.erase(result.begin(), result.begin() + start);
+  contour.swap(result);
+
+  if(indices != nullptr)
+  {
+    for(size_t i = start; i < sources.size(); ++i)
+      (*indices)[i - start] = (*indices)[sources[i]];
+    indices->resize(sources.size() - start);
+  }
+
+  if(duplicatesRemoved != nullptr)
+    *duplicatesRemoved += duplicates;
+  if(collinearRemoved != nullptr)
+    *collinearRemoved += collinear;
+}
+
+size_t ContourSimplifier::SimplifyDouglasPeucker(PointContour& contour, float tolerance, Array<size_t>* indices)
+{
+  size_t count = contour.size();
+  if(count <= 3)
+    return 0;
+
+  // A closed contour has no natural end points, so split it at the first point and the point furthest from it.
+  size_t furthest = 0;
+  float furthestDistanceSq = -1;
+  for(size_t i = 1; i < count; ++i)
+  {
+    float distanceSq = Vec2::DistanceSq(contour[0], contour[i]);
+    if(distanceSq > furthestDistanceSq)
+    {
+      furthest = i;
+      furthestDistanceSq = distanceSq;
+    }
+  }
+
+  // Ranges are over the unwrapped indices, where count is the first point again.
+  Array<bool> keep(count, false);
+  keep[0] = true;
+  keep[furthest] = true;
+  float toleranceSq = tolerance * tolerance;
+  Array<std::pair<size_t, size_t>> stack{{0, furthest}, {furthest, count}};
+  while(!stack.empty())
+  {
+    size_t start = stack.back().first;
+    size_t end = stack.back().second;
+    stack.pop_back();
+
+    const Vec2& startPoint = contour[start];
+    const Vec2& endPoint = contour[end % count];
+    size_t split = start;
+    float maxDistanceSq = toleranceSq;
+    for(size_t i = start + 1; i < end; ++i)
+    {
+      float distanceSq = DistanceSqToSegment(contour[i], startPoint, endPoint);
+      if(distanceSq > maxDistanceSq)
+      {
+        split = i;
+        maxDistanceSq = distanceSq;
+      }
+    }
+    if(split == start)
+      continue;
+
+    keep[split] = true;
+    stack.push_back({start, split});
+    stack.push_back({split, end});
+  }
+
+  size_t kept = 0;
+  for(size_t i = 0; i < count; ++i)
+  {
+    if(keep[i])
+      contour[kept++] = contour[i];
+  }
+  contour.resize(kept);
+  CompactIndices(indices, keep);
+  return count - kept;
+}
+
+size_t ContourSimplifier::SimplifyVisvalingamWhyatt(PointContour& contour, float minArea, Array<size_t>* indices)
+{
+  size_t count = contour.size();
+  if(count <= 3)
+    return 0;
+
+  Array<size_t> prev(count);
+  Array<size_t> next(count);
+  Array<float> areas(count);
+  Array<bool> removed(count, false);
+  auto computeArea = [&](size_t i)
+  {
+    return std::abs(SignedArea(contour[prev[i]], contour[i], contour[next[i]])) * 0.5f;
+  };
+
+  // Min-heap of (area, index). Entries go stale when a neighbor is removed and are skipped when popped.
+  typedef std::pair<float, size_t> Entry;
+  std::priority_queue<Entry, Array<Entry>, std::greater<Entry>> heap;
+  for(size_t i = 0; i < count; ++i)
+  {
+    prev[i] = (i + count - 1) % count;
+    next[i] = (i + 1) % count;
+  }
+  for(size_t i = 0; i < count; ++i)
+  {
+    areas[i] = computeArea(i);
+    heap.push({areas[i], i});
+  }
+
+  size_t remaining = count;
+  while(remaining > 3 && !heap.empty())
+  {
+    Entry entry = heap.top();
+    heap.pop();
+    size_t index = entry.second;
+    if(removed[index] || entry.first != areas[index])
+      continue;
+    if(entry.first >= minArea)
+      break;
+
+    removed[index] = true;
+    --remaining;
+    size_t before = prev[index];
+    size_t after = next[index];
+    next[before] = after;
+    prev[after] = before;
+    // A neighbor's area can't drop below the removed point's, otherwise the removal order depends on ties.
+    areas[before] = std::max(computeArea(before), entry.first);
+    areas[after] = std::max(computeArea(after), entry.first);
+    heap.push({areas[before], before});
+    heap.push({areas[after], after});
+  }
+
+  Array<bool> keep(count);
+  size_t kept = 0;
+  for(size_t i = 0; i < count; ++i)
+  {
+    keep[i] = !removed[i];
+    if(keep[i])
+      contour[kept++] = contour[i];
+  }
+  contour.resize(kept);
+  CompactIndices(indices, keep);
+  return count - kept;
+}
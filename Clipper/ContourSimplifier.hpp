@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+enum class SimplifyMethod
+{
+  // Only removes duplicate and collinear points.
+  None,
+  // Keeps the point furthest from the chord between two kept points until every removed point is within the
+  // tolerance (a distance) of the simplified outline.
+  DouglasPeucker,
+  // Repeatedly removes the point whose triangle with its neighbors has the smallest area, until every remaining
+  // triangle is at least the tolerance (an area).
+  VisvalingamWhyatt
+};
+
+//-------------------------------------------------------------------ContourSimplifierStats
+// Counts accumulated over every contour simplified since the last reset.
+struct ContourSimplifierStats
+{
+  size_t GetRemovedCount() const { return mDuplicatesRemoved + mCollinearRemoved + mSimplifiedRemoved; }
+
+  size_t mInputVertexCount = 0;
+  size_t mDuplicatesRemoved = 0;
+  size_t mCollinearRemoved = 0;
+  size_t mSimplifiedRemoved = 0;
+};
+
+//-------------------------------------------------------------------ContourSimplifier
+// Reduces the vertex count of closed contours. This can run on inputs before they're clipped, where every removed
+// vertex saves a pass over the other operand, and on traced results (see ClipOptions::mSimplifyInput and
+// mSimplifyOutput). Simplifying doesn't look at other edges, so a large tolerance can make a contour touch itself.
+struct ContourSimplifier
+{
+  // Simplifies a single contour in place. It can collapse below three points. Points are only ever removed, so
+  // the ones left are in their original order. If given, indices holds a value per point and loses the same ones.
+  void Simplify(PointContour& contour, Array<size_t>* indices = nullptr);
+  // Simplifies every contour and drops the ones that collapsed. If given, keptIndices receives the index of every
+  // point left among all of the input points, counted contour by contour, so data kept parallel to the points
+  // (such as ClipProvenance) can be compacted to match.
+  void Simplify(PointContourList& contours, Array<size_t>* keptIndices = nullptr);
+  void ResetStats() { mStats = ContourSimplifierStats(); }
+
+  // Removes points within epsilon of the previous kept point and points in the middle of straight runs (see
+  // IsCollinear), including where the loop wraps around. Adds the duplicate and collinear counts to the optional
+  // pointers. Like the other steps, an optional indices array parallel to the points loses the same entries.
+  static void RemoveRedundantPoints(PointContour& contour, float epsilon, float collinearTolerance, size_t* duplicatesRemoved = nullptr, size_t* collinearRemoved = nullptr, Array<size_t>* indices = nullptr);
+  // Both return the number of points removed.
+  static size_t SimplifyDouglasPeucker(PointContour& contour, float tolerance, Array<size_t>* indices = nullptr);
+  static size_t SimplifyVisvalingamWhyatt(PointContour& contour, float minArea, Array<size_t>* indices = nullptr);
+
+  SimplifyMethod mMethod = SimplifyMethod::DouglasPeucker;
+  // A distance for Douglas-Peucker and an area for Visvalingam-Whyatt. Zero only removes redundant points.
+  float mTolerance = 0;
+  // Points this close to the previous one count as duplicates.
+  float mDuplicateEpsilon = 0;
+  float mCollinearTolerance = 1e-5f;
+  ContourSimplifierStats mStats;
+};
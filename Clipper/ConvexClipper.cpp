@@ -0,0 +1,80 @@
+#include "ConvexClipper.hpp"
+
+#include <algorithm>
+
+//-------------------------------------------------------------------ConvexClipper
+template <typename Distance>
+void ConvexClipper::ClipAgainstPlane(const PointContour& input, Distance distance, PointContour& output)
+{
+  output.clear();
+  size_t count = input.size();
+  if(count == 0)
+    return;
+
+  const Vec2* prev = &input[count - 1];
+  float prevDistance = distance(*prev);
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& current = input[i];
+    float currentDistance = distance(current);
+    // Points exactly on the plane count as inside. Only add a crossing point when the edge strictly changes side,
+    // otherwise the on-plane point was (or will be) added itself.
+    if(currentDistance >= 0)
+    {
+      if(prevDistance < 0)
+        output.push_back(*prev + (current - *prev) * (prevDistance / (prevDistance - currentDistance)));
+      output.push_back(current);
+    }
+    else if(prevDistance > 0)
+      output.push_back(*prev + (current - *prev) * (prevDistance / (prevDistance - currentDistance)));
+    prev = &current;
+    prevDistance = currentDistance;
+  }
+}
+
+void ConvexClipper::Finalize(PointContour& result)
+{
+  // Anything that collapsed to a line or point has no area left.
+  if(result.size() < 3 || ComputeSignedArea(result) == 0)
+    result.clear();
+}
+
+void ConvexClipper::Intersect(const PointContour& polygonPoints, const PointContour& convexRegion, PointContour& result)
+{
+  result = polygonPoints;
+  // The inside of each edge is to the left for counter-clockwise regions and to the right for clockwise ones.
+  float orientation = ComputeSignedArea(convexRegion) < 0 ? -1.0f : 1.0f;
+  size_t count = convexRegion.size();
+  for(size_t i = 0; i < count && !result.empty(); ++i)
+  {
+    const Vec2& start = convexRegion[i];
+    const Vec2& end = convexRegion[(i + 1) % count];
+    Vec2 edge = end - start;
+    if(edge.x == 0 && edge.y == 0)
+      continue;
+
+    auto distance = [&](const Vec2& point) { return orientation * Cross2d(edge, point - start); };
+    ClipAgainstPlane(result, distance, mScratch);
+    std::swap(result, mScratch);
+  }
+  Finalize(result);
+}
+
+void ConvexClipper::Intersect(const PointContour& polygonPoints, const Aabb& rectangle, PointContour& result)
+{
+  result = polygonPoints;
+  Vec2 min = rectangle.mMin;
+  Vec2 max = rectangle.mMax;
+  ClipAgainstPlane(result, [&](const Vec2& point) { return point.x - min.x; }, mScratch);
+  ClipAgainstPlane(mScratch, [&](const Vec2& point) { return max.x - point.x; }, result);
+  ClipAgainstPlane(result, [&](const Vec2& point) { return point.y - min.y; }, mScratch);
+  ClipAgainstPlane(mScratch, [&](const Vec2& point) { return max.y - point.y; }, result);
+  // Interpolated crossing points can land a rounding error outside of the rectangle. Every point is inside in exact
+  // arithmetic, so clamping puts them on the sides exactly.
+  for(Vec2& point : result)
+  {
+    point.x = std::min(std::max(point.x, min.x), max.x);
+    point.y = std::min(std::max(point.y, min.y), max.y);
+  }
+  Finalize(result);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+//-------------------------------------------------------------------ConvexClipper
+// Sutherland-Hodgman clipping. The polygon is clipped against one half-plane per edge of a convex region, so the
+// cost is O(n * m) with a tiny constant and no allocations beyond the two ping-pong buffers. The result is exact
+// when the polygon is convex as well, a concave polygon can come back as one contour with zero width bridges.
+struct ConvexClipper
+{
+  // Intersects the polygon with a convex region of either winding. The result follows the polygon's winding.
+  void Intersect(const PointContour& polygonPoints, const PointContour& convexRegion, PointContour& result);
+  // Intersects the polygon with an axis aligned rectangle.
+  void Intersect(const PointContour& polygonPoints, const Aabb& rectangle, PointContour& result);
+
+private:
+  // Keeps the part of the input where the distance is non-negative.
+  template <typename Distance>
+  static void ClipAgainstPlane(const PointContour& input, Distance distance, PointContour& output);
+  static void Finalize(PointContour& result);
+
+  PointContour mScratch;
+};
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+enum class ClipStatus
+{
+  Success,
+  // The operands and their crossings needed more vertices than the clipper holds. Nothing was output.
+  VertexOverflow,
+  // The results didn't fit in the output. The contours up to the one that overflowed were kept.
+  OutputOverflow
+};
+
+//-------------------------------------------------------------------FixedContourList
+// Contours stored inline, one after another, for the results of a FixedClipper. Running out of room sets a flag
+// rather than allocating, and the contour that didn't fit is dropped.
+template <size_t Capacity>
+struct FixedContourList : public ClipContourSink
+{
+  void BeginContour() override
+  {
+    if(mContourCount == Capacity)
+      mOverflowed = true;
+    if(mOverflowed)
+      return;
+    mContourStarts[mContourCount++] = mPointCount;
+  }
+  void AddVertex(const ClipVertex& vertex) override
+  {
+    if(mPointCount == Capacity)
+    {
+      // Roll back to the end of the last whole contour.
+      mOverflowed = true;
+      mPointCount = mContourStarts[--mContourCount];
+    }
+    if(mOverflowed)
+      return;
+    mPoints[mPointCount++] = vertex.mPoint;
+  }
+  void EndContour() override {}
+
+  void Clear()
+  {
+    mPointCount = 0;
+    mContourCount = 0;
+    mOverflowed = false;
+  }
+  size_t GetContourCount() const { return mContourCount; }
+  const Vec2* GetContourPoints(size_t contourIndex) const { return mPoints + mContourStarts[contourIndex]; }
+  size_t GetContourSize(size_t contourIndex) const
+  {
+    size_t end = contourIndex + 1 < mContourCount ? mContourStarts[contourIndex + 1] : mPointCount;
+    return end - mContourStarts[contourIndex];
+  }
+
+  Vec2 mPoints[Capacity];
+  size_t mContourStarts[Capacity];
+  size_t mPointCount = 0;
+  size_t mContourCount = 0;
+  bool mOverflowed = false;
+};
+
+//-------------------------------------------------------------------FixedClipper
+// The Weiler-Atherton operations for small polygons on threads that can't allocate. The vertex lists, the
+// intersections of an edge and the output are all stored inline, so nothing is allocated at any point and the
+// operations report an overflow instead when the capacity is exceeded. The capacity bounds the vertices of both
+// operands plus two per crossing, and separately the points of the output. Like Clipper::Execute with a sink,
+// operands of either winding are accepted, results wind clockwise with counter-clockwise holes and operands that
+// don't cross are handled by containment. The operands must not self-intersect.
+template <size_t Capacity>
+struct FixedClipper
+{
+  ClipStatus Execute(ClipOperation operation, const Vec2* polygonPoints, size_t polygonCount, const Vec2* clipRegion, size_t clipRegionCount, FixedContourList<Capacity>& results);
+  ClipStatus Execute(ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, FixedContourList<Capacity>& results)
+  {
+    return Execute(operation, polygonPoints.data(), polygonPoints.size(), clipRegion.data(), clipRegion.size(), results);
+  }
+
+private:
+  // Links the points into a clockwise loop of inline vertices. Returns null if they don't fit.
+  ClipVertex* BuildVertexList(const Vec2* points, size_t count, ClipOperand operand);
+  // Inserts the crossings into both lists, as Clipper::ClipPolygon does. Returns false if they don't fit.
+  bool ClipPolygon(ClipVertex* polygon, ClipVertex* clipRegion);
+  void ClassifyVertices(ClipVertex* head);
+  // The tracers don't need a stack of contour starts: every contour of a difference leaves the clip region
+  // somewhere along the polygon and every contour of an intersection enters it, so each of those crossings that
+  // hasn't been visited yet starts a new contour. Unions use TraceUnion, which doesn't allocate either.
+  void Subtract(ClipVertex* polygon, ClipContourSink& sink);
+  void Intersect(ClipVertex* polygon, ClipContourSink& sink);
+  void ResetVisited(ClipVertex* head);
+
+  ClipVertex mVertices[Capacity];
+  size_t mVertexCount = 0;
+  ClipEdgeIntersection mIntersections[Capacity];
+};
+
+template <size_t Capacity>
+ClipStatus FixedClipper<Capacity>::Execute(ClipOperation operation, const Vec2* polygonPoints, size_t polygonCount, const Vec2* clipRegion, size_t clipRegionCount, FixedContourList<Capacity>& results)
+{
+  results.Clear();
+  mVertexCount = 0;
+  if(polygonCount < 3 || clipRegionCount < 3)
+    return ClipStatus::Success;
+
+  ClipVertex* polygon = BuildVertexList(polygonPoints, polygonCount, ClipOperand::Polygon);
+  ClipVertex* clip = BuildVertexList(clipRegion, clipRegionCount, ClipOperand::ClipRegion);
+  if(polygon == nullptr || clip == nullptr || !ClipPolygon(polygon, clip))
+    return ClipStatus::VertexOverflow;
+  ClassifyVertices(polygon);
+  ClassifyVertices(clip);
+
+  if(ClipVertex::FindFirstIntersection(polygon) != nullptr)
+  {
+    switch(operation)
+    {
+      case ClipOperation::Union:
+        TraceUnion(polygon, results);
+        break;
+      case ClipOperation::Subtract:
+        Subtract(polygon, results);
+        break;
+      case ClipOperation::Intersect:
+        Intersect(polygon, results);
+        break;
+      case ClipOperation::Xor:
+        Subtract(polygon, results);
+        ResetVisited(polygon);
+        ResetVisited(clip);
+        Subtract(clip, results);
+        break;
+    }
+    return results.mOverflowed ? ClipStatus::OutputOverflow : ClipStatus::Success;
+  }
+
+  EmitUncrossed(operation, polygonPoints, polygonCount, clipRegion, clipRegionCount, results);
+  return results.mOverflowed ? ClipStatus::OutputOverflow : ClipStatus::Success;
+}
+
+template <size_t Capacity>
+ClipVertex* FixedClipper<Capacity>::BuildVertexList(const Vec2* points, size_t count, ClipOperand operand)
+{
+  if(Capacity - mVertexCount < count)
+    return nullptr;
+
+  ClipVertex* vertices = mVertices + mVertexCount;
+  mVertexCount += count;
+  // Counter-clockwise points are linked backwards.
+  bool reversed = ComputeSignedArea(points, count) > 0;
+  for(size_t i = 0; i < count; ++i)
+  {
+    ClipVertex& vertex = vertices[i];
+    vertex = ClipVertex();
+    vertex.mPoint = points[i];
+    vertex.mSource.mOperand = operand;
+    vertex.mSource.mEdgeIndex = i;
+    ClipVertex* next = &vertices[(i + 1) % count];
+    ClipVertex* prev = &vertices[(i + count - 1) % count];
+    vertex.mNext = reversed ? prev : next;
+    vertex.mPrev = reversed ? next : prev;
+  }
+  return vertices;
+}
+
+template <size_t Capacity>
+bool FixedClipper<Capacity>::ClipPolygon(ClipVertex* polygon, ClipVertex* clipRegion)
+{
+  bool fits = true;
+  ClipVertex::Traverse(polygon, [&](ClipVertex* start, ClipVertex*& nextVertex)
+  {
+    ClipVertex* end = start->mNext;
+    size_t intersectionCount = 0;
+    ClipVertex* clipStart = clipRegion;
+    do
+    {
+      ClipVertex* clipNext = clipStart->mNext;
+      ClipVertexClassification line0Flags, line1Flags;
+      float clipTime;
+      float time = ComputeIntersectionPoint(start->mPoint, end->mPoint, clipStart->mPoint, clipNext->mPoint, line0Flags, line1Flags, clipTime);
+      if(0 <= time && time <= 1)
+      {
+        if(Capacity - mVertexCount < 2)
+        {
+          fits = false;
+          return false;
+        }
+        ClipVertex* clipVert = &mVertices[mVertexCount++];
+        ClipVertex* edgeVert = &mVertices[mVertexCount++];
+        *clipVert = ClipVertex();
+        clipVert->mPoint = start->mPoint + (end->mPoint - start->mPoint) * time;
+        clipVert->mClassification = line1Flags;
+        clipVert->mSource = ComputeSource(clipStart, clipNext, clipTime);
+        clipStart->mNext = clipVert;
+        clipVert->mPrev = clipStart;
+        clipVert->mNext = clipNext;
+        clipNext->mPrev = clipVert;
+
+        *edgeVert = ClipVertex();
+        edgeVert->mPoint = clipVert->mPoint;
+        edgeVert->mClassification = line0Flags;
+        edgeVert->mSource = ComputeSource(start, end, time);
+        clipVert->mTwin = edgeVert;
+        edgeVert->mTwin = clipVert;
+        // Every crossing took two vertices, so there's always room for its entry here.
+        mIntersections[intersectionCount].mVertex = edgeVert;
+        mIntersections[intersectionCount].mTime = time;
+        ++intersectionCount;
+      }
+      clipStart = clipNext;
+    } while(clipStart != clipRegion);
+
+    std::sort(mIntersections, mIntersections + intersectionCount, [](const ClipEdgeIntersection& lhs, const ClipEdgeIntersection& rhs)
+    {
+      return lhs.mTime < rhs.mTime;
+    });
+    ClipVertex* prevVertex = start;
+    for(size_t i = 0; i < intersectionCount; ++i)
+    {
+      ClipVertex* newVertex = mIntersections[i].mVertex;
+      newVertex->mPrev = prevVertex;
+      prevVertex->mNext = newVertex;
+      prevVertex = newVertex;
+    }
+    prevVertex->mNext = end;
+    end->mPrev = prevVertex;
+    return true;
+  });
+  return fits;
+}
+
+template <size_t Capacity>
+void FixedClipper<Capacity>::ClassifyVertices(ClipVertex* head)
+{
+  ClipVertex* firstIntersection = ClipVertex::FindFirstIntersection(head);
+  if(firstIntersection == nullptr)
+    return;
+
+  ClipVertexClassification flags = firstIntersection->mClassification == ClipVertexClassification::InToOut ? ClipVertexClassification::Outside : ClipVertexClassification::Inside;
+  ClipVertex::Traverse(firstIntersection, [&flags](ClipVertex* v, ClipVertex*& nextVertex)
+  {
+    if(v->mClassification == ClipVertexClassification::None)
+      v->mClassification = flags;
+    else if(v->mClassification == ClipVertexClassification::InToOut)
+      flags = ClipVertexClassification::Outside;
+    else if(v->mClassification == ClipVertexClassification::OutToIn)
+      flags = ClipVertexClassification::Inside;
+    return true;
+  });
+}
+
+template <size_t Capacity>
+void FixedClipper<Capacity>::Subtract(ClipVertex* polygon, ClipContourSink& sink)
+{
+  ClipVertex::Traverse(polygon, [&sink](ClipVertex* contourStart, ClipVertex*& nextVertex)
+  {
+    if(contourStart->mClassification != ClipVertexClassification::InToOut || contourStart->mVisited)
+      return true;
+
+    ClipVertex* vertex = contourStart;
+    ClipVertexSearchDirection direction = ClipVertexSearchDirection::Forwards;
+    sink.BeginContour();
+    do
+    {
+      sink.AddVertex(*vertex);
+      vertex->mVisited = true;
+      vertex = vertex->GetNext(direction);
+      if(vertex->mTwin != nullptr)
+      {
+        direction = FlipSearchDirection(direction);
+        vertex = vertex->mTwin;
+      }
+    } while(vertex != contourStart && vertex->mTwin != contourStart);
+    sink.EndContour();
+    return true;
+  });
+}
+
+template <size_t Capacity>
+void FixedClipper<Capacity>::Intersect(ClipVertex* polygon, ClipContourSink& sink)
+{
+  ClipVertex::Traverse(polygon, [&sink](ClipVertex* contourStart, ClipVertex*& nextVertex)
+  {
+    if(contourStart->mClassification != ClipVertexClassification::OutToIn || contourStart->mVisited)
+      return true;
+
+    ClipVertex* vertex = contourStart;
+    sink.BeginContour();
+    do
+    {
+      sink.AddVertex(*vertex);
+      vertex->mVisited = true;
+      vertex = vertex->mNext;
+      if(vertex->mClassification == ClipVertexClassification::InToOut)
+        vertex = vertex->mTwin;
+    } while(vertex != contourStart && vertex->mTwin != contourStart);
+    sink.EndContour();
+    return true;
+  });
+}
+
+template <size_t Capacity>
+void FixedClipper<Capacity>::ResetVisited(ClipVertex* head)
+{
+  ClipVertex::Traverse(head, [](ClipVertex* vertex, ClipVertex*& nextVertex)
+  {
+    vertex->mVisited = false;
+    return true;
+  });
+}
@@ -0,0 +1,124 @@
+#include "InterleavedContourSink.hpp"
+
+#include <cstring>
+
+//-------------------------------------------------------------------InterleavedContourSink
+void InterleavedContourSink::BeginContour()
+{
+  mContourStart = mVertexCount;
+  mContourCount = 0;
+}
+
+void InterleavedContourSink::AddVertex(const ClipVertex& vertex)
+{
+  size_t index = mContourStart + mContourCount;
+  ++mContourCount;
+  // Only the first contour that doesn't fit is cut short, every later one is just counted.
+  if(index < mVertexCapacity && !HasOverflowed())
+    WriteVertex(index, vertex.mPoint, vertex.mSource);
+}
+
+void InterleavedContourSink::EndContour()
+{
+  if(mContourCount == 0)
+    return;
+
+  // 16-bit indices can't address the end of a large buffer. The contour is checked where it would go in buffers of
+  // the required size, as bigger buffers wouldn't help.
+  if(mLayout.mIndexType == ClipIndexType::UInt16 && mRequiredVertexCount + mContourCount > size_t(UINT16_MAX) + 1)
+  {
+    mIndexRangeExceeded = true;
+    return;
+  }
+
+  size_t indexCount = ComputeIndexCount(mContourCount);
+  bool fits = !HasOverflowed() && mContourStart + mContourCount <= mVertexCapacity && mIndexCount + indexCount <= mIndexCapacity;
+  mRequiredVertexCount += mContourCount;
+  mRequiredIndexCount += indexCount;
+  if(!fits)
+    return;
+
+  ClipDrawRange range;
+  range.mFirstVertex = mContourStart;
+  range.mVertexCount = mContourCount;
+  range.mFirstIndex = mIndexCount;
+  range.mIndexCount = indexCount;
+  mDrawRanges.push_back(range);
+
+  for(size_t i = 0; i < mContourCount; ++i)
+  {
+    if(mLayout.mTopology == ClipLineTopology::LineLoop)
+      WriteIndex(mIndexCount++, mContourStart + i);
+    else
+    {
+      WriteIndex(mIndexCount++, mContourStart + i);
+      WriteIndex(mIndexCount++, mContourStart + (i + 1) % mContourCount);
+    }
+  }
+  mVertexCount += mContourCount;
+}
+
+void InterleavedContourSink::Write(const PointContourList& contours, const ClipProvenance* provenance)
+{
+  ClipVertex vertex;
+  for(size_t i = 0; i < contours.size(); ++i)
+  {
+    const PointContour& contour = contours[i];
+    bool hasSources = provenance != nullptr && i < provenance->GetContourCount() &&
+      provenance->GetContourEnd(i) - provenance->GetContourBegin(i) == contour.size();
+    BeginContour();
+    for(size_t j = 0; j < contour.size(); ++j)
+    {
+      vertex.mPoint = contour[j];
+      if(hasSources)
+        vertex.mSource = provenance->mSources[provenance->GetContourBegin(i) + j];
+      else
+      {
+        vertex.mSource = ClipVertexSource();
+        vertex.mSource.mEdgeIndex = j;
+      }
+      AddVertex(vertex);
+    }
+    EndContour();
+  }
+}
+
+void InterleavedContourSink::Reset()
+{
+  mDrawRanges.clear();
+  mContourStart = 0;
+  mContourCount = 0;
+  mVertexCount = 0;
+  mIndexCount = 0;
+  mRequiredVertexCount = 0;
+  mRequiredIndexCount = 0;
+  mIndexRangeExceeded = false;
+}
+
+void InterleavedContourSink::WriteVertex(size_t index, const Vec2& point, const ClipVertexSource& source)
+{
+  unsigned char* vertex = mVertexData + index * mLayout.mStride;
+  float position[2] = {point.x, point.y};
+  std::memcpy(vertex + mLayout.mPositionOffset, position, sizeof(position));
+  for(const ClipVertexLayout::Attribute& attribute : mLayout.mAttributes)
+    attribute.mChannel->Write(source, vertex + attribute.mOffset);
+}
+
+void InterleavedContourSink::WriteIndex(size_t index, size_t value)
+{
+  if(mLayout.mIndexType == ClipIndexType::UInt16)
+  {
+    uint16_t index16 = uint16_t(value);
+    std::memcpy(mIndexData + index * sizeof(uint16_t), &index16, sizeof(index16));
+  }
+  else
+  {
+    uint32_t index32 = uint32_t(value);
+    std::memcpy(mIndexData + index * sizeof(uint32_t), &index32, sizeof(index32));
+  }
+}
+
+size_t InterleavedContourSink::ComputeIndexCount(size_t vertexCount) const
+{
+  return mLayout.mTopology == ClipLineTopology::LineLoop ? vertexCount : vertexCount * 2;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+#include <cstdint>
+
+enum class ClipIndexType
+{
+  UInt16,
+  UInt32
+};
+
+enum class ClipLineTopology
+{
+  // One index per vertex, so each draw range is drawn as its own line loop.
+  LineLoop,
+  // Two indices per edge including the closing one, so every contour can go in a single draw.
+  LineList
+};
+
+//-------------------------------------------------------------------ClipVertexLayout
+// Where each part of an output vertex goes in an interleaved vertex buffer. Offsets are in bytes from the start of
+// the vertex and nothing has to be aligned. The position is written as two floats.
+struct ClipVertexLayout
+{
+  // Writes the channel's attribute at the vertex's source (see ClipAttributeChannelBase::Write). The channel's
+  // inputs have to be set and its values trivially copyable.
+  struct Attribute
+  {
+    const ClipAttributeChannelBase* mChannel;
+    size_t mOffset;
+  };
+
+  size_t mStride = sizeof(Vec2);
+  size_t mPositionOffset = 0;
+  Array<Attribute> mAttributes;
+  ClipIndexType mIndexType = ClipIndexType::UInt32;
+  ClipLineTopology mTopology = ClipLineTopology::LineLoop;
+};
+
+//-------------------------------------------------------------------ClipDrawRange
+// Where one contour went, in vertices and indices from the start of the caller's buffers.
+struct ClipDrawRange
+{
+  size_t mFirstVertex;
+  size_t mVertexCount;
+  size_t mFirstIndex;
+  size_t mIndexCount;
+};
+
+//-------------------------------------------------------------------InterleavedContourSink
+// Writes contours straight into caller memory laid out for the GPU, such as a mapped staging buffer, along with a
+// draw range per contour. Nothing is written past either capacity: once a contour doesn't fit the sink stops
+// writing and only counts, so the ranges cover the contours that fit and the required counts say how big the
+// buffers need to be to run the operation again. Indices are relative to the start of the vertex buffer. With 16-bit
+// indices, a contour that would reach past the first 65536 vertices can't be drawn from any buffer, so it's skipped
+// and reported by HasExceededIndexRange instead of being counted.
+struct InterleavedContourSink : public ClipContourSink
+{
+  InterleavedContourSink(const ClipVertexLayout& layout, void* vertexData, size_t vertexCapacity, void* indexData, size_t indexCapacity)
+    : mLayout(layout), mVertexData(static_cast<unsigned char*>(vertexData)), mVertexCapacity(vertexCapacity),
+    mIndexData(static_cast<unsigned char*>(indexData)), mIndexCapacity(indexCapacity) {}
+
+  void BeginContour() override;
+  void AddVertex(const ClipVertex& vertex) override;
+  void EndContour() override;
+
+  // Writes contours that were already built, such as the scanline engine's results. Their vertices have no sources,
+  // so attributes are written from each point's own index unless provenance parallel to the contours is given.
+  void Write(const PointContourList& contours, const ClipProvenance* provenance = nullptr);
+  // Starts writing from the beginning of the buffers again.
+  void Reset();
+
+  bool HasOverflowed() const { return mRequiredVertexCount > mVertexCount || mRequiredIndexCount > mIndexCount; }
+  // Whether a contour was skipped because the index type can't address it. Only 32-bit indices can draw it.
+  bool HasExceededIndexRange() const { return mIndexRangeExceeded; }
+  // The vertices and indices written, which can be copied out as a whole.
+  size_t GetVertexCount() const { return mVertexCount; }
+  size_t GetIndexCount() const { return mIndexCount; }
+  size_t GetIndexSize() const { return mLayout.mIndexType == ClipIndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t); }
+  // What every contour sent to the sink needs, whether it fit or not, except the ones the index type can't address.
+  size_t GetRequiredVertexCount() const { return mRequiredVertexCount; }
+  size_t GetRequiredIndexCount() const { return mRequiredIndexCount; }
+
+  Array<ClipDrawRange> mDrawRanges;
+
+private:
+  void WriteVertex(size_t index, const Vec2& point, const ClipVertexSource& source);
+  void WriteIndex(size_t index, size_t value);
+  size_t ComputeIndexCount(size_t vertexCount) const;
+
+  const ClipVertexLayout& mLayout;
+  unsigned char* mVertexData;
+  size_t mVertexCapacity;
+  unsigned char* mIndexData;
+  size_t mIndexCapacity;
+
+  // Vertices are written as they come in and the contour is kept or rolled back when it ends.
+  size_t mContourStart = 0;
+  size_t mContourCount = 0;
+  size_t mVertexCount = 0;
+  size_t mIndexCount = 0;
+  size_t mRequiredVertexCount = 0;
+  size_t mRequiredIndexCount = 0;
+  bool mIndexRangeExceeded = false;
+};
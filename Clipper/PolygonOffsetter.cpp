@@ -0,0 +1,179 @@
+#include "PolygonOffsetter.hpp"
+
+#include "ClipParallel.hpp"
+#include "ScanlineClipper.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static Vec2 Normalize(const Vec2& vector)
+{
+  float length = std::sqrt(Vec2::Dot(vector, vector));
+  return vector * (1.0f / length);
+}
+
+// The unit normal to the right of the edge, which points away from the filled side of a counter-clockwise contour.
+static Vec2 ComputeEdgeNormal(const Vec2& start, const Vec2& end)
+{
+  Vec2 direction = end - start;
+  return Normalize(Vec2(direction.y, -direction.x));
+}
+
+static Vec2 Rotate(const Vec2& vector, float cosAngle, float sinAngle)
+{
+  return Vec2(vector.x * cosAngle - vector.y * sinAngle, vector.x * sinAngle + vector.y * cosAngle);
+}
+
+//-------------------------------------------------------------------PolygonOffsetter
+void PolygonOffsetter::Offset(const PointContourList& contours, float delta, PointContourList& results)
+{
+  BuildRawOffsets(contours, delta, mRawOffsets);
+  Resolve(mRawOffsets, results);
+}
+
+void PolygonOffsetter::Offset(const PointContour& contour, float delta, PointContourList& results)
+{
+  Offset(PointContourList{contour}, delta, results);
+}
+
+void PolygonOffsetter::OffsetBatch(const Array<PointContourList>& batch, float delta, Array<PointContourList>& results) const
+{
+  results.clear();
+  results.resize(batch.size());
+  size_t threadCount = std::min(ResolveThreadCount(mThreadCount), std::max(batch.size(), size_t(1)));
+  Array<PointContourList> rawOffsets(threadCount);
+  ParallelFor(batch.size(), threadCount, [&](size_t index, size_t threadIndex)
+  {
+    BuildRawOffsets(batch[index], delta, rawOffsets[threadIndex]);
+    Resolve(rawOffsets[threadIndex], results[index]);
+  });
+}
+
+void PolygonOffsetter::BuildRawOffsets(const PointContourList& contours, float delta, PointContourList& rawOffsets) const
+{
+  rawOffsets.clear();
+  // The largest contour decides which winding is outer. Everything is flipped so the outer contours are
+  // counter-clockwise, which puts the filled side of every contour on its left.
+  float largestArea = 0;
+  for(const PointContour& contour : contours)
+  {
+    float area = ComputeSignedArea(contour);
+    if(std::abs(area) > std::abs(largestArea))
+      largestArea = area;
+  }
+  bool flip = largestArea < 0;
+
+  PointContour cleaned;
+  for(const PointContour& contour : contours)
+  {
+    // Zero length edges have no normal
+    cleaned.clear();
+    for(const Vec2& point : contour)
+    {
+      if(cleaned.empty() || cleaned.back() != point)
+        cleaned.push_back(point);
+    }
+    while(cleaned.size() > 1 && cleaned.back() == cleaned.front())
+      cleaned.pop_back();
+    if(cleaned.size() < 3)
+      continue;
+    if(flip)
+      std::reverse(cleaned.begin(), cleaned.end());
+
+    rawOffsets.emplace_back();
+    OffsetContour(cleaned, delta, rawOffsets.back());
+  }
+}
+
+void PolygonOffsetter::OffsetContour(const PointContour& contour, float delta, PointContour& rawOffset) const
+{
+  size_t count = contour.size();
+  Vec2 prevNormal = ComputeEdgeNormal(contour[count - 1], contour[0]);
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& point = contour[i];
+    Vec2 normal = ComputeEdgeNormal(point, contour[(i + 1) % count]);
+    // The offset edges only pull apart where the contour turns towards the offset side (or doubles back on
+    // itself). Elsewhere they overlap, and going through the vertex itself keeps the overlap's winding
+    // consistent so the union removes it.
+    float turn = Cross2d(prevNormal, normal);
+    if(turn * delta > 0 || (turn == 0 && Vec2::Dot(prevNormal, normal) < 0))
+      AddJoin(point, prevNormal, normal, delta, rawOffset);
+    else if(turn == 0)
+      rawOffset.push_back(point + normal * delta);
+    else
+    {
+      rawOffset.push_back(point + prevNormal * delta);
+      rawOffset.push_back(point);
+      rawOffset.push_back(point + normal * delta);
+    }
+    prevNormal = normal;
+  }
+}
+
+void PolygonOffsetter::AddJoin(const Vec2& point, const Vec2& normal0, const Vec2& normal1, float delta, PointContour& rawOffset) const
+{
+  float cosAngle = Vec2::Dot(normal0, normal1);
+  float sinAngle = Cross2d(normal0, normal1);
+  // Where the contour doubles back the join has to go around the front of the spike.
+  Vec2 tangent0(-normal0.y, normal0.x);
+  bool reversed = sinAngle == 0;
+  switch(mJoinType)
+  {
+    case ClipJoinType::Miter:
+    {
+      // The miter point is at delta / cos(angle / 2) along the bisector.
+      if(1 + cosAngle >= 2 / (mMiterLimit * mMiterLimit))
+      {
+        rawOffset.push_back(point + (normal0 + normal1) * (delta / (1 + cosAngle)));
+        return;
+      }
+      break;
+    }
+    case ClipJoinType::Round:
+    {
+      float radius = std::abs(delta);
+      float angle = std::atan2(sinAngle, cosAngle);
+      if(reversed)
+        angle = delta > 0 ? 3.14159265f : -3.14159265f;
+      // Each chord of angle a strays radius * (1 - cos(a / 2)) from the arc.
+      float tolerance = std::min(mArcTolerance, radius);
+      float maxStep = tolerance > 0 ? 2 * std::acos(1 - tolerance / radius) : 0.0f;
+      size_t steps = maxStep > 0 ? size_t(std::ceil(std::abs(angle) / maxStep)) : 1;
+      steps = std::max(steps, size_t(1));
+      float step = angle / float(steps);
+      float cosStep = std::cos(step);
+      float sinStep = std::sin(step);
+      Vec2 offset = normal0 * delta;
+      rawOffset.push_back(point + offset);
+      for(size_t i = 1; i < steps; ++i)
+      {
+        offset = Rotate(offset, cosStep, sinStep);
+        rawOffset.push_back(point + offset);
+      }
+      rawOffset.push_back(point + normal1 * delta);
+      return;
+    }
+    case ClipJoinType::Square:
+      break;
+  }
+
+  // Square cap: cut both offset edges where they reach delta along the bisector.
+  Vec2 bisector = reversed ? tangent0 * (delta < 0 ? -1.0f : 1.0f) : Normalize(normal0 + normal1);
+  Vec2 tangent1(-normal1.y, normal1.x);
+  float bisectorCos = Vec2::Dot(normal0, bisector);
+  float extension = std::abs(delta) * (1 - bisectorCos);
+  Vec2 direction = bisector * (delta < 0 ? -1.0f : 1.0f);
+  rawOffset.push_back(point + normal0 * delta + tangent0 * (extension / Vec2::Dot(tangent0, direction)));
+  rawOffset.push_back(point + normal1 * delta + tangent1 * (extension / Vec2::Dot(tangent1, direction)));
+}
+
+void PolygonOffsetter::Resolve(const PointContourList& rawOffsets, PointContourList& results) const
+{
+  // Loops the offset turned inside out have a negative winding, so only keeping positive windings drops them
+  // along with the holes.
+  ScanlineClipper scanline;
+  scanline.mFillRule = ClipFillRule::Positive;
+  scanline.mClockwiseOutput = mClockwiseOutput;
+  scanline.Execute(ClipOperation::Union, rawOffsets, PointContourList(), results);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+// How the offset edges are connected around vertices where they pull apart.
+enum class ClipJoinType
+{
+  // Extends both edges until they meet, squared off past the miter limit.
+  Miter,
+  // An arc around the vertex, split into chords within the arc tolerance.
+  Round,
+  // A flat cap at the offset distance from the vertex.
+  Square
+};
+
+//-------------------------------------------------------------------PolygonOffsetter
+// Inflates (positive delta) or deflates (negative delta) polygons. Every edge is pushed out along its normal, the
+// gaps at vertices are filled with joins and the raw result, which overlaps itself at concave vertices and turns
+// inside out where deflating collapses a region, is resolved with a single union through the scanline engine.
+// The outer contours are the ones wound like the largest contour and holes are wound the other way.
+struct PolygonOffsetter
+{
+  void Offset(const PointContourList& contours, float delta, PointContourList& results);
+  void Offset(const PointContour& contour, float delta, PointContourList& results);
+  // Offsets each entry of a batch (such as the regions of a navmesh layer) on its own, spread across mThreadCount
+  // threads. Each result only depends on its input so the output is the same for any thread count.
+  void OffsetBatch(const Array<PointContourList>& batch, float delta, Array<PointContourList>& results) const;
+
+  ClipJoinType mJoinType = ClipJoinType::Miter;
+  // Miters that reach further than this many deltas from their vertex are squared off instead.
+  float mMiterLimit = 2;
+  // The furthest a round join's chords may be from the true arc.
+  float mArcTolerance = 0.01f;
+  // Results wind outer contours counter-clockwise and holes clockwise. This flips both.
+  bool mClockwiseOutput = false;
+  // Threads used by OffsetBatch, where zero uses every hardware thread.
+  size_t mThreadCount = 1;
+
+private:
+  // Builds the raw offset of every contour, wound so the offset region has a positive winding.
+  void BuildRawOffsets(const PointContourList& contours, float delta, PointContourList& rawOffsets) const;
+  void OffsetContour(const PointContour& contour, float delta, PointContour& rawOffset) const;
+  void AddJoin(const Vec2& point, const Vec2& normal0, const Vec2& normal1, float delta, PointContour& rawOffset) const;
+  void Resolve(const PointContourList& rawOffsets, PointContourList& results) const;
+
+  PointContourList mRawOffsets;
+};
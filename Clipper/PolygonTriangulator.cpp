@@ -0,0 +1,520 @@
+#include "PolygonTriangulator.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+static const size_t SweepPoint = static_cast<size_t>(-1);
+
+// The sweep order. Points at the same height are ordered by x, as if the plane were rotated very slightly, so no
+// two distinct points are level.
+static bool IsAbove(const Vec2& lhs, const Vec2& rhs)
+{
+  return lhs.y > rhs.y || (lhs.y == rhs.y && lhs.x < rhs.x);
+}
+
+//-------------------------------------------------------------------TriangulatorSink
+void TriangulatorSink::BeginContour()
+{
+  mContourStarts.push_back(mVertices.size());
+}
+
+void TriangulatorSink::AddVertex(const ClipVertex& vertex)
+{
+  if(mVertices.size() > mContourStarts.back() && mVertices.back() == vertex.mPoint)
+    return;
+  mVertices.push_back(vertex.mPoint);
+}
+
+void TriangulatorSink::EndContour()
+{
+  size_t start = mContourStarts.back();
+  while(mVertices.size() > start + 1 && mVertices.back() == mVertices[start])
+    mVertices.pop_back();
+  if(mVertices.size() - start < 3)
+  {
+    mVertices.resize(start);
+    mContourStarts.pop_back();
+  }
+}
+
+//-------------------------------------------------------------------PolygonTriangulator::EdgeOrder
+bool PolygonTriangulator::EdgeOrder::operator()(size_t lhs, size_t rhs) const
+{
+  if(lhs == rhs)
+    return false;
+  float lhsX = XAt(lhs);
+  float rhsX = XAt(rhs);
+  if(lhsX != rhsX)
+    return lhsX < rhsX;
+  // The sweep point can touch an edge where contours meet. The edge is to its left if the inside around the point
+  // is to the edge's right.
+  if(lhs == SweepPoint || rhs == SweepPoint)
+  {
+    size_t edge = lhs == SweepPoint ? rhs : lhs;
+    const Vec2* points = mTriangulator->mPoints;
+    Vec2 inside = mTriangulator->ComputeInsideDirection(points, mTriangulator->mSweepVertex);
+    bool edgeIsLeft = Cross2d(points[mTriangulator->mNext[edge]] - points[edge], inside) >= 0;
+    return edgeIsLeft == (rhs == SweepPoint);
+  }
+  // Edges leaving the same point are ordered by where they go below it
+  const Vec2* points = mTriangulator->mPoints;
+  const Array<size_t>& next = mTriangulator->mNext;
+  float cross = Cross2d(points[next[lhs]] - points[lhs], points[next[rhs]] - points[rhs]);
+  if(cross != 0)
+    return cross > 0;
+  return lhs < rhs;
+}
+
+float PolygonTriangulator::EdgeOrder::XAt(size_t edge) const
+{
+  const Vec2* points = mTriangulator->mPoints;
+  const Vec2& sweepPoint = points[mTriangulator->mSweepVertex];
+  if(edge == SweepPoint)
+    return sweepPoint.x;
+
+  // Edges in the status run downwards from their start vertex
+  const Vec2& top = points[edge];
+  const Vec2& bottom = points[mTriangulator->mNext[edge]];
+  if(top.y == bottom.y)
+    return std::max(top.x, std::min(sweepPoint.x, bottom.x));
+  if(sweepPoint.y >= top.y)
+    return top.x;
+  if(sweepPoint.y <= bottom.y)
+    return bottom.x;
+  return top.x + (sweepPoint.y - top.y) * (bottom.x - top.x) / (bottom.y - top.y);
+}
+
+//-------------------------------------------------------------------PolygonTriangulator
+void PolygonTriangulator::Triangulate(const PointContourList& contours, Array<Vec2>& vertices, Array<uint32_t>& indices)
+{
+  TriangulatorSink sink(vertices);
+  ClipVertex vertex;
+  for(const PointContour& contour : contours)
+  {
+    sink.BeginContour();
+    for(const Vec2& point : contour)
+    {
+      vertex.mPoint = point;
+      sink.AddVertex(vertex);
+    }
+    sink.EndContour();
+  }
+  Triangulate(vertices, sink.mFirstVertex, sink.mContourStarts, indices);
+}
+
+void PolygonTriangulator::Triangulate(const Array<Vec2>& vertices, size_t firstVertex, const Array<size_t>& contourStarts, Array<uint32_t>& indices)
+{
+  size_t count = vertices.size() - firstVertex;
+  if(count < 3 || contourStarts.empty())
+    return;
+  mPoints = vertices.data() + firstVertex;
+  mBaseIndex = firstVertex;
+  mSeparatedPoints.clear();
+
+  // The largest contour decides which winding is outer. Everything is linked so the inside is on the left, which
+  // makes outer contours counter-clockwise.
+  float largestArea = 0;
+  for(size_t i = 0; i < contourStarts.size(); ++i)
+  {
+    size_t begin = contourStarts[i] - firstVertex;
+    size_t end = i + 1 < contourStarts.size() ? contourStarts[i + 1] - firstVertex : count;
+    float area = 0;
+    for(size_t j = begin; j < end; ++j)
+      area += Cross2d(mPoints[j], mPoints[j + 1 < end ? j + 1 : begin]);
+    if(std::abs(area) > std::abs(largestArea))
+      largestArea = area;
+  }
+  bool flip = largestArea < 0;
+
+  mNext.resize(count);
+  mPrev.resize(count);
+  mEvents.clear();
+  for(size_t i = 0; i < contourStarts.size(); ++i)
+  {
+    size_t begin = contourStarts[i] - firstVertex;
+    size_t end = i + 1 < contourStarts.size() ? contourStarts[i + 1] - firstVertex : count;
+    if(end - begin < 3)
+      continue;
+    for(size_t j = begin; j < end; ++j)
+    {
+      size_t next = j + 1 < end ? j + 1 : begin;
+      size_t prev = j > begin ? j - 1 : end - 1;
+      mNext[j] = flip ? prev : next;
+      mPrev[j] = flip ? next : prev;
+      mEvents.push_back(j);
+    }
+  }
+  SortEvents();
+  if(SeparateSharedPoints(vertices.data() + firstVertex))
+    SortEvents();
+
+  AddDiagonals(count);
+  ExtractPieces(count, indices);
+}
+
+void PolygonTriangulator::ClipAndTriangulate(Clipper& clipper, ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, Array<Vec2>& vertices, Array<uint32_t>& indices)
+{
+  TriangulatorSink sink(vertices);
+  clipper.Execute(operation, polygonPoints, clipRegion, sink);
+  Triangulate(vertices, sink.mFirstVertex, sink.mContourStarts, indices);
+}
+
+void PolygonTriangulator::SortEvents()
+{
+  std::sort(mEvents.begin(), mEvents.end(), [this](size_t lhs, size_t rhs)
+  {
+    if(mPoints[lhs] != mPoints[rhs])
+      return IsAbove(mPoints[lhs], mPoints[rhs]);
+    return lhs < rhs;
+  });
+}
+
+bool PolygonTriangulator::SeparateSharedPoints(const Vec2* points)
+{
+  // The sorted events put vertices at the same point next to each other
+  size_t eventCount = mEvents.size();
+  for(size_t i = 0; i + 1 < eventCount; ++i)
+  {
+    if(points[mEvents[i]] != points[mEvents[i + 1]])
+      continue;
+
+    if(mSeparatedPoints.empty())
+    {
+      mSeparatedPoints.assign(points, points + mNext.size());
+      mPoints = mSeparatedPoints.data();
+    }
+    size_t end = i + 1;
+    while(end < eventCount && points[mEvents[end]] == points[mEvents[i]])
+      ++end;
+    RelinkSharedPoint(points, i, end);
+    for(; i < end; ++i)
+    {
+      size_t vertex = mEvents[i];
+      const Vec2& point = points[vertex];
+      float prevLength = std::sqrt(Vec2::DistanceSq(point, points[mPrev[vertex]]));
+      float nextLength = std::sqrt(Vec2::DistanceSq(point, points[mNext[vertex]]));
+      float magnitude = std::max(std::abs(point.x), std::abs(point.y));
+      float distance = std::max(1e-4f * std::min(prevLength, nextLength), 16 * FLT_EPSILON * magnitude);
+      mSeparatedPoints[vertex] = point + ComputeInsideDirection(points, vertex) * distance;
+    }
+    --i;
+  }
+  return !mSeparatedPoints.empty();
+}
+
+void PolygonTriangulator::RelinkSharedPoint(const Vec2* points, size_t begin, size_t end)
+{
+  const Vec2& point = points[mEvents[begin]];
+  mSharedOutgoing.clear();
+  for(size_t i = begin; i < end; ++i)
+  {
+    size_t next = mNext[mEvents[i]];
+    Vec2 direction = points[next] - point;
+    mSharedOutgoing.push_back({std::atan2(direction.y, direction.x), next});
+  }
+  std::sort(mSharedOutgoing.begin(), mSharedOutgoing.end());
+
+  // Arriving with the inside on the left, the way out that keeps it there is the first one clockwise of the way
+  // back, the same as when walking the pieces.
+  mSharedNext.clear();
+  for(size_t i = begin; i < end; ++i)
+  {
+    Vec2 direction = points[mPrev[mEvents[i]]] - point;
+    std::pair<float, size_t> back(std::atan2(direction.y, direction.x), 0);
+    auto it = std::lower_bound(mSharedOutgoing.begin(), mSharedOutgoing.end(), back);
+    if(it == mSharedOutgoing.begin())
+      it = mSharedOutgoing.end();
+    --it;
+    // Contours that cross at the point can't be paired up, so they're left alone
+    if(std::find(mSharedNext.begin(), mSharedNext.end(), it->second) != mSharedNext.end())
+      return;
+    mSharedNext.push_back(it->second);
+  }
+
+  for(size_t i = begin; i < end; ++i)
+  {
+    size_t vertex = mEvents[i];
+    size_t next = mSharedNext[i - begin];
+    mNext[vertex] = next;
+    mPrev[next] = vertex;
+  }
+}
+
+Vec2 PolygonTriangulator::ComputeInsideDirection(const Vec2* points, size_t vertex) const
+{
+  // The bisector of the vertex's angle, which flips for reflex vertices
+  const Vec2& point = points[vertex];
+  Vec2 toPrev = points[mPrev[vertex]] - point;
+  Vec2 toNext = points[mNext[vertex]] - point;
+  toPrev = toPrev * (1.0f / std::sqrt(Vec2::Dot(toPrev, toPrev)));
+  toNext = toNext * (1.0f / std::sqrt(Vec2::Dot(toNext, toNext)));
+  Vec2 direction = toPrev + toNext;
+  float length = std::sqrt(Vec2::Dot(direction, direction));
+  // Straight through, the inside is to the left
+  if(length < 1e-3f)
+    return Vec2(-toNext.y, toNext.x);
+  if(Cross2d(toNext, toPrev) < 0)
+    length = -length;
+  return direction * (1.0f / length);
+}
+
+void PolygonTriangulator::AddDiagonals(size_t count)
+{
+  mStatus = std::set<size_t, EdgeOrder>(EdgeOrder{this});
+  mStatusEdges.assign(count, StatusEdge{mStatus.end(), 0, false});
+  mIsMerge.assign(count, false);
+  mDiagonals.clear();
+
+  for(size_t vertex : mEvents)
+  {
+    mSweepVertex = vertex;
+    const Vec2& point = mPoints[vertex];
+    const Vec2& prevPoint = mPoints[mPrev[vertex]];
+    const Vec2& nextPoint = mPoints[mNext[vertex]];
+    bool prevAbove = IsAbove(prevPoint, point);
+    bool nextAbove = IsAbove(nextPoint, point);
+    bool convex = Cross2d(point - prevPoint, nextPoint - point) > 0;
+
+    if(!prevAbove && !nextAbove)
+    {
+      // A split vertex is connected up to the last vertex seen between the edges on either side of it
+      if(!convex)
+      {
+        auto leftEdge = FindLeftEdge(vertex);
+        if(leftEdge != mStatus.end())
+        {
+          AddDiagonal(vertex, mStatusEdges[*leftEdge].mHelper);
+          mStatusEdges[*leftEdge].mHelper = vertex;
+        }
+      }
+      InsertEdge(vertex);
+    }
+    else if(prevAbove && nextAbove)
+    {
+      RemoveEdge(vertex, mPrev[vertex]);
+      // A merge vertex waits to be connected down to the next vertex seen between the edges on either side of it
+      if(!convex)
+      {
+        mIsMerge[vertex] = true;
+        auto leftEdge = FindLeftEdge(vertex);
+        if(leftEdge != mStatus.end())
+          SetHelper(vertex, leftEdge);
+      }
+    }
+    else if(prevAbove)
+    {
+      // The boundary runs down with the inside on its right
+      RemoveEdge(vertex, mPrev[vertex]);
+      InsertEdge(vertex);
+    }
+    else
+    {
+      auto leftEdge = FindLeftEdge(vertex);
+      if(leftEdge != mStatus.end())
+        SetHelper(vertex, leftEdge);
+    }
+  }
+}
+
+void PolygonTriangulator::AddDiagonal(size_t a, size_t b)
+{
+  if(a != b)
+    mDiagonals.push_back({a, b});
+}
+
+std::set<size_t, PolygonTriangulator::EdgeOrder>::iterator PolygonTriangulator::FindLeftEdge(size_t vertex)
+{
+  auto it = mStatus.lower_bound(SweepPoint);
+  if(it == mStatus.begin())
+    return mStatus.end();
+  return --it;
+}
+
+void PolygonTriangulator::InsertEdge(size_t vertex)
+{
+  StatusEdge& edge = mStatusEdges[vertex];
+  edge.mIterator = mStatus.insert(vertex).first;
+  edge.mHelper = vertex;
+  edge.mActive = true;
+}
+
+void PolygonTriangulator::RemoveEdge(size_t vertex, size_t edge)
+{
+  StatusEdge& statusEdge = mStatusEdges[edge];
+  if(!statusEdge.mActive)
+    return;
+  if(mIsMerge[statusEdge.mHelper])
+    AddDiagonal(vertex, statusEdge.mHelper);
+  mStatus.erase(statusEdge.mIterator);
+  statusEdge.mActive = false;
+}
+
+void PolygonTriangulator::SetHelper(size_t vertex, std::set<size_t, EdgeOrder>::iterator edge)
+{
+  StatusEdge& statusEdge = mStatusEdges[*edge];
+  if(mIsMerge[statusEdge.mHelper])
+    AddDiagonal(vertex, statusEdge.mHelper);
+  statusEdge.mHelper = vertex;
+}
+
+void PolygonTriangulator::ExtractPieces(size_t count, Array<uint32_t>& indices)
+{
+  // Every vertex has its two boundary half-edges plus any diagonals
+  mHalfEdgeStarts.assign(count + 1, 0);
+  for(size_t vertex : mEvents)
+    mHalfEdgeStarts[vertex + 1] += 2;
+  for(const std::pair<size_t, size_t>& diagonal : mDiagonals)
+  {
+    ++mHalfEdgeStarts[diagonal.first + 1];
+    ++mHalfEdgeStarts[diagonal.second + 1];
+  }
+  for(size_t i = 0; i < count; ++i)
+    mHalfEdgeStarts[i + 1] += mHalfEdgeStarts[i];
+
+  mHalfEdges.resize(mHalfEdgeStarts[count]);
+  mHalfEdgeCursors.assign(mHalfEdgeStarts.begin(), mHalfEdgeStarts.end() - 1);
+  auto addHalfEdge = [this](size_t from, size_t to, bool inside)
+  {
+    mHalfEdges[mHalfEdgeCursors[from]++] = HalfEdge{to, inside, false};
+  };
+  for(size_t vertex : mEvents)
+  {
+    addHalfEdge(vertex, mNext[vertex], true);
+    addHalfEdge(vertex, mPrev[vertex], false);
+  }
+  for(const std::pair<size_t, size_t>& diagonal : mDiagonals)
+  {
+    addHalfEdge(diagonal.first, diagonal.second, true);
+    addHalfEdge(diagonal.second, diagonal.first, true);
+  }
+  for(size_t vertex : mEvents)
+  {
+    const Vec2& origin = mPoints[vertex];
+    std::sort(mHalfEdges.begin() + mHalfEdgeStarts[vertex], mHalfEdges.begin() + mHalfEdgeStarts[vertex + 1], [this, &origin](const HalfEdge& lhs, const HalfEdge& rhs)
+    {
+      Vec2 lhsDirection = mPoints[lhs.mTarget] - origin;
+      Vec2 rhsDirection = mPoints[rhs.mTarget] - origin;
+      return std::atan2(lhsDirection.y, lhsDirection.x) < std::atan2(rhsDirection.y, rhsDirection.x);
+    });
+  }
+
+  // Walk each piece keeping it on the left, which at every vertex means leaving along the half-edge just clockwise
+  // of the one back to where we came from.
+  for(size_t vertex : mEvents)
+  {
+    for(size_t i = mHalfEdgeStarts[vertex]; i < mHalfEdgeStarts[vertex + 1]; ++i)
+    {
+      if(!mHalfEdges[i].mInside || mHalfEdges[i].mVisited)
+        continue;
+
+      mPiece.clear();
+      size_t from = vertex;
+      size_t halfEdge = i;
+      while(!mHalfEdges[halfEdge].mVisited)
+      {
+        mHalfEdges[halfEdge].mVisited = true;
+        mPiece.push_back(from);
+        size_t to = mHalfEdges[halfEdge].mTarget;
+        size_t begin = mHalfEdgeStarts[to];
+        size_t degree = mHalfEdgeStarts[to + 1] - begin;
+        size_t twin = 0;
+        while(twin + 1 < degree && mHalfEdges[begin + twin].mTarget != from)
+          ++twin;
+        halfEdge = begin + (twin + degree - 1) % degree;
+        from = to;
+      }
+      TriangulateMonotone(indices);
+    }
+  }
+}
+
+void PolygonTriangulator::TriangulateMonotone(Array<uint32_t>& indices)
+{
+  size_t count = mPiece.size();
+  if(count < 3)
+    return;
+
+  size_t top = 0;
+  size_t bottom = 0;
+  for(size_t i = 1; i < count; ++i)
+  {
+    if(IsAbove(mPoints[mPiece[i]], mPoints[mPiece[top]]))
+      top = i;
+    if(IsAbove(mPoints[mPiece[bottom]], mPoints[mPiece[i]]))
+      bottom = i;
+  }
+
+  // Going counter-clockwise from the top runs down the left chain to the bottom, the other way runs down the
+  // right chain. Merging the two sorts the piece from top to bottom.
+  mSorted.clear();
+  mSorted.push_back({mPiece[top], true});
+  size_t left = (top + 1) % count;
+  size_t right = (top + count - 1) % count;
+  size_t leftRemaining = (bottom + count - top) % count;
+  size_t rightRemaining = count - 1 - leftRemaining;
+  while(leftRemaining > 0 || rightRemaining > 0)
+  {
+    if(rightRemaining == 0 || (leftRemaining > 0 && IsAbove(mPoints[mPiece[left]], mPoints[mPiece[right]])))
+    {
+      mSorted.push_back({mPiece[left], true});
+      left = (left + 1) % count;
+      --leftRemaining;
+    }
+    else
+    {
+      mSorted.push_back({mPiece[right], false});
+      right = (right + count - 1) % count;
+      --rightRemaining;
+    }
+  }
+
+  mStack.clear();
+  mStack.push_back(mSorted[0]);
+  mStack.push_back(mSorted[1]);
+  for(size_t i = 2; i + 1 < count; ++i)
+  {
+    std::pair<size_t, bool> current = mSorted[i];
+    if(current.second != mStack.back().second)
+    {
+      // Across from the other chain everything on the stack is visible
+      for(size_t j = 0; j + 1 < mStack.size(); ++j)
+        AddTriangle(current.first, mStack[j].first, mStack[j + 1].first, indices);
+      mStack.clear();
+      mStack.push_back(mSorted[i - 1]);
+      mStack.push_back(current);
+      continue;
+    }
+
+    // Along the same chain, cut off triangles while the chain is convex
+    std::pair<size_t, bool> last = mStack.back();
+    mStack.pop_back();
+    while(!mStack.empty())
+    {
+      const Vec2& point = mPoints[current.first];
+      const Vec2& lastPoint = mPoints[last.first];
+      const Vec2& stackPoint = mPoints[mStack.back().first];
+      float turn = current.second ? Cross2d(lastPoint - stackPoint, point - lastPoint) : Cross2d(lastPoint - point, stackPoint - lastPoint);
+      if(turn <= 0)
+        break;
+      AddTriangle(current.first, last.first, mStack.back().first, indices);
+      last = mStack.back();
+      mStack.pop_back();
+    }
+    mStack.push_back(last);
+    mStack.push_back(current);
+  }
+
+  size_t lowest = mSorted[count - 1].first;
+  for(size_t j = 0; j + 1 < mStack.size(); ++j)
+    AddTriangle(lowest, mStack[j].first, mStack[j + 1].first, indices);
+}
+
+void PolygonTriangulator::AddTriangle(size_t a, size_t b, size_t c, Array<uint32_t>& indices) const
+{
+  if(Cross2d(mPoints[b] - mPoints[a], mPoints[c] - mPoints[a]) < 0)
+    std::swap(b, c);
+  indices.push_back(uint32_t(mBaseIndex + a));
+  indices.push_back(uint32_t(mBaseIndex + b));
+  indices.push_back(uint32_t(mBaseIndex + c));
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+#include <cstdint>
+#include <set>
+
+//-------------------------------------------------------------------TriangulatorSink
+// Writes traced contours straight into a vertex buffer, which PolygonTriangulator can then triangulate in place.
+// Repeated points are skipped and contours that end up with fewer than three points are dropped.
+struct TriangulatorSink : public ClipContourSink
+{
+  TriangulatorSink(Array<Vec2>& vertices) : mVertices(vertices), mFirstVertex(vertices.size()) {}
+
+  void BeginContour() override;
+  void AddVertex(const ClipVertex& vertex) override;
+  void EndContour() override;
+
+  Array<Vec2>& mVertices;
+  // Where the sink started writing and where each contour starts, both as indices into mVertices.
+  size_t mFirstVertex;
+  Array<size_t> mContourStarts;
+};
+
+//-------------------------------------------------------------------PolygonTriangulator
+// Triangulates polygons with holes in O(n log n). A sweep from top to bottom adds the diagonals that split the
+// polygon into y-monotone pieces, which are then each triangulated in linear time. Outer contours and holes must
+// wind opposite ways, as every engine's results do, and the largest contour decides which winding is outer.
+// Contours may touch but not cross. Points closer together than float precision can resolve at their magnitude
+// can't be ordered reliably, so noisy contours should go through a small duplicate epsilon first (see
+// ContourSimplifier or ClipCleanupOptions). Triangles wind counter-clockwise.
+struct PolygonTriangulator
+{
+  // Appends the contours' points to the vertex buffer and three indices into it per triangle to the index buffer.
+  void Triangulate(const PointContourList& contours, Array<Vec2>& vertices, Array<uint32_t>& indices);
+  // Triangulates contours that are already in the vertex buffer from firstVertex on, such as those written by a
+  // TriangulatorSink. Each contour runs from its start to the next one's or the end of the buffer.
+  void Triangulate(const Array<Vec2>& vertices, size_t firstVertex, const Array<size_t>& contourStarts, Array<uint32_t>& indices);
+  // Clips into a TriangulatorSink (see Clipper::Execute with a sink) and triangulates the result without building
+  // a PointContourList. The traced points go straight into the vertex buffer.
+  void ClipAndTriangulate(Clipper& clipper, ClipOperation operation, const PointContour& polygonPoints, const PointContour& clipRegion, Array<Vec2>& vertices, Array<uint32_t>& indices);
+
+private:
+  struct EdgeOrder
+  {
+    bool operator()(size_t lhs, size_t rhs) const;
+    float XAt(size_t edge) const;
+
+    const PolygonTriangulator* mTriangulator;
+  };
+  // The edge running down from each vertex that's in the sweep status, with its helper.
+  struct StatusEdge
+  {
+    std::set<size_t, EdgeOrder>::iterator mIterator;
+    size_t mHelper;
+    bool mActive;
+  };
+
+  void SortEvents();
+  // Contours may touch at a vertex, which the sweep can't order. Each vertex at a shared point is moved a tiny step
+  // into its own corner, only for the sweep, which pulls them apart without any edges crossing. Returns whether
+  // any were moved.
+  bool SeparateSharedPoints(const Vec2* points);
+  // Where a contour passes through a point more than once, or contours meet at a point, each way in is paired with
+  // the way out next to it so the corners there don't overlap. This splits a contour that pinches itself into
+  // simple loops.
+  void RelinkSharedPoint(const Vec2* points, size_t begin, size_t end);
+  // The unit direction from a vertex into the inside of its corner.
+  Vec2 ComputeInsideDirection(const Vec2* points, size_t vertex) const;
+  void AddDiagonals(size_t count);
+  void AddDiagonal(size_t a, size_t b);
+  // Edges to the left of the sweep point, or end when there are none.
+  std::set<size_t, EdgeOrder>::iterator FindLeftEdge(size_t vertex);
+  void InsertEdge(size_t vertex);
+  void RemoveEdge(size_t vertex, size_t edge);
+  void SetHelper(size_t vertex, std::set<size_t, EdgeOrder>::iterator edge);
+  void ExtractPieces(size_t count, Array<uint32_t>& indices);
+  void TriangulateMonotone(Array<uint32_t>& indices);
+  void AddTriangle(size_t a, size_t b, size_t c, Array<uint32_t>& indices) const;
+
+  // Points relative to the first vertex, with every contour linked so the inside is on the left.
+  const Vec2* mPoints = nullptr;
+  Array<Vec2> mSeparatedPoints;
+  Array<std::pair<float, size_t>> mSharedOutgoing;
+  Array<size_t> mSharedNext;
+  size_t mBaseIndex = 0;
+  Array<size_t> mNext;
+  Array<size_t> mPrev;
+  Array<bool> mIsMerge;
+  Array<size_t> mEvents;
+  size_t mSweepVertex = 0;
+  std::set<size_t, EdgeOrder> mStatus;
+  Array<StatusEdge> mStatusEdges;
+  Array<std::pair<size_t, size_t>> mDiagonals;
+
+  // The boundary and diagonals as half-edges, grouped by their start vertex from mHalfEdgeStarts and sorted by
+  // angle within each group. Inside half-edges have the polygon on their left.
+  struct HalfEdge
+  {
+    size_t mTarget;
+    bool mInside;
+    bool mVisited;
+  };
+  Array<size_t> mHalfEdgeStarts;
+  Array<size_t> mHalfEdgeCursors;
+  Array<HalfEdge> mHalfEdges;
+  Array<size_t> mPiece;
+  Array<std::pair<size_t, bool>> mSorted;
+  Array<std::pair<size_t, bool>> mStack;
+};
@@ -0,0 +1,265 @@
+#include "PolylineClipper.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLIPPER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// A region edge as the half-plane nx * x + ny * y - d >= 0.
+struct ClipPlane
+{
+  float mNx;
+  float mNy;
+  float mD;
+};
+
+static void BuildPlanes(const PointContour& convexRegion, Array<ClipPlane>& planes)
+{
+  // Inside is to the left of counter-clockwise edges and to the right of clockwise ones.
+  float sign = ComputeSignedArea(convexRegion) < 0 ? -1.0f : 1.0f;
+  size_t count = convexRegion.size();
+  planes.clear();
+  for(size_t i = 0; i < count; ++i)
+  {
+    const Vec2& start = convexRegion[i];
+    Vec2 edge = convexRegion[(i + 1) % count] - start;
+    ClipPlane plane;
+    plane.mNx = -sign * edge.y;
+    plane.mNy = sign * edge.x;
+    plane.mD = plane.mNx * start.x + plane.mNy * start.y;
+    planes.push_back(plane);
+  }
+}
+
+static void ClipSegment(const Array<ClipPlane>& planes, float startX, float startY, float endX, float endY, float& enter, float& exit)
+{
+  enter = 0;
+  exit = 1;
+  for(const ClipPlane& plane : planes)
+  {
+    float startDistance = plane.mNx * startX + plane.mNy * startY - plane.mD;
+    float endDistance = plane.mNx * endX + plane.mNy * endY - plane.mD;
+    if(startDistance < 0 && endDistance < 0)
+    {
+      enter = 1;
+      exit = 0;
+      return;
+    }
+    if(startDistance < 0)
+      enter = std::max(enter, startDistance / (startDistance - endDistance));
+    else if(endDistance < 0)
+      exit = std::min(exit, startDistance / (startDistance - endDistance));
+  }
+}
+
+#ifdef CLIPPER_SSE2
+// The same as ClipSegment for the four segments starting at index. Lanes that are entirely outside of a plane are
+// forced to the empty range [1, 0], which later planes can't undo.
+static void ClipSegments4(const Array<ClipPlane>& planes, const SegmentBatch& segments, size_t index, float* enterTimes, float* exitTimes)
+{
+  __m128 startX = _mm_loadu_ps(&segments.mStartX[index]);
+  __m128 startY = _mm_loadu_ps(&segments.mStartY[index]);
+  __m128 endX = _mm_loadu_ps(&segments.mEndX[index]);
+  __m128 endY = _mm_loadu_ps(&segments.mEndY[index]);
+  __m128 zero = _mm_setzero_ps();
+  __m128 one = _mm_set1_ps(1.0f);
+  __m128 enter = zero;
+  __m128 exit = one;
+  for(const ClipPlane& plane : planes)
+  {
+    __m128 nx = _mm_set1_ps(plane.mNx);
+    __m128 ny = _mm_set1_ps(plane.mNy);
+    __m128 d = _mm_set1_ps(plane.mD);
+    __m128 startDistance = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(nx, startX), _mm_mul_ps(ny, startY)), d);
+    __m128 endDistance = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(nx, endX), _mm_mul_ps(ny, endY)), d);
+    __m128 startOutside = _mm_cmplt_ps(startDistance, zero);
+    __m128 endOutside = _mm_cmplt_ps(endDistance, zero);
+    __m128 entering = _mm_andnot_ps(endOutside, startOutside);
+    __m128 exiting = _mm_andnot_ps(startOutside, endOutside);
+    __m128 outside = _mm_and_ps(startOutside, endOutside);
+
+    // Lanes that don't cross divide by one instead so no infinities are created.
+    __m128 crossing = _mm_or_ps(entering, exiting);
+    __m128 denominator = _mm_sub_ps(startDistance, endDistance);
+    denominator = _mm_or_ps(_mm_and_ps(crossing, denominator), _mm_andnot_ps(crossing, one));
+    __m128 time = _mm_div_ps(startDistance, denominator);
+
+    enter = _mm_or_ps(_mm_and_ps(entering, _mm_max_ps(enter, time)), _mm_andnot_ps(entering, enter));
+    exit = _mm_or_ps(_mm_and_ps(exiting, _mm_min_ps(exit, time)), _mm_andnot_ps(exiting, exit));
+    enter = _mm_or_ps(_mm_and_ps(outside, one), _mm_andnot_ps(outside, enter));
+    exit = _mm_andnot_ps(outside, exit);
+  }
+  _mm_storeu_ps(enterTimes + index, enter);
+  _mm_storeu_ps(exitTimes + index, exit);
+}
+#endif
+
+//-------------------------------------------------------------------SegmentBatch
+void SegmentBatch::Clear()
+{
+  mStartX.clear();
+  mStartY.clear();
+  mEndX.clear();
+  mEndY.clear();
+}
+
+void SegmentBatch::Reserve(size_t count)
+{
+  mStartX.reserve(count);
+  mStartY.reserve(count);
+  mEndX.reserve(count);
+  mEndY.reserve(count);
+}
+
+void SegmentBatch::Add(const Vec2& start, const Vec2& end)
+{
+  mStartX.push_back(start.x);
+  mStartY.push_back(start.y);
+  mEndX.push_back(end.x);
+  mEndY.push_back(end.y);
+}
+
+//-------------------------------------------------------------------PolylineClipper
+void PolylineClipper::Clip(const PointContour& polyline, const PointContourList& clipRegions, PointContourList& inside, PointContourList& outside)
+{
+  BuildEdges(clipRegions.data(), clipRegions.size());
+  ClipPolyline(polyline, inside, outside);
+}
+
+void PolylineClipper::Clip(const PointContour& polyline, const PointContour& clipRegion, PointContourList& inside, PointContourList& outside)
+{
+  BuildEdges(&clipRegion, 1);
+  ClipPolyline(polyline, inside, outside);
+}
+
+void PolylineClipper::ClipSegments(const SegmentBatch& segments, const PointContour& convexRegion, Array<float>& enterTimes, Array<float>& exitTimes)
+{
+  size_t count = segments.GetCount();
+  enterTimes.resize(count);
+  exitTimes.resize(count);
+  Array<ClipPlane> planes;
+  BuildPlanes(convexRegion, planes);
+
+  size_t i = 0;
+#ifdef CLIPPER_SSE2
+  for(; i + 4 <= count; i += 4)
+    ClipSegments4(planes, segments, i, enterTimes.data(), exitTimes.data());
+#endif
+  for(; i < count; ++i)
+    ClipSegment(planes, segments.mStartX[i], segments.mStartY[i], segments.mEndX[i], segments.mEndY[i], enterTimes[i], exitTimes[i]);
+}
+
+void PolylineClipper::BuildEdges(const PointContour* clipRegions, size_t regionCount)
+{
+  mEdges.clear();
+  mEdgeAabbs.clear();
+  mBounds = Aabb();
+  for(size_t regionIndex = 0; regionIndex < regionCount; ++regionIndex)
+  {
+    const PointContour& region = clipRegions[regionIndex];
+    size_t count = region.size();
+    for(size_t i = 0; i < count; ++i)
+    {
+      Edge edge{region[i], region[(i + 1) % count]};
+      mEdges.push_back(edge);
+      mEdgeAabbs.push_back(Aabb::FromSegment(edge.mStart, edge.mEnd));
+      mBounds.Expand(edge.mStart);
+    }
+  }
+  mTree.Build(mEdgeAabbs);
+}
+
+void PolylineClipper::ClipPolyline(const PointContour& polyline, PointContourList& inside, PointContourList& outside)
+{
+  inside.clear();
+  outside.clear();
+  if(polyline.size() < 2)
+    return;
+
+  PointContour* current = nullptr;
+  bool currentInside = false;
+  // Whether the last point of the current run is a split between two spans on the same side, which is dropped
+  // when the run continues.
+  bool lastIsSplit = false;
+  auto appendSpan = [&](const Vec2& start, const Vec2& end, bool spanInside, bool endIsSplit)
+  {
+    if(current == nullptr || currentInside != spanInside)
+    {
+      PointContourList& target = spanInside ? inside : outside;
+      target.emplace_back();
+      current = &target.back();
+      current->push_back(start);
+      currentInside = spanInside;
+    }
+    else if(lastIsSplit)
+      current->pop_back();
+    current->push_back(end);
+    lastIsSplit = endIsSplit;
+  };
+
+  for(size_t i = 0; i + 1 < polyline.size(); ++i)
+  {
+    const Vec2& start = polyline[i];
+    const Vec2& end = polyline[i + 1];
+    Vec2 direction = end - start;
+    if(direction == Vec2(0, 0))
+      continue;
+
+    mTimes.clear();
+    mTimes.push_back(0);
+    mTree.Query(Aabb::FromSegment(start, end), [&](size_t edgeIndex)
+    {
+      const Edge& edge = mEdges[edgeIndex];
+      Vec2 edgeDirection = edge.mEnd - edge.mStart;
+      float denominator = Cross2d(direction, edgeDirection);
+      // Parallel edges don't split the segment. Any overlap is classified with the spans around it.
+      if(denominator == 0)
+        return;
+      Vec2 offset = edge.mStart - start;
+      float time = Cross2d(offset, edgeDirection) / denominator;
+      float edgeTime = Cross2d(offset, direction) / denominator;
+      if(time > 0 && time < 1 && edgeTime >= 0 && edgeTime <= 1)
+        mTimes.push_back(time);
+    });
+    mTimes.push_back(1);
+    std::sort(mTimes.begin(), mTimes.end());
+
+    Vec2 spanStart = start;
+    for(size_t j = 0; j + 1 < mTimes.size(); ++j)
+    {
+      float startTime = mTimes[j];
+      float endTime = mTimes[j + 1];
+      if(endTime <= startTime)
+        continue;
+
+      bool isLast = j + 2 == mTimes.size();
+      Vec2 spanEnd = isLast ? end : start + direction * endTime;
+      Vec2 midpoint = start + direction * ((startTime + endTime) * 0.5f);
+      appendSpan(spanStart, spanEnd, IsInside(midpoint), !isLast);
+      spanStart = spanEnd;
+    }
+  }
+}
+
+bool PolylineClipper::IsInside(const Vec2& point) const
+{
+  if(!mBounds.IsValid() || !mBounds.Contains(point))
+    return false;
+
+  bool inside = false;
+  Aabb ray(point, Vec2(mBounds.mMax.x, point.y));
+  mTree.Query(ray, [&](size_t edgeIndex)
+  {
+    const Vec2& a = mEdges[edgeIndex].mStart;
+    const Vec2& b = mEdges[edgeIndex].mEnd;
+    if((a.y > point.y) != (b.y > point.y))
+    {
+      float x = a.x + (point.y - a.y) * (b.x - a.x) / (b.y - a.y);
+      if(point.x < x)
+        inside = !inside;
+    }
+  });
+  return inside;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Clipper.hpp"
+#include "StrTree.hpp"
+
+//-------------------------------------------------------------------SegmentBatch
+// Line segments stored as a structure of arrays so the batched kernel can load the same coordinate of several
+// segments with one instruction.
+struct SegmentBatch
+{
+  void Clear();
+  void Reserve(size_t count);
+  void Add(const Vec2& start, const Vec2& end);
+  size_t GetCount() const { return mStartX.size(); }
+
+  Array<float> mStartX;
+  Array<float> mStartY;
+  Array<float> mEndX;
+  Array<float> mEndY;
+};
+
+//-------------------------------------------------------------------PolylineClipper
+// Clips open polylines (roads, rivers, rays) against closed clip regions. Unlike the polygon engines nothing is
+// traced: every polyline segment is split at its crossings with the region boundaries and each span between two
+// crossings is classified on its own, so the polyline never needs to loop back on itself.
+struct PolylineClipper
+{
+  // Splits the polyline at every crossing with the clip region boundaries and returns the inside and outside
+  // runs in polyline order. Overlapping clip regions and holes use the even-odd rule like ContainsPoint. Spans
+  // lying exactly along a region boundary may go either way. The boundary edges are kept in an aabb tree so each
+  // polyline segment is only tested against the edges it could touch.
+  void Clip(const PointContour& polyline, const PointContourList& clipRegions, PointContourList& inside, PointContourList& outside);
+  void Clip(const PointContour& polyline, const PointContour& clipRegion, PointContourList& inside, PointContourList& outside);
+
+  // Clips every segment of the batch against a convex region of either winding (Cyrus-Beck). The part of segment
+  // i inside the region is the parametric range [enterTimes[i], exitTimes[i]], which is empty when enter > exit.
+  // Each region edge is a half-plane test with no branches, so four segments are clipped at a time with SSE2
+  // when it's available and one at a time otherwise. Concave regions go through Clip instead.
+  static void ClipSegments(const SegmentBatch& segments, const PointContour& convexRegion, Array<float>& enterTimes, Array<float>& exitTimes);
+
+private:
+  struct Edge
+  {
+    Vec2 mStart;
+    Vec2 mEnd;
+  };
+
+  void BuildEdges(const PointContour* clipRegions, size_t regionCount);
+  void ClipPolyline(const PointContour& polyline, PointContourList& inside, PointContourList& outside);
+  // Even-odd test that casts the ray to the right through the edge tree.
+  bool IsInside(const Vec2& point) const;
+
+  Array<Edge> mEdges;
+  Array<Aabb> mEdgeAabbs;
+  StrTree mTree;
+  Aabb mBounds;
+  // The split times along the current segment.
+  Array<float> mTimes;
+};
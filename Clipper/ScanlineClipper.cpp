@@ -0,0 +1,340 @@
+#include "ScanlineClipper.hpp"
+
+#include "ContourSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//-------------------------------------------------------------------ScanlineClipper::Edge
+float ScanlineClipper::Edge::XAt(float y) const
+{
+  // Endpoints have to be exact so fragments from neighboring scanbeams share their points
+  if(y == mBottom.y)
+    return mBottom.x;
+  if(y == mTop.y)
+    return mTop.x;
+  if(mHasSnap && y == mSnapY)
+    return mSnapX;
+  return mBottom.x + (y - mBottom.y) * mDxDy;
+}
+
+//-------------------------------------------------------------------ScanlineClipper
+void ScanlineClipper::Execute(ClipOperation operation, const PointContourList& subject, const PointContourList& clip, PointContourList& results)
+{
+  results.clear();
+  Execute(operation, subject, clip, [&results](const PointContour& contour)
+  {
+    results.push_back(contour);
+  });
+}
+
+void ScanlineClipper::Sweep(ClipOperation operation)
+{
+  if(mEdges.empty())
+    return;
+
+  std::sort(mEdges.begin(), mEdges.end(), [](const Edge& lhs, const Edge& rhs)
+  {
+    return lhs.mBottom.y < rhs.mBottom.y;
+  });
+  Array<float> scanlines;
+  scanlines.reserve(mEdges.size() * 2);
+  for(const Edge& edge : mEdges)
+  {
+    scanlines.push_back(edge.mBottom.y);
+    scanlines.push_back(edge.mTop.y);
+  }
+  std::sort(scanlines.begin(), scanlines.end());
+  scanlines.erase(std::unique(scanlines.begin(), scanlines.end()), scanlines.end());
+
+  Array<size_t> activeEdges;
+  Array<float> belowXs;
+  Array<float> bottomXs;
+  Array<float> topXs;
+  size_t nextEdge = 0;
+  size_t nextScanline = 0;
+  float yBottom = scanlines[0];
+  while(true)
+  {
+    // Update the active edge list for this scanline
+    auto finished = [this, yBottom](size_t edgeIndex) { return mEdges[edgeIndex].mTop.y <= yBottom; };
+    activeEdges.erase(std::remove_if(activeEdges.begin(), activeEdges.end(), finished), activeEdges.end());
+    while(nextEdge < mEdges.size() && mEdges[nextEdge].mBottom.y <= yBottom)
+      activeEdges.push_back(nextEdge++);
+    while(nextScanline < scanlines.size() && scanlines[nextScanline] <= yBottom)
+      ++nextScanline;
+    if(nextScanline == scanlines.size())
+    {
+      Array<float> noXs;
+      AddHorizontalFragments(yBottom, belowXs, noXs);
+      break;
+    }
+    float yNext = scanlines[nextScanline];
+
+    // Cache where each edge is on this scanline before any crossing above it moves the edge's snap point
+    for(size_t edgeIndex : activeEdges)
+      mEdges[edgeIndex].mCurrentX = mEdges[edgeIndex].XAt(yBottom);
+
+    // Order the edges as they are just above this scanline. The list barely changes between scanbeams so an insertion sort is close to linear.
+    auto isLeftOf = [this, yNext](size_t lhs, size_t rhs)
+    {
+      float lhsX = mEdges[lhs].mCurrentX;
+      float rhsX = mEdges[rhs].mCurrentX;
+      if(lhsX != rhsX)
+        return lhsX < rhsX;
+      return mEdges[lhs].XAt(yNext) < mEdges[rhs].XAt(yNext);
+    };
+    for(size_t i = 1; i < activeEdges.size(); ++i)
+    {
+      size_t edgeIndex = activeEdges[i];
+      size_t j = i;
+      for(; j > 0 && isLeftOf(edgeIndex, activeEdges[j - 1]); --j)
+        activeEdges[j] = activeEdges[j - 1];
+      activeEdges[j] = edgeIndex;
+    }
+
+    // The first crossing above this scanline has to be between two neighboring edges. End the scanbeam there so the order is fixed within it.
+    auto computeCrossingY = [this, yBottom, yNext](const Edge& lhs, const Edge& rhs)
+    {
+      if(lhs.XAt(yNext) <= rhs.XAt(yNext) || lhs.mDxDy == rhs.mDxDy)
+        return yNext;
+      return yBottom + (rhs.mCurrentX - lhs.mCurrentX) / (lhs.mDxDy - rhs.mDxDy);
+    };
+    float yTop = yNext;
+    for(size_t i = 1; i < activeEdges.size(); ++i)
+    {
+      float crossingY = computeCrossingY(mEdges[activeEdges[i - 1]], mEdges[activeEdges[i]]);
+      if(crossingY > yBottom && crossingY < yTop)
+        yTop = crossingY;
+    }
+    if(yTop < yNext)
+    {
+      for(size_t i = 1; i < activeEdges.size(); ++i)
+      {
+        Edge& lhs = mEdges[activeEdges[i - 1]];
+        Edge& rhs = mEdges[activeEdges[i]];
+        if(computeCrossingY(lhs, rhs) != yTop)
+          continue;
+        float x = lhs.XAt(yTop);
+        lhs.mSnapY = rhs.mSnapY = yTop;
+        lhs.mSnapX = rhs.mSnapX = x;
+        lhs.mHasSnap = rhs.mHasSnap = true;
+      }
+    }
+
+    // Walk the scanbeam from left to right. Every edge where the result changes between inside and outside is part of the boundary.
+    int windings[2] = {0, 0};
+    bool wasInside = false;
+    bottomXs.clear();
+    topXs.clear();
+    for(size_t edgeIndex : activeEdges)
+    {
+      const Edge& edge = mEdges[edgeIndex];
+      windings[edge.mOperand] += edge.mWinding;
+      bool inside = IsResultInside(operation, IsInside(windings[0]), IsInside(windings[1]));
+      if(inside == wasInside)
+        continue;
+
+      // Wind the fragment so the inside is on its left
+      Vec2 bottom(edge.mCurrentX, yBottom);
+      Vec2 top(edge.XAt(yTop), yTop);
+      if(inside)
+        AddFragment(top, bottom);
+      else
+        AddFragment(bottom, top);
+      bottomXs.push_back(bottom.x);
+      topXs.push_back(top.x);
+      wasInside = inside;
+    }
+
+    AddHorizontalFragments(yBottom, belowXs, bottomXs);
+    belowXs.swap(topXs);
+    yBottom = yTop;
+  }
+}
+
+void ScanlineClipper::AddContours(const PointContourList& contours, int operand)
+{
+  for(const PointContour& contour : contours)
+  {
+    size_t count = contour.size();
+    if(count < 3)
+      continue;
+
+    for(size_t i = 0; i < count; ++i)
+      AddEdge(contour[i], contour[(i + 1) % count], operand);
+  }
+}
+
+void ScanlineClipper::AddContours(const Array<ClipVertexList>& contours, int operand)
+{
+  for(const ClipVertexList& contour : contours)
+  {
+    if(contour.IsEmpty())
+      continue;
+
+    ClipVertex::Traverse(contour.mHead, [this, operand](ClipVertex* vertex, ClipVertex*& nextVertex)
+    {
+      AddEdge(vertex->mPoint, vertex->mNext->mPoint, operand);
+      return true;
+    });
+  }
+}
+
+void ScanlineClipper::AddEdge(const Vec2& start, const Vec2& end, int operand)
+{
+  // Horizontal edges never change the winding inside a scanbeam, the horizontal boundaries are rebuilt from the scanbeams instead
+  if(start.y == end.y)
+    return;
+
+  Edge edge;
+  edge.mOperand = operand;
+  edge.mWinding = start.y > end.y ? 1 : -1;
+  edge.mBottom = start.y < end.y ? start : end;
+  edge.mTop = start.y < end.y ? end : start;
+  edge.mDxDy = (edge.mTop.x - edge.mBottom.x) / (edge.mTop.y - edge.mBottom.y);
+  mEdges.push_back(edge);
+}
+
+bool ScanlineClipper::IsInside(int winding) const
+{
+  switch(mFillRule)
+  {
+    case ClipFillRule::NonZero:
+      return winding != 0;
+    case ClipFillRule::Positive:
+      return winding > 0;
+    case ClipFillRule::Negative:
+      return winding < 0;
+    case ClipFillRule::EvenOdd:
+    default:
+      return (winding & 1) != 0;
+  }
+}
+
+bool ScanlineClipper::IsResultInside(ClipOperation operation, bool insideSubject, bool insideClip)
+{
+  switch(operation)
+  {
+    case ClipOperation::Union:
+      return insideSubject || insideClip;
+    case ClipOperation::Subtract:
+      return insideSubject && !insideClip;
+    case ClipOperation::Xor:
+      return insideSubject != insideClip;
+    case ClipOperation::Intersect:
+    default:
+      return insideSubject && insideClip;
+  }
+}
+
+void ScanlineClipper::AddFragment(const Vec2& start, const Vec2& end)
+{
+  if(start == end)
+    return;
+  Fragment fragment;
+  fragment.mStart = start;
+  fragment.mEnd = end;
+  mFragments.push_back(fragment);
+}
+
+void ScanlineClipper::AddHorizontalFragments(float y, Array<float>& belowXs, Array<float>& aboveXs)
+{
+  std::sort(belowXs.begin(), belowXs.end());
+  std::sort(aboveXs.begin(), aboveXs.end());
+
+  bool insideBelow = false;
+  bool insideAbove = false;
+  float prevX = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while(i < belowXs.size() || j < aboveXs.size())
+  {
+    float x = 0;
+    if(j == aboveXs.size() || (i < belowXs.size() && belowXs[i] < aboveXs[j]))
+      x = belowXs[i];
+    else
+      x = aboveXs[j];
+
+    // Boundaries of a region above run left to right and boundaries of a region below run right to left, keeping the inside on the left
+    if(insideBelow != insideAbove && x > prevX)
+    {
+      if(insideAbove)
+        AddFragment(Vec2(prevX, y), Vec2(x, y));
+      else
+        AddFragment(Vec2(x, y), Vec2(prevX, y));
+    }
+
+    for(; i < belowXs.size() && belowXs[i] == x; ++i)
+      insideBelow = !insideBelow;
+    for(; j < aboveXs.size() && aboveXs[j] == x; ++j)
+      insideAbove = !insideAbove;
+    prevX = x;
+  }
+}
+
+static bool IsLess(const Vec2& lhs, const Vec2& rhs)
+{
+  if(lhs.x != rhs.x)
+    return lhs.x < rhs.x;
+  return lhs.y < rhs.y;
+}
+
+void ScanlineClipper::SortFragments()
+{
+  // Points are computed identically on both sides of every join, so an exact match is enough.
+  std::sort(mFragments.begin(), mFragments.end(), [](const Fragment& lhs, const Fragment& rhs)
+  {
+    return IsLess(lhs.mStart, rhs.mStart);
+  });
+}
+
+size_t ScanlineClipper::FindNextFragment(const Fragment& incoming) const
+{
+  // Where several boundaries meet at one point take the sharpest left turn. This splits touching
+  // loops apart (such as the two halves of a bow tie) instead of tracing them as one figure eight.
+  auto it = std::lower_bound(mFragments.begin(), mFragments.end(), incoming.mEnd, [](const Fragment& fragment, const Vec2& value)
+  {
+    return IsLess(fragment.mStart, value);
+  });
+  Vec2 incomingDir = incoming.mEnd - incoming.mStart;
+  size_t result = mFragments.size();
+  float bestTurn = 0;
+  for(; it != mFragments.end() && it->mStart == incoming.mEnd; ++it)
+  {
+    if(it->mUsed)
+      continue;
+    Vec2 outgoingDir = it->mEnd - it->mStart;
+    float turn = std::atan2(Cross2d(incomingDir, outgoingDir), Vec2::Dot(incomingDir, outgoingDir));
+    if(result == mFragments.size() || turn > bestTurn)
+    {
+      result = static_cast<size_t>(it - mFragments.begin());
+      bestTurn = turn;
+    }
+  }
+  return result;
+}
+
+bool ScanlineClipper::TraceContour(size_t fragmentIndex, PointContour& contour)
+{
+  contour.clear();
+  if(mFragments[fragmentIndex].mUsed)
+    return false;
+
+  while(fragmentIndex < mFragments.size())
+  {
+    Fragment& fragment = mFragments[fragmentIndex];
+    fragment.mUsed = true;
+    contour.push_back(fragment.mStart);
+    fragmentIndex = FindNextFragment(fragment);
+  }
+
+  // Every edge is split at each scanbeam it passes through so the raw contours are full of duplicate points and
+  // points in the middle of straight runs.
+  ContourSimplifier::RemoveRedundantPoints(contour, 0, 1e-5f);
+  if(contour.size() < 3)
+    return false;
+  if(mClockwiseOutput)
+    std::reverse(contour.begin(), contour.end());
+  return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+//-------------------------------------------------------------------ScanlineClipper
+// A Vatti style scanline clipping engine. All non-horizontal edges of both operands go into an edge table sorted by
+// their bottom y (the local minima table) and are swept bottom to top. Between consecutive events (vertices and edge
+// crossings) the active edge list has a fixed order, so one walk over it with a winding count per operand tells which
+// edges bound the result in that scanbeam. Horizontal boundaries come from where the result changes across an event.
+// The boundary fragments are wound with the inside on their left and chained into the result contours.
+// Crossings are found lazily between neighbors in the active edge list, so each scanbeam costs O(active edges).
+struct ScanlineClipper
+{
+  void Execute(ClipOperation operation, const PointContourList& subject, const PointContourList& clip, PointContourList& results);
+  // Calls the callback with each result contour instead of collecting them. The contour is a scratch buffer that
+  // is reused for the next one, so callers that build their own representation don't pay for a copy.
+  // The operands can be either PointContourLists or arrays of ClipVertexLists.
+  template <typename OperandList, typename Callback>
+  void Execute(ClipOperation operation, const OperandList& subject, const OperandList& clip, Callback callback)
+  {
+    mEdges.clear();
+    mFragments.clear();
+    AddContours(subject, 0);
+    AddContours(clip, 1);
+    Sweep(operation);
+    SortFragments();
+    for(size_t i = 0; i < mFragments.size(); ++i)
+    {
+      if(TraceContour(i, mContour))
+        callback(mContour);
+    }
+  }
+
+  ClipFillRule mFillRule = ClipFillRule::EvenOdd;
+  bool mClockwiseOutput = false;
+
+private:
+  struct Edge
+  {
+    float XAt(float y) const;
+
+    Vec2 mBottom;
+    Vec2 mTop;
+    float mDxDy = 0;
+    // +1 for edges going down and -1 for edges going up, so counter-clockwise contours have a positive winding.
+    int mWinding = 0;
+    // 0 for the subject, 1 for the clip.
+    int mOperand = 0;
+    // Where this edge last crossed another edge. Both edges report exactly this point so their fragments meet.
+    float mSnapY = 0;
+    float mSnapX = 0;
+    bool mHasSnap = false;
+    // X position on the bottom of the current scanbeam.
+    float mCurrentX = 0;
+  };
+
+  struct Fragment
+  {
+    Vec2 mStart;
+    Vec2 mEnd;
+    bool mUsed = false;
+  };
+
+  void AddContours(const PointContourList& contours, int operand);
+  void AddContours(const Array<ClipVertexList>& contours, int operand);
+  void AddEdge(const Vec2& start, const Vec2& end, int operand);
+  bool IsInside(int winding) const;
+  static bool IsResultInside(ClipOperation operation, bool insideSubject, bool insideClip);
+  void AddFragment(const Vec2& start, const Vec2& end);
+  // Adds the horizontal boundaries along the given scanline. The xs are where the result toggles inside and
+  // outside just below and just above the line, the boundary is wherever those two disagree.
+  void AddHorizontalFragments(float y, Array<float>& belowXs, Array<float>& aboveXs);
+  // Sweeps the edges of both operands and collects the result's boundary fragments.
+  void Sweep(ClipOperation operation);
+  // Sorts the fragments by their start point so each chain can find its successor with a binary search.
+  void SortFragments();
+  size_t FindNextFragment(const Fragment& incoming) const;
+  // Chains the fragments starting from the given one into a cleaned up contour. Returns false if the fragment
+  // was already used or the contour collapsed.
+  bool TraceContour(size_t fragmentIndex, PointContour& contour);
+
+  Array<Edge> mEdges;
+  Array<Fragment> mFragments;
+  PointContour mContour;
+};
@@ -0,0 +1,66 @@
+#include "SpatialJoin.hpp"
+
+#include "ClipParallel.hpp"
+#include "StrTree.hpp"
+
+#include <algorithm>
+
+//-------------------------------------------------------------------SpatialJoin
+void SpatialJoin::FindCandidatePairs(const PointContourList& setA, const PointContourList& setB, Array<SpatialJoinPair>& pairs)
+{
+  pairs.clear();
+
+  Array<Aabb> aabbsB(setB.size());
+  for(size_t i = 0; i < setB.size(); ++i)
+    aabbsB[i] = ComputeAabb(setB[i]);
+  StrTree tree;
+  tree.Build(aabbsB);
+
+  Array<size_t> hits;
+  for(size_t indexA = 0; indexA < setA.size(); ++indexA)
+  {
+    Aabb aabbA = ComputeAabb(setA[indexA]);
+    if(!aabbA.IsValid())
+      continue;
+
+    // The tree returns hits in packed order, sort them so the pair order doesn't depend on the packing
+    hits.clear();
+    tree.Query(aabbA, [&hits](size_t indexB) { hits.push_back(indexB); });
+    std::sort(hits.begin(), hits.end());
+    for(size_t indexB : hits)
+    {
+      SpatialJoinPair pair;
+      pair.mIndexA = indexA;
+      pair.mIndexB = indexB;
+      pairs.push_back(pair);
+    }
+  }
+}
+
+void SpatialJoin::Intersect(const PointContourList& setA, const PointContourList& setB, SpatialJoinResultList& results)
+{
+  results.clear();
+
+  Array<SpatialJoinPair> pairs;
+  FindCandidatePairs(setA, setB, pairs);
+
+  // Every pair writes into its own slot so the output order is independent of the thread scheduling
+  SpatialJoinResultList pairResults(pairs.size());
+  ParallelFor(pairs.size(), mThreadCount, [&](size_t i, size_t threadIndex)
+  {
+    const PointContour& polygonA = setA[pairs[i].mIndexA];
+    const PointContour& polygonB = setB[pairs[i].mIndexB];
+    SpatialJoinResult& result = pairResults[i];
+    result.mIndexA = pairs[i].mIndexA;
+    result.mIndexB = pairs[i].mIndexB;
+
+    Clipper clipper;
+    clipper.IntersectWithContainment(polygonA, polygonB, result.mContours);
+  });
+
+  for(SpatialJoinResult& result : pairResults)
+  {
+    if(!result.mContours.empty())
+      results.push_back(std::move(result));
+  }
+}
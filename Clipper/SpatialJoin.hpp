@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+//-------------------------------------------------------------------SpatialJoinPair
+struct SpatialJoinPair
+{
+  size_t mIndexA = 0;
+  size_t mIndexB = 0;
+};
+
+//-------------------------------------------------------------------SpatialJoinResult
+struct SpatialJoinResult
+{
+  size_t mIndexA = 0;
+  size_t mIndexB = 0;
+  PointContourList mContours;
+};
+
+typedef Array<SpatialJoinResult> SpatialJoinResultList;
+
+//-------------------------------------------------------------------SpatialJoin
+// Overlays two polygon sets. Set B is bulk loaded into an STR packed r-tree and queried with every polygon in set A,
+// so only pairs whose aabbs overlap are ever clipped. The candidate pairs are then clipped in parallel.
+struct SpatialJoin
+{
+  // Finds every pair of polygons whose aabbs overlap, sorted by (indexA, indexB).
+  void FindCandidatePairs(const PointContourList& setA, const PointContourList& setB, Array<SpatialJoinPair>& pairs);
+  // Intersects every candidate pair, dropping pairs with an empty intersection.
+  // The results are always in (indexA, indexB) order, regardless of how many threads were used.
+  void Intersect(const PointContourList& setA, const PointContourList& setB, SpatialJoinResultList& results);
+
+  // Number of threads used to clip the candidate pairs. Zero uses the hardware concurrency.
+  size_t mThreadCount = 0;
+};
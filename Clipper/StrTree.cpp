@@ -0,0 +1,104 @@
+#include "StrTree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// Computes the Sort-Tile-Recursive ordering of the given aabbs. Consecutive runs of NodeCapacity items in the result form one node.
+static Array<size_t> ComputeStrOrder(const Array<Aabb>& aabbs)
+{
+  size_t count = aabbs.size();
+  Array<size_t> order(count);
+  std::iota(order.begin(), order.end(), size_t(0));
+
+  size_t nodeCount = (count + StrTree::NodeCapacity - 1) / StrTree::NodeCapacity;
+  size_t sliceCount = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+  size_t sliceSize = std::max(size_t(1), sliceCount) * StrTree::NodeCapacity;
+
+  // Ties are broken by index so the packing (and any results derived from it) is deterministic.
+  auto sortByAxis = [&aabbs](Array<size_t>::iterator begin, Array<size_t>::iterator end, int axis)
+  {
+    std::sort(begin, end, [&aabbs, axis](size_t lhs, size_t rhs)
+    {
+      Vec2 lhsCenter = aabbs[lhs].GetCenter();
+      Vec2 rhsCenter = aabbs[rhs].GetCenter();
+      float lhsValue = axis == 0 ? lhsCenter.x : lhsCenter.y;
+      float rhsValue = axis == 0 ? rhsCenter.x : rhsCenter.y;
+      if(lhsValue != rhsValue)
+        return lhsValue < rhsValue;
+      return lhs < rhs;
+    });
+  };
+
+  sortByAxis(order.begin(), order.end(), 0);
+  for(size_t sliceStart = 0; sliceStart < count; sliceStart += sliceSize)
+  {
+    size_t sliceEnd = std::min(count, sliceStart + sliceSize);
+    sortByAxis(order.begin() + sliceStart, order.begin() + sliceEnd, 1);
+  }
+  return order;
+}
+
+//-------------------------------------------------------------------StrTree
+void StrTree::Build(const Array<Aabb>& aabbs)
+{
+  Clear();
+  if(aabbs.empty())
+    return;
+
+  // Pack the entries into leaves
+  mEntryIndices = ComputeStrOrder(aabbs);
+  size_t entryCount = mEntryIndices.size();
+  mEntryAabbs.resize(entryCount);
+  for(size_t i = 0; i < entryCount; ++i)
+    mEntryAabbs[i] = aabbs[mEntryIndices[i]];
+
+  Array<Node> level;
+  for(size_t start = 0; start < entryCount; start += NodeCapacity)
+  {
+    Node leaf;
+    leaf.mFirstChild = start;
+    leaf.mChildCount = std::min(NodeCapacity, entryCount - start);
+    for(size_t i = 0; i < leaf.mChildCount; ++i)
+      leaf.mAabb.Expand(mEntryAabbs[start + i]);
+    level.push_back(leaf);
+  }
+
+  // Recursively pack each level until only the root is left. Each level is written out in
+  // packed order so that the parents can reference their children as a contiguous range.
+  while(level.size() > 1)
+  {
+    Array<Aabb> levelAabbs(level.size());
+    for(size_t i = 0; i < level.size(); ++i)
+      levelAabbs[i] = level[i].mAabb;
+    Array<size_t> order = ComputeStrOrder(levelAabbs);
+
+    size_t base = mNodes.size();
+    for(size_t index : order)
+      mNodes.push_back(level[index]);
+
+    Array<Node> parents;
+    for(size_t start = 0; start < order.size(); start += NodeCapacity)
+    {
+      Node parent;
+      parent.mIsLeaf = false;
+      parent.mFirstChild = base + start;
+      parent.mChildCount = std::min(NodeCapacity, order.size() - start);
+      for(size_t i = 0; i < parent.mChildCount; ++i)
+        parent.mAabb.Expand(mNodes[parent.mFirstChild + i].mAabb);
+      parents.push_back(parent);
+    }
+    level.swap(parents);
+  }
+
+  mNodes.push_back(level[0]);
+  mRoot = mNodes.size() - 1;
+}
+
+void StrTree::Clear()
+{
+  mNodes.clear();
+  mEntryAabbs.clear();
+  mEntryIndices.clear();
+  mRoot = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Clipper.hpp"
+
+//-------------------------------------------------------------------StrTree
+// A static r-tree bulk loaded with the Sort-Tile-Recursive packing. Every level is tiled into vertical
+// slices sorted by x and then packed by y, which gives near-optimal nodes for static data sets.
+// The tree only stores aabbs and the index of the item they came from.
+struct StrTree
+{
+  static constexpr size_t NodeCapacity = 16;
+
+  struct Node
+  {
+    Aabb mAabb;
+    // Leaves index into the entry arrays, internal nodes index into the node array.
+    size_t mFirstChild = 0;
+    size_t mChildCount = 0;
+    bool mIsLeaf = true;
+  };
+
+  void Build(const Array<Aabb>& aabbs);
+  void Clear();
+  bool IsEmpty() const { return mNodes.empty(); }
+
+  // Calls the callback with the item index of every entry overlapping the given aabb.
+  template <typename Callback>
+  void Query(const Aabb& aabb, Callback callback) const
+  {
+    if(mNodes.empty())
+      return;
+
+    Array<size_t> stack{mRoot};
+    while(!stack.empty())
+    {
+      const Node& node = mNodes[stack.back()];
+      stack.pop_back();
+      if(!node.mAabb.Overlaps(aabb))
+        continue;
+
+      size_t end = node.mFirstChild + node.mChildCount;
+      for(size_t i = node.mFirstChild; i < end; ++i)
+      {
+        if(!node.mIsLeaf)
+          stack.push_back(i);
+        else if(mEntryAabbs[i].Overlaps(aabb))
+          callback(mEntryIndices[i]);
+      }
+    }
+  }
+
+  Array<Node> mNodes;
+  // Entries stored in packed order so every leaf references a contiguous range.
+  Array<Aabb> mEntryAabbs;
+  Array<size_t> mEntryIndices;
+  size_t mRoot = 0;
+};
@@ -1,6 +1,21 @@
 #include "Clipper.hpp"
+#include "SpatialJoin.hpp"
+#include "ClipScene.hpp"
+#include "ChunkedTerrain.hpp"
+#include "ClipShape.hpp"
+#include "ClipCostModel.hpp"
+#include "ClipExpr.hpp"
+#include "PolylineClipper.hpp"
+#include "PolygonOffsetter.hpp"
+#include "ContourSimplifier.hpp"
+#include "PolygonTriangulator.hpp"
+#include "InterleavedContourSink.hpp"
+#include "FixedClipper.hpp"
+#include "ClipJob.hpp"
 
 #include "JsonSerializers.hpp"
+#include <cmath>
+#include <cstring>
 #include <filesystem>
 
 #define ErrorIf(expression, message) \
@@ -65,6 +80,14 @@ bool TestContours(const PointContourList& input, const PointContourList& expecte
   return true;
 }
 
+float ComputeTotalArea(const PointContourList& contours)
+{
+  float area = 0;
+  for(const PointContour& contour : contours)
+    area += ComputeSignedArea(contour);
+  return area;
+}
+
 void LoadPoint(JsonLoader& loader, Vec2& point)
 {
   size_t count = 0;
@@ -162,6 +185,1268 @@ void TestIntersection(JsonLoader& loader, PointContour& polyList, PointContour&
   ErrorIf(!passed, "Failed");
 }
 
+void TestXor(JsonLoader& loader, PointContour& polyList, PointContour& clipRegion)
+{
+  PointContourList expected;
+  if(loader.BeginMember("Subtraction"))
+  {
+    LoadContourList(loader, expected);
+    loader.EndMember();
+  }
+
+  // The xor is both subtractions, traced from one set of lists
+  Clipper clipper;
+  PointContourList reverseSubtraction;
+  clipper.Subtract(clipRegion, polyList, reverseSubtraction);
+  expected.insert(expected.end(), reverseSubtraction.begin(), reverseSubtraction.end());
+
+  PointContourList results;
+  clipper.Xor(polyList, clipRegion, results);
+  ErrorIf(!TestContours(results, expected), "Failed");
+
+  ClipOptions options;
+  options.mEngine = ClipEngine::Scanline;
+  PointContourList scanlineResults;
+  clipper.Xor(polyList, clipRegion, options, scanlineResults);
+  ErrorIf(std::abs(std::abs(ComputeTotalArea(scanlineResults)) - std::abs(ComputeTotalArea(results))) > 0.01f, "Failed");
+}
+
+void TestComputeAll(JsonLoader& loader, PointContour& polyList, PointContour& clipRegion)
+{
+  PointContour expectedUnion;
+  PointContourList expectedSubtraction;
+  PointContourList expectedIntersection;
+  if(loader.BeginMember("Union"))
+  {
+    LoadContour(loader, expectedUnion);
+    loader.EndMember();
+  }
+  if(loader.BeginMember("Subtraction"))
+  {
+    LoadContourList(loader, expectedSubtraction);
+    loader.EndMember();
+  }
+  if(loader.BeginMember("Intersection"))
+  {
+    LoadContourList(loader, expectedIntersection);
+    loader.EndMember();
+  }
+
+  Clipper clipper;
+  PointContourList expectedReverseSubtraction;
+  clipper.Subtract(clipRegion, polyList, expectedReverseSubtraction);
+  PointContourList expectedXor;
+  clipper.Xor(polyList, clipRegion, expectedXor);
+
+  ClipResultSet results;
+  clipper.ComputeAll(polyList, clipRegion, ClipResultFlags::All, results);
+  ErrorIf(results.mComputed != ClipResultFlags::All, "Failed");
+  // The outer loop of the union comes first, followed by any holes it closes off
+  ClipOptions scanline;
+  scanline.mEngine = ClipEngine::Scanline;
+  PointContourList scanlineUnion;
+  clipper.Union(polyList, clipRegion, scanline, scanlineUnion);
+  ErrorIf(results.mUnion.empty() || !TestContours(PointContourList{results.mUnion[0]}, PointContourList{expectedUnion}), "Failed");
+  ErrorIf(results.mUnion.size() != scanlineUnion.size(), "Failed");
+  ErrorIf(std::abs(std::abs(ComputeTotalArea(results.mUnion)) - std::abs(ComputeTotalArea(scanlineUnion))) > 0.01f, "Failed");
+  ErrorIf(!TestContours(results.mSubtraction, expectedSubtraction), "Failed");
+  ErrorIf(!TestContours(results.mReverseSubtraction, expectedReverseSubtraction), "Failed");
+  ErrorIf(!TestContours(results.mIntersection, expectedIntersection), "Failed");
+  ErrorIf(!TestContours(results.mXor, expectedXor), "Failed");
+
+  // Results that weren't asked for stay empty, even when they were traced to build the xor
+  clipper.ComputeAll(polyList, clipRegion, ClipResultFlags::Xor | ClipResultFlags::Intersection, results);
+  ErrorIf(!results.mSubtraction.empty() || !results.mUnion.empty(), "Failed");
+  ErrorIf(!TestContours(results.mIntersection, expectedIntersection), "Failed");
+  ErrorIf(!TestContours(results.mXor, expectedXor), "Failed");
+}
+
+void TestScanline(JsonLoader& loader, PointContour& polyList, PointContour& clipRegion)
+{
+  PointContour expectedUnion;
+  PointContourList expectedSubtraction;
+  PointContourList expectedIntersection;
+  if(loader.BeginMember("Union"))
+  {
+    LoadContour(loader, expectedUnion);
+    loader.EndMember();
+  }
+  if(loader.BeginMember("Subtraction"))
+  {
+    LoadContourList(loader, expectedSubtraction);
+    loader.EndMember();
+  }
+  if(loader.BeginMember("Intersection"))
+  {
+    LoadContourList(loader, expectedIntersection);
+    loader.EndMember();
+  }
+
+  // The test data winds clockwise
+  ClipOptions options;
+  options.mEngine = ClipEngine::Scanline;
+  options.mClockwiseOutput = true;
+  PointContourList results;
+  Clipper clipper;
+  clipper.Union(polyList, clipRegion, options, results);
+  // The expected unions come from the Weiler-Atherton engine which drops holes, so only compare the outer contours
+  PointContourList outerContours;
+  for(const PointContour& contour : results)
+  {
+    if(ComputeSignedArea(contour) < 0)
+      outerContours.push_back(contour);
+  }
+  ErrorIf(!TestContours(outerContours, PointContourList{expectedUnion}), "Failed");
+  clipper.Subtract(polyList, clipRegion, options, results);
+  ErrorIf(!TestContours(results, expectedSubtraction), "Failed");
+  clipper.Intersect(polyList, clipRegion, options, results);
+  ErrorIf(!TestContours(results, expectedIntersection), "Failed");
+}
+
+void TestPredicates(JsonLoader& loader, PointContour& polyList, PointContour& clipRegion)
+{
+  PointContourList expected;
+  if(loader.BeginMember("Intersection"))
+  {
+    LoadContourList(loader, expected);
+    loader.EndMember();
+  }
+
+  // The predicates have to agree with the full boolean operation
+  Clipper clipper;
+  bool intersects = clipper.Intersects(polyList, clipRegion);
+  ErrorIf(intersects != !expected.empty(), "Failed");
+  ErrorIf(clipper.Disjoint(polyList, clipRegion) == intersects, "Failed");
+  ErrorIf(clipper.Touches(polyList, clipRegion), "Failed");
+}
+
+void TestPredicates()
+{
+  PointContour square{{0, 0}, {0, 4}, {4, 4}, {4, 0}};
+  PointContour inner{{1, 1}, {1, 2}, {2, 2}, {2, 1}};
+  PointContour far{{10, 10}, {10, 11}, {11, 11}, {11, 10}};
+  PointContour adjacent{{4, 0}, {4, 4}, {8, 4}, {8, 0}};
+
+  Clipper clipper;
+  ErrorIf(!clipper.Intersects(square, inner), "Failed");
+  ErrorIf(!clipper.Contains(square, inner), "Failed");
+  ErrorIf(clipper.Contains(inner, square), "Failed");
+  ErrorIf(clipper.Touches(square, inner), "Failed");
+  ErrorIf(!clipper.Disjoint(square, far), "Failed");
+  ErrorIf(!clipper.Touches(square, adjacent), "Failed");
+  ErrorIf(!clipper.Intersects(square, adjacent), "Failed");
+  ErrorIf(clipper.Contains(square, adjacent), "Failed");
+
+  // Coincident boundaries only touch when the interiors are on opposite sides
+  PointContour split{{0, 0}, {0, 2}, {0, 4}, {4, 4}, {4, 0}};
+  PointContour reversed(square.rbegin(), square.rend());
+  PointContour partial{{4, 1}, {4, 3}, {6, 3}, {6, 1}};
+  PointContour half{{0, 0}, {0, 4}, {2, 4}, {2, 0}};
+  ErrorIf(clipper.Touches(square, square), "Failed");
+  ErrorIf(clipper.Touches(square, split), "Failed");
+  ErrorIf(clipper.Touches(reversed, square), "Failed");
+  ErrorIf(!clipper.Touches(square, partial), "Failed");
+  ErrorIf(clipper.Touches(square, half), "Failed");
+}
+
+PointContour MakeSquare(float x, float y, float size)
+{
+  return PointContour{{x, y}, {x, y + size}, {x + size, y + size}, {x + size, y}};
+}
+
+void TestSpatialJoin()
+{
+  PointContourList setA;
+  PointContourList setB;
+  for(int y = 0; y < 8; ++y)
+  {
+    for(int x = 0; x < 8; ++x)
+    {
+      setA.push_back(MakeSquare(x * 3.0f, y * 3.0f, 2.0f));
+      setB.push_back(MakeSquare(x * 3.0f + 1.5f, y * 3.0f + 0.5f, 1.0f));
+    }
+  }
+  // One polygon fully inside another to exercise the containment case
+  setB.push_back(MakeSquare(0.25f, 0.25f, 0.5f));
+
+  SpatialJoin join;
+  join.mThreadCount = 4;
+  SpatialJoinResultList results;
+  join.Intersect(setA, setB, results);
+
+  // Compare against the brute force overlay
+  size_t resultIndex = 0;
+  Clipper clipper;
+  for(size_t a = 0; a < setA.size(); ++a)
+  {
+    for(size_t b = 0; b < setB.size(); ++b)
+    {
+      if(!clipper.Intersects(setA[a], setB[b]))
+        continue;
+      ErrorIf(resultIndex >= results.size(), "Failed");
+      const SpatialJoinResult& result = results[resultIndex++];
+      ErrorIf(result.mIndexA != a || result.mIndexB != b, "Failed");
+
+      PointContourList expected;
+      clipper.Intersect(setA[a], setB[b], expected);
+      if(expected.empty())
+        expected.push_back(setB[b]);
+      ErrorIf(!TestContours(result.mContours, expected), "Failed");
+    }
+  }
+  ErrorIf(resultIndex != results.size(), "Failed");
+}
+
+void TestClipScene()
+{
+  ClipScene scene;
+  Array<ClipScene::ObjectId> objects;
+  for(int i = 0; i < 16; ++i)
+  {
+    ClipTransform transform;
+    transform.mTranslation = Vec2(i * 1.5f, 0.5f * (i % 2));
+    objects.push_back(scene.AddObject(MakeSquare(0, 0, 2), transform));
+  }
+  scene.Update();
+  ErrorIf(scene.mStats.mPairsRecomputed != 15, "Failed");
+
+  // Moving a single object should only re-clip the pairs it's part of
+  ClipTransform transform;
+  transform.mTranslation = Vec2(7 * 1.5f, 0.75f);
+  scene.SetTransform(objects[7], transform);
+  scene.Update();
+  ErrorIf(scene.mStats.mObjectsUpdated != 1, "Failed");
+  ErrorIf(scene.mStats.mPairsRecomputed != 2, "Failed");
+  ErrorIf(scene.mStats.mPairsCached != 13, "Failed");
+
+  Clipper clipper;
+  for(size_t i = 0; i + 1 < objects.size(); ++i)
+  {
+    const PointContourList* cached = scene.FindIntersection(objects[i], objects[i + 1]);
+    ErrorIf(cached == nullptr, "Failed");
+    PointContourList expected;
+    clipper.IntersectWithContainment(scene.GetWorldPoints(objects[i]), scene.GetWorldPoints(objects[i + 1]), expected);
+    ErrorIf(!TestContours(*cached, expected), "Failed");
+  }
+
+  // Moving far away removes the pairs
+  transform.mTranslation = Vec2(100, 100);
+  scene.SetTransform(objects[0], transform);
+  scene.Update();
+  ErrorIf(scene.FindIntersection(objects[0], objects[1]) != nullptr, "Failed");
+  scene.RemoveObject(objects[5]);
+  scene.Update();
+  ErrorIf(scene.FindIntersection(objects[4], objects[5]) != nullptr, "Failed");
+}
+
+void TestChunkedTerrain()
+{
+  PointContour terrain = MakeSquare(0, 0, 10);
+  ChunkedTerrain chunks;
+  chunks.Build(PointContourList{terrain}, 3);
+  ErrorIf(std::abs(ComputeTotalArea(chunks.GetContours()) - ComputeSignedArea(terrain)) > 0.01f, "Failed");
+
+  // A cutter biting into the top edge should match carving the whole terrain at once
+  PointContour cutter = MakeSquare(4, 8, 4);
+  chunks.Carve(cutter);
+  ErrorIf(chunks.mStats.mChunksTouched != 6, "Failed");
+  PointContourList expected;
+  Clipper clipper;
+  clipper.Subtract(terrain, cutter, expected);
+  ErrorIf(!TestContours(chunks.GetContours(), expected), "Failed");
+
+  // Batched cutters fully inside the terrain leave holes behind
+  chunks.QueueCarve(MakeSquare(1, 1, 1));
+  chunks.QueueCarve(MakeSquare(5, 2, 2));
+  chunks.Flush();
+  const PointContourList& contours = chunks.GetContours();
+  ErrorIf(contours.size() != 3, "Failed");
+  float expectedArea = ComputeTotalArea(expected) + 1 + 4;
+  ErrorIf(std::abs(ComputeTotalArea(contours) - expectedArea) > 0.01f, "Failed");
+
+  // A concave cutter that has to be split keeps every one of its edges in the hole
+  ChunkedTerrain single;
+  single.Build(PointContourList{MakeSquare(0, 0, 20)}, 100);
+  single.Carve(PointContour{{2, 2}, {2, 4}, {4, 4}, {4, 6}, {6, 6}, {6, 2}});
+  ErrorIf(single.mStats.mPiecesSplit != 1, "Failed");
+  const PointContourList& carved = single.GetContours();
+  ErrorIf(carved.size() != 2, "Failed");
+  for(const PointContour& contour : carved)
+  {
+    float area = ComputeSignedArea(contour);
+    if(area > 0)
+      ErrorIf(contour.size() != 6 || std::abs(area - 12) > 0.01f, "Failed");
+    else
+      ErrorIf(std::abs(area + 400) > 0.01f, "Failed");
+  }
+
+  // A later cutter whose edge runs partly along an earlier split line keeps that part of the edge
+  ChunkedTerrain overlapping;
+  overlapping.Build(PointContourList{MakeSquare(0, 0, 20)}, 10);
+  overlapping.Carve(PointContour{{12, 3}, {12, 4}, {14, 4}, {14, 3}});
+  ErrorIf(overlapping.mStats.mPiecesSplit != 1, "Failed");
+  overlapping.Carve(PointContour{{12, 5}, {12, 7}, {13, 7}, {13, 5}});
+  const PointContourList& holes = overlapping.GetContours();
+  ErrorIf(holes.size() != 3 || std::abs(ComputeTotalArea(holes) + 396) > 0.01f, "Failed");
+  for(const PointContour& contour : holes)
+    ErrorIf(contour.size() != 4, "Failed");
+}
+
+void TestClipShapes()
+{
+  const float pi = 3.14159265f;
+  PointContour square = MakeSquare(0, 0, 10);
+  ClipShapeOptions options;
+  options.mArcTolerance = 0.001f;
+  Clipper clipper;
+  PointContourList results;
+
+  // Half of the circle overlaps the square
+  ClipShape circle = ClipShape::Circle(Vec2(10, 5), 2);
+  clipper.Subtract(square, circle, options, results);
+  ErrorIf(results.size() != 1, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) + 100 - 2 * pi) > 0.01f, "Failed");
+  clipper.Intersect(square, circle, options, results);
+  ErrorIf(results.size() != 1, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) + 2 * pi) > 0.01f, "Failed");
+
+  // A circle fully inside leaves a hole
+  clipper.Subtract(square, ClipShape::Circle(Vec2(5, 5), 1), options, results);
+  ErrorIf(results.size() != 2, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) + 100 - pi) > 0.01f, "Failed");
+
+  // A capsule through the middle cuts the square in two
+  ClipShape capsule = ClipShape::Capsule(Vec2(-2, 5), Vec2(12, 5), 1);
+  clipper.Subtract(square, capsule, options, results);
+  ErrorIf(results.size() != 2, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) + 80) > 0.01f, "Failed");
+  clipper.Intersect(square, capsule, options, results);
+  ErrorIf(results.size() != 1, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) + 20) > 0.01f, "Failed");
+
+  // A quarter of a circle centered on a corner
+  ClipShape sector = ClipShape::Sector(Vec2(0, 0), 4, -pi * 0.25f, pi);
+  clipper.Intersect(square, sector, options, results);
+  ErrorIf(std::abs(ComputeTotalArea(results) + 4 * pi) > 0.01f, "Failed");
+
+  // Coarser output scales emit far fewer arc points
+  ClipShapeOptions coarse;
+  coarse.mOutputScale = 0.05f;
+  clipper.Intersect(square, circle, coarse, results);
+  ErrorIf(results[0].size() > 16, "Failed");
+}
+
+void TestScanline()
+{
+  ClipOptions options;
+  options.mEngine = ClipEngine::Scanline;
+  Clipper clipper;
+  PointContourList results;
+
+  // Subtracting a square fully inside leaves a hole, wound opposite to the outer contour
+  clipper.Subtract(MakeSquare(0, 0, 10), MakeSquare(2, 2, 2), options, results);
+  ErrorIf(results.size() != 2, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) - 96) > 0.01f, "Failed");
+
+  // A self-intersecting bow tie is two triangles under even-odd
+  PointContour bowTie{{0, 0}, {4, 4}, {4, 0}, {0, 4}};
+  clipper.Union(bowTie, MakeSquare(10, 10, 1), options, results);
+  ErrorIf(results.size() != 3, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) - 9) > 0.01f, "Failed");
+
+  // Overlapping contours of one operand only count once under non-zero
+  options.mFillRule = ClipFillRule::NonZero;
+  PointContourList overlapping{MakeSquare(0, 0, 4), MakeSquare(2, 0, 4)};
+  clipper.Execute(ClipOperation::Intersect, overlapping, PointContourList{MakeSquare(1, 1, 2)}, options, results);
+  ErrorIf(results.size() != 1, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) - 4) > 0.01f, "Failed");
+  options.mFillRule = ClipFillRule::EvenOdd;
+  clipper.Execute(ClipOperation::Intersect, overlapping, PointContourList{MakeSquare(1, 1, 2)}, options, results);
+  ErrorIf(std::abs(ComputeTotalArea(results) - 2) > 0.01f, "Failed");
+}
+
+void TestEngineSelection()
+{
+  PointContour pentagram{{0, 3}, {2, -3}, {-3, 1}, {3, 1}, {-2, -3}};
+  ErrorIf(IsConvex(pentagram), "Failed");
+  ErrorIf(!IsConvex(MakeSquare(0, 0, 1)), "Failed");
+  ErrorIf(!IsConvex(PointContour{{0, 0}, {0, 1}, {0, 2}, {2, 2}, {2, 0}}), "Failed");
+  ErrorIf(!IsAxisAlignedRectangle(MakeSquare(0, 0, 1)), "Failed");
+
+  ClipStats stats;
+  ClipOptions options;
+  options.mStats = &stats;
+  options.mClockwiseOutput = true;
+  Clipper clipper;
+  PointContourList results;
+
+  // Convex polygons against a rectangle take the cheapest fast path
+  PointContour diamond{{0, 2}, {2, 4}, {4, 2}, {2, 0}};
+  clipper.Intersect(diamond, MakeSquare(2, 0, 4), options, results);
+  ErrorIf(stats.mEngineUsed != ClipEngine::Rectangle, "Failed");
+  ErrorIf(results.size() != 1 || std::abs(ComputeTotalArea(results) + 4) > 0.001f, "Failed");
+  clipper.Intersect(MakeSquare(2, 0, 4), diamond, options, results);
+  ErrorIf(stats.mEngineUsed != ClipEngine::Convex, "Failed");
+  ErrorIf(results.size() != 1 || std::abs(ComputeTotalArea(results) + 4) > 0.001f, "Failed");
+
+  // Disjoint operands never reach an engine
+  clipper.Union(diamond, MakeSquare(10, 10, 1), options, results);
+  ErrorIf(stats.mEngineUsed != ClipEngine::Automatic || results.size() != 2, "Failed");
+
+  // Boundaries that touch without crossing keep the model away from Weiler-Atherton, which can't trace them
+  clipper.Union(diamond, MakeSquare(2, 0, 4), options, results);
+  ErrorIf(!stats.mInputStats.mBoundariesTouch || stats.mEngineUsed == ClipEngine::WeilerAtherton, "Failed");
+  ErrorIf(results.size() != 1 || std::abs(ComputeTotalArea(results) + 20) > 0.001f, "Failed");
+
+  // Nested operands leave a hole whichever engine the model picks
+  clipper.Subtract(MakeSquare(0, 0, 10), MakeSquare(2, 2, 2), options, results);
+  ErrorIf(results.size() != 2 || std::abs(ComputeTotalArea(results) + 96) > 0.001f, "Failed");
+
+  // Whatever the model picks has to agree with the scanline engine
+  PointContour star;
+  for(size_t i = 0; i < 40; ++i)
+  {
+    float angle = -float(i) * 6.2831853f / 40;
+    float radius = (i % 2) ? 2.0f : 5.0f;
+    star.push_back(Vec2(radius * std::cos(angle), radius * std::sin(angle)));
+  }
+  ClipOptions scanline;
+  scanline.mEngine = ClipEngine::Scanline;
+  scanline.mClockwiseOutput = true;
+  PointContourList expected;
+  clipper.Subtract(star, MakeSquare(-1, -1, 8), scanline, expected);
+  clipper.Subtract(star, MakeSquare(-1, -1, 8), options, results);
+  ErrorIf(stats.mInputStats.mEstimatedCrossings <= 0, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(results) - ComputeTotalArea(expected)) > 0.01f, "Failed");
+
+  // Nested and disjoint operands given straight to the Weiler-Atherton engine come back by containment
+  ClipOptions weilerAtherton = scanline;
+  weilerAtherton.mEngine = ClipEngine::WeilerAtherton;
+  PointContour outer = MakeSquare(0, 0, 10);
+  for(const PointContour& inner : {MakeSquare(2, 2, 2), MakeSquare(20, 20, 2)})
+  {
+    for(unsigned i = 0; i < 8; ++i)
+    {
+      ClipOperation operation = static_cast<ClipOperation>(i % 4);
+      PointContourList polygons{i < 4 ? outer : inner};
+      PointContourList clipRegions{i < 4 ? inner : outer};
+      clipper.Execute(operation, polygons, clipRegions, scanline, expected);
+      clipper.Execute(operation, polygons, clipRegions, weilerAtherton, results);
+      ErrorIf(results.size() != expected.size() || std::abs(ComputeTotalArea(results) - ComputeTotalArea(expected)) > 0.001f, "Failed");
+    }
+  }
+
+  // A union that closes off a hole keeps it whichever engine runs
+  PointContour cShape{{0, 0}, {6, 0}, {6, 1}, {1, 1}, {1, 5}, {6, 5}, {6, 6}, {0, 6}};
+  PointContour bar{{5, -1}, {7, -1}, {7, 7}, {5, 7}};
+  clipper.Union(cShape, bar, scanline, expected);
+  ErrorIf(expected.size() != 2 || std::abs(std::abs(ComputeTotalArea(expected)) - 30) > 0.01f, "Failed");
+  for(ClipEngine engine : {ClipEngine::Automatic, ClipEngine::WeilerAtherton})
+  {
+    options.mEngine = engine;
+    clipper.Union(cShape, bar, options, results);
+    ErrorIf(results.size() != 2 || std::abs(ComputeTotalArea(results) - ComputeTotalArea(expected)) > 0.01f, "Failed");
+  }
+
+  // Forcing a fast path on inputs it can't handle falls back to the scanline engine
+  options.mEngine = ClipEngine::Convex;
+  clipper.Intersect(star, MakeSquare(-1, -1, 8), options, results);
+  ErrorIf(stats.mEngineUsed != ClipEngine::Scanline, "Failed");
+}
+
+void TestNormalization()
+{
+  Clipper clipper;
+  PointContour bowTie{{0, 0}, {0, 4}, {4, 0}, {4, 4}};
+  PointContour pentagram{{0, 3}, {2, -3}, {-3, 1}, {3, 1}, {-2, -3}};
+  ErrorIf(!clipper.HasSelfIntersections(bowTie), "Failed");
+  ErrorIf(!clipper.HasSelfIntersections(pentagram), "Failed");
+  ErrorIf(clipper.HasSelfIntersections(MakeSquare(0, 0, 1)), "Failed");
+
+  // The bow tie splits into its two triangles, wound clockwise for the Weiler-Atherton engine
+  Array<ClipVertexList> pieces;
+  clipper.Normalize(bowTie, ClipFillRule::EvenOdd, pieces);
+  ErrorIf(pieces.size() != 2, "Failed");
+  PointContourList contours;
+  clipper.Normalize(bowTie, ClipFillRule::EvenOdd, contours);
+  ErrorIf(contours.size() != 2 || std::abs(ComputeTotalArea(contours) + 8) > 0.001f, "Failed");
+
+  // The pentagram's center has a winding number of two, it's a gap under even-odd and filled under non-zero.
+  // The pentagram winds clockwise so only the negative rule keeps it.
+  clipper.Normalize(pentagram, ClipFillRule::EvenOdd, contours);
+  ErrorIf(contours.size() != 5, "Failed");
+  float pointsArea = ComputeTotalArea(contours);
+  clipper.Normalize(pentagram, ClipFillRule::NonZero, contours);
+  ErrorIf(contours.size() != 1 || contours[0].size() != 10, "Failed");
+  float outlineArea = ComputeTotalArea(contours);
+  ErrorIf(outlineArea >= pointsArea, "Failed");
+  clipper.Normalize(pentagram, ClipFillRule::Negative, contours);
+  ErrorIf(contours.size() != 1, "Failed");
+  clipper.Normalize(pentagram, ClipFillRule::Positive, contours);
+  ErrorIf(!contours.empty(), "Failed");
+
+  // Normalized pieces feed straight into the Weiler-Atherton engine and agree with the scanline engine
+  ClipStats stats;
+  ClipOptions options;
+  options.mStats = &stats;
+  options.mFillRule = ClipFillRule::NonZero;
+  options.mEngine = ClipEngine::WeilerAtherton;
+  options.mNormalizeInput = true;
+  PointContourList results;
+  clipper.Intersect(pentagram, MakeSquare(-1, -4, 6), options, results);
+  ErrorIf(stats.mEngineUsed != ClipEngine::WeilerAtherton, "Failed");
+  ClipOptions scanline;
+  scanline.mEngine = ClipEngine::Scanline;
+  scanline.mFillRule = ClipFillRule::NonZero;
+  PointContourList expected;
+  clipper.Intersect(pentagram, MakeSquare(-1, -4, 6), scanline, expected);
+  ErrorIf(std::abs(ComputeTotalArea(results) - ComputeTotalArea(expected)) > 0.01f, "Failed");
+
+  // Automatic selection never hands self-intersecting operands to the Weiler-Atherton engine
+  options.mEngine = ClipEngine::Automatic;
+  options.mNormalizeInput = false;
+  clipper.Subtract(pentagram, MakeSquare(-1, -4, 6), options, results);
+  ErrorIf(stats.mEngineUsed == ClipEngine::WeilerAtherton, "Failed");
+}
+
+void TestClipExpr()
+{
+  // ((A u B) - C) n D
+  ClipExpr expr;
+  ClipExpr::NodeId a = expr.AddOperand(MakeSquare(0, 0, 4));
+  ClipExpr::NodeId b = expr.AddOperand(MakeSquare(2, 0, 4));
+  ClipExpr::NodeId c = expr.AddOperand(MakeSquare(1, 1, 2));
+  ClipExpr::NodeId d = expr.AddOperand(MakeSquare(0, 0, 3));
+  ClipExpr::NodeId root = expr.Intersect(expr.Subtract(expr.Union(a, b), c), d);
+  PointContourList results;
+  expr.Evaluate(root, results);
+  ErrorIf(std::abs(ComputeTotalArea(results) - 5) > 0.001f, "Failed");
+  ErrorIf(expr.mStats.mSweeps != 3, "Failed");
+
+  // Chained subtractions fuse into one sweep, and a subtracted union subtracts each of its operands
+  expr.Clear();
+  ClipExpr::NodeId plate = expr.AddOperand(MakeSquare(0, 0, 10));
+  ClipExpr::NodeId holes = expr.Union(expr.AddOperand(MakeSquare(1, 1, 1)), expr.AddOperand(MakeSquare(3, 1, 1)));
+  root = expr.Subtract(expr.Subtract(plate, holes), expr.AddOperand(MakeSquare(5, 1, 1)));
+  expr.Evaluate(root, results);
+  ErrorIf(results.size() != 4 || std::abs(ComputeTotalArea(results) - 97) > 0.001f, "Failed");
+  ErrorIf(expr.mStats.mSweeps != 1 || expr.mStats.mFusedOperations != 2, "Failed");
+
+  // A self-intersecting operand is normalized under the fill rule, and an n-ary xor is one sweep
+  expr.Clear();
+  PointContour bowTie{{0, 0}, {0, 4}, {4, 0}, {4, 4}};
+  root = expr.Xor(expr.Xor(expr.AddOperand(bowTie), expr.AddOperand(MakeSquare(0, 0, 4))), expr.AddOperand(MakeSquare(10, 10, 1)));
+  expr.mThreadCount = 4;
+  expr.Evaluate(root, results);
+  ErrorIf(std::abs(ComputeTotalArea(results) - 9) > 0.001f, "Failed");
+  ErrorIf(expr.mStats.mSweeps != 2 || expr.mStats.mFusedOperations != 1, "Failed");
+
+  // Nested levels share out the threads instead of each starting their own, and match a serial evaluation
+  expr.Clear();
+  Array<ClipExpr::NodeId> level;
+  for(size_t i = 0; i < 16; ++i)
+    level.push_back(expr.AddOperand(MakeSquare(float(i % 4) * 3, float(i / 4) * 3, 4)));
+  for(size_t depth = 0; level.size() > 1; ++depth)
+  {
+    Array<ClipExpr::NodeId> next;
+    for(size_t i = 0; i < level.size(); i += 2)
+      next.push_back(depth % 2 ? expr.Subtract(expr.Union(level[i], level[i + 1]), expr.AddOperand(MakeSquare(float(i), float(i), 1))) : expr.Xor(level[i], level[i + 1]));
+    level = next;
+  }
+  PointContourList serial;
+  expr.mThreadCount = 1;
+  expr.Evaluate(level[0], serial);
+  expr.mThreadCount = 0;
+  expr.Evaluate(level[0], results);
+  ErrorIf(serial.empty() || results.size() != serial.size() || std::abs(ComputeTotalArea(results) - ComputeTotalArea(serial)) > 0.001f, "Failed");
+}
+
+void TestMultiCutterSubtract()
+{
+  // Two overlapping holes merge into one, one cutter notches the edge and one misses the plate entirely
+  Clipper clipper;
+  PointContour plate = MakeSquare(0, 0, 10);
+  PointContourList cutters{MakeSquare(1, 1, 2), MakeSquare(2, 2, 2), MakeSquare(5, 5, 1), MakeSquare(9, 4, 2), MakeSquare(20, 20, 1)};
+  std::reverse(cutters[1].begin(), cutters[1].end());
+  PointContourList results;
+  clipper.Subtract(plate, cutters, results);
+  ErrorIf(results.size() != 3 || std::abs(std::abs(ComputeTotalArea(results)) - 90) > 0.001f, "Failed");
+
+  // A cutter covering the whole plate removes it
+  clipper.Subtract(plate, PointContourList{MakeSquare(-1, -1, 12)}, results);
+  ErrorIf(!results.empty(), "Failed");
+
+  // Four bars merge into a ring, which leaves an island of the plate inside of it
+  PointContourList bars{
+    {{3, 3}, {7, 3}, {7, 4}, {3, 4}}, {{3, 6}, {7, 6}, {7, 7}, {3, 7}},
+    {{3, 3}, {4, 3}, {4, 7}, {3, 7}}, {{6, 3}, {7, 3}, {7, 7}, {6, 7}}};
+  clipper.Subtract(plate, bars, results);
+  ErrorIf(results.size() != 3 || std::abs(std::abs(ComputeTotalArea(results)) - 88) > 0.001f, "Failed");
+}
+
+void TestPolylineClipping()
+{
+  PolylineClipper clipper;
+  PointContour road{{-1, 1}, {5, 1}, {5, 3}, {2, 3}, {2, 6}};
+  PointContourList inside;
+  PointContourList outside;
+  clipper.Clip(road, MakeSquare(0, 0, 4), inside, outside);
+  ErrorIf(inside.size() != 2 || outside.size() != 3, "Failed");
+  PointContour expectedInside{{4, 3}, {2, 3}, {2, 4}};
+  PointContour expectedOutside{{4, 1}, {5, 1}, {5, 3}, {4, 3}};
+  ErrorIf(inside[1] != expectedInside || outside[1] != expectedOutside, "Failed");
+
+  // A hole in the clip region splits the inside run
+  clipper.Clip(road, PointContourList{MakeSquare(0, 0, 4), MakeSquare(1, 0.5f, 1)}, inside, outside);
+  ErrorIf(inside.size() != 3 || outside.size() != 4, "Failed");
+
+  // Five segments so both the four wide kernel and the remainder run
+  SegmentBatch segments;
+  segments.Add({-2, 2}, {2, 2});
+  segments.Add({1, 1}, {3, 3});
+  segments.Add({5, 5}, {6, 6});
+  segments.Add({2, -2}, {2, 6});
+  segments.Add({3, 2}, {6, 2});
+  float expectedEnter[] = {0.5f, 0, 1, 0.25f, 0};
+  float expectedExit[] = {1, 1, 0, 0.75f, 1.0f / 3.0f};
+  Array<float> enterTimes;
+  Array<float> exitTimes;
+  PolylineClipper::ClipSegments(segments, MakeSquare(0, 0, 4), enterTimes, exitTimes);
+  for(size_t i = 0; i < segments.GetCount(); ++i)
+    ErrorIf(std::abs(enterTimes[i] - expectedEnter[i]) > 0.0001f || std::abs(exitTimes[i] - expectedExit[i]) > 0.0001f, "Failed");
+}
+
+// Checks that every output vertex is where its source says it is on the inputs.
+bool SourcesMatch(const PointContour& polygon, const PointContour& clipRegion, const PointContourList& contours, const ClipProvenance& provenance)
+{
+  if(provenance.GetContourCount() != contours.size())
+    return false;
+  for(size_t i = 0; i < contours.size(); ++i)
+  {
+    size_t begin = provenance.GetContourBegin(i);
+    if(provenance.GetContourEnd(i) - begin != contours[i].size())
+      return false;
+    for(size_t j = 0; j < contours[i].size(); ++j)
+    {
+      const ClipVertexSource& source = provenance.mSources[begin + j];
+      const PointContour& input = source.mOperand == ClipOperand::Polygon ? polygon : clipRegion;
+      const Vec2& start = input[source.mEdgeIndex];
+      const Vec2& end = input[(source.mEdgeIndex + 1) % input.size()];
+      if(Vec2::DistanceSq(start + (end - start) * source.mTime, contours[i][j]) > 1e-8f)
+        return false;
+    }
+  }
+  return true;
+}
+
+void TestProvenance()
+{
+  Clipper clipper;
+  ClipProvenance provenance;
+  clipper.mProvenance = &provenance;
+  PointContour polygon = MakeSquare(0, 0, 4);
+  PointContour clipRegion{{2, -1}, {3, 2}, {7, 1}, {6, 5}, {1, 3}};
+  std::reverse(clipRegion.begin(), clipRegion.end());
+  PointContourList results;
+  clipper.Intersect(polygon, clipRegion, results);
+  ErrorIf(results.empty() || !SourcesMatch(polygon, clipRegion, results, provenance), "Failed");
+  clipper.Xor(polygon, clipRegion, results);
+  ErrorIf(results.empty() || !SourcesMatch(polygon, clipRegion, results, provenance), "Failed");
+
+  // Counter-clockwise operands are reversed for the engine but sources still index the input order
+  PointContour ccwPolygon(polygon.rbegin(), polygon.rend());
+  PointContour ccwClipRegion(clipRegion.rbegin(), clipRegion.rend());
+  ClipOptions options;
+  options.mEngine = ClipEngine::WeilerAtherton;
+  clipper.Subtract(ccwPolygon, ccwClipRegion, options, results);
+  ErrorIf(results.empty() || !SourcesMatch(ccwPolygon, ccwClipRegion, results, provenance), "Failed");
+
+  // Other engines don't record provenance
+  options.mEngine = ClipEngine::Scanline;
+  clipper.Subtract(ccwPolygon, ccwClipRegion, options, results);
+  ErrorIf(provenance.GetContourCount() != 0 || !provenance.mSources.empty(), "Failed");
+}
+
+void TestAttributeChannels()
+{
+  // Attributes that are linear in the position come out matching the clipped points exactly
+  Clipper clipper;
+  PointContour polygon = MakeSquare(0, 0, 4);
+  PointContour clipRegion{{1, 3}, {6, 5}, {7, 1}, {3, 2}, {2, -1}};
+  ClipAttributeChannel<Vec2> uvs;
+  ClipAttributeChannel<float> heights;
+  uvs.mPolygon.assign(polygon.begin(), polygon.end());
+  uvs.mClipRegion.assign(clipRegion.begin(), clipRegion.end());
+  for(const Vec2& point : polygon)
+    heights.mPolygon.push_back(point.x + 2 * point.y);
+  for(const Vec2& point : clipRegion)
+    heights.mClipRegion.push_back(point.x + 2 * point.y);
+  clipper.mAttributeChannels = {&uvs, &heights};
+
+  PointContourList results;
+  ClipOptions options;
+  options.mEngine = ClipEngine::WeilerAtherton;
+  clipper.Union(polygon, clipRegion, options, results);
+  size_t index = 0;
+  for(const PointContour& contour : results)
+  {
+    for(const Vec2& point : contour)
+    {
+      ErrorIf(Vec2::DistanceSq(uvs.mOutput[index], point) > 1e-8f, "Failed");
+      ErrorIf(std::abs(heights.mOutput[index] - (point.x + 2 * point.y)) > 1e-4f, "Failed");
+      ++index;
+    }
+  }
+  ErrorIf(index == 0 || uvs.mOutput.size() != index || heights.mOutput.size() != index, "Failed");
+
+  // Operands without attributes get default values
+  heights.mClipRegion.clear();
+  clipper.Intersect(polygon, clipRegion, results);
+  ErrorIf(heights.mOutput.size() != uvs.mOutput.size(), "Failed");
+}
+
+void TestPolygonOffset()
+{
+  PolygonOffsetter offsetter;
+  PointContourList results;
+  offsetter.Offset(MakeSquare(0, 0, 4), 1, results);
+  ErrorIf(results.size() != 1 || std::abs(ComputeTotalArea(results) - 36) > 0.001f, "Failed");
+  offsetter.Offset(MakeSquare(0, 0, 4), -1, results);
+  ErrorIf(results.size() != 1 || std::abs(ComputeTotalArea(results) - 4) > 0.001f, "Failed");
+  // Deflating past the middle collapses the polygon
+  offsetter.Offset(MakeSquare(0, 0, 4), -3, results);
+  ErrorIf(!results.empty(), "Failed");
+
+  // Each square corner adds a quarter circle, minus what the chords cut off
+  offsetter.mJoinType = ClipJoinType::Round;
+  offsetter.Offset(MakeSquare(0, 0, 4), 1, results);
+  float roundArea = ComputeTotalArea(results);
+  ErrorIf(roundArea > 32 + 3.14159265f || roundArea < 32 + 3.14159265f - 0.05f, "Failed");
+  // Each corner loses a right triangle with legs of sqrt(2) - 1
+  offsetter.mJoinType = ClipJoinType::Square;
+  offsetter.Offset(MakeSquare(0, 0, 4), 1, results);
+  ErrorIf(std::abs(ComputeTotalArea(results) - (36 - 4 * (3 - 2 * std::sqrt(2.0f)))) > 0.001f, "Failed");
+
+  // Holes shrink as the outer contour grows and concave corners don't need joins
+  offsetter.mJoinType = ClipJoinType::Miter;
+  PointContour hole = MakeSquare(3, 3, 4);
+  std::reverse(hole.begin(), hole.end());
+  offsetter.Offset(PointContourList{MakeSquare(0, 0, 10), hole}, 1, results);
+  ErrorIf(results.size() != 2 || std::abs(ComputeTotalArea(results) - 140) > 0.001f, "Failed");
+  PointContour lShape{{0, 0}, {0, 6}, {2, 6}, {2, 2}, {6, 2}, {6, 0}};
+  offsetter.Offset(lShape, 0.5f, results);
+  ErrorIf(results.size() != 1 || std::abs(ComputeTotalArea(results) - 33) > 0.001f, "Failed");
+
+  // A batch gives the same results on any number of threads
+  Array<PointContourList> layer{PointContourList{MakeSquare(0, 0, 4)}, PointContourList{lShape}, PointContourList{MakeSquare(0, 0, 10), hole}};
+  Array<PointContourList> batchResults;
+  offsetter.mThreadCount = 3;
+  offsetter.OffsetBatch(layer, 0.5f, batchResults);
+  ErrorIf(batchResults.size() != layer.size(), "Failed");
+  for(size_t i = 0; i < layer.size(); ++i)
+  {
+    offsetter.Offset(layer[i], 0.5f, results);
+    ErrorIf(batchResults[i] != results, "Failed");
+  }
+}
+
+void TestSimplification()
+{
+  // Duplicates and points on straight runs, including across the start of the loop, are always removed
+  ContourSimplifier simplifier;
+  PointContour square{{0, 2}, {0, 4}, {0, 4}, {2, 4}, {4, 4}, {4, 0}, {0, 0}, {0, 1}};
+  simplifier.Simplify(square);
+  ErrorIf(square.size() != 4 || std::abs(ComputeSignedArea(square) + 16) > 0.001f, "Failed");
+  ErrorIf(simplifier.mStats.mDuplicatesRemoved != 1 || simplifier.mStats.mCollinearRemoved != 3, "Failed");
+
+  // A finely sampled circle keeps its shape within the tolerance with far fewer points
+  PointContour circle;
+  for(size_t i = 0; i < 360; ++i)
+  {
+    float angle = -2 * 3.14159265f * float(i) / 360;
+    circle.push_back(Vec2(10 * std::cos(angle), 10 * std::sin(angle)));
+  }
+  float circleArea = ComputeSignedArea(circle);
+  PointContour douglasPeucker = circle;
+  simplifier.ResetStats();
+  simplifier.mTolerance = 0.1f;
+  simplifier.Simplify(douglasPeucker);
+  ErrorIf(douglasPeucker.size() < 8 || douglasPeucker.size() > 40, "Failed");
+  ErrorIf(std::abs(ComputeSignedArea(douglasPeucker) - circleArea) > 0.1f * 2 * 3.14159265f * 10, "Failed");
+  ErrorIf(simplifier.mStats.GetRemovedCount() != circle.size() - douglasPeucker.size(), "Failed");
+
+  PointContour visvalingam = circle;
+  simplifier.mMethod = SimplifyMethod::VisvalingamWhyatt;
+  simplifier.mTolerance = 0.5f;
+  simplifier.Simplify(visvalingam);
+  ErrorIf(visvalingam.size() < 8 || visvalingam.size() > 60, "Failed");
+  ErrorIf(std::abs(ComputeSignedArea(visvalingam) - circleArea) > 0.1f * 2 * 3.14159265f * 10, "Failed");
+
+  // Simplifying both sides of a clip gives close to the same result with fewer vertices
+  Clipper clipper;
+  ClipOptions options;
+  PointContourList polygons{circle};
+  PointContourList clipRegions{MakeSquare(0, -5, 10)};
+  PointContourList exact;
+  clipper.Execute(ClipOperation::Intersect, polygons, clipRegions, options, exact);
+  simplifier.mMethod = SimplifyMethod::DouglasPeucker;
+  simplifier.mTolerance = 0.1f;
+  simplifier.ResetStats();
+  options.mSimplifyInput = &simplifier;
+  options.mSimplifyOutput = &simplifier;
+  PointContourList simplified;
+  clipper.Execute(ClipOperation::Intersect, polygons, clipRegions, options, simplified);
+  ErrorIf(simplified.size() != 1 || simplified[0].size() >= exact[0].size(), "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(simplified) - ComputeTotalArea(exact)) > 2, "Failed");
+  ErrorIf(simplifier.mStats.GetRemovedCount() == 0, "Failed");
+
+  // The provenance and attributes are compacted along with the vertices the output simplification removes
+  ClipProvenance provenance;
+  ClipAttributeChannel<float> heights;
+  heights.mPolygon.resize(circle.size());
+  for(size_t i = 0; i < circle.size(); ++i)
+    heights.mPolygon[i] = float(i);
+  heights.mClipRegion.assign(4, -1.0f);
+  clipper.mProvenance = &provenance;
+  clipper.mAttributeChannels.push_back(&heights);
+  options.mEngine = ClipEngine::WeilerAtherton;
+  options.mSimplifyInput = nullptr;
+  options.mSimplifyOutput = nullptr;
+  clipper.Execute(ClipOperation::Intersect, polygons, clipRegions, options, exact);
+  ClipProvenance exactProvenance = provenance;
+  Array<float> exactHeights = heights.mOutput;
+  ErrorIf(exact.size() != 1 || exactProvenance.mSources.size() != exact[0].size() || exactHeights.size() != exact[0].size(), "Failed");
+
+  options.mSimplifyOutput = &simplifier;
+  clipper.Execute(ClipOperation::Intersect, polygons, clipRegions, options, simplified);
+  ErrorIf(simplified.size() != 1 || simplified[0].size() >= exact[0].size(), "Failed");
+  ErrorIf(provenance.mContourStarts.size() != 1 || provenance.mContourStarts[0] != 0, "Failed");
+  ErrorIf(provenance.mSources.size() != simplified[0].size() || heights.mOutput.size() != simplified[0].size(), "Failed");
+  // Every kept vertex still has the source and attribute it was traced with
+  size_t exactIndex = 0;
+  for(size_t i = 0; i < simplified[0].size(); ++i)
+  {
+    while(exactIndex < exact[0].size() && Vec2::DistanceSq(exact[0][exactIndex], simplified[0][i]) != 0)
+      ++exactIndex;
+    ErrorIf(exactIndex == exact[0].size(), "Failed");
+    const ClipVertexSource& source = provenance.mSources[i];
+    const ClipVertexSource& exactSource = exactProvenance.mSources[exactIndex];
+    ErrorIf(source.mOperand != exactSource.mOperand || source.mEdgeIndex != exactSource.mEdgeIndex || source.mTime != exactSource.mTime, "Failed");
+    ErrorIf(heights.mOutput[i] != exactHeights[exactIndex], "Failed");
+  }
+  clipper.mProvenance = nullptr;
+  clipper.mAttributeChannels.clear();
+}
+
+void TestOutputCleanup()
+{
+  // The clip region's vertex lands on the polygon's edge, which leaves the crossing there repeated in the result
+  Clipper clipper;
+  PointContour square = MakeSquare(0, 0, 4);
+  PointContour notch{{-2, -1}, {0, 2}, {-2, 5}, {6, 5}, {6, -1}};
+  PointContourList contours;
+  clipper.Intersect(square, notch, contours);
+  ErrorIf(contours.size() != 1 || contours[0].size() <= 4, "Failed");
+
+  ClipCleanupOptions cleanup;
+  clipper.mCleanup = &cleanup;
+  ClipProvenance provenance;
+  clipper.mProvenance = &provenance;
+  clipper.Intersect(square, notch, contours);
+  ErrorIf(contours.size() != 1 || contours[0].size() != 4 || std::abs(ComputeSignedArea(contours[0]) + 16) > 0.001f, "Failed");
+  ErrorIf(provenance.mSources.size() != 4, "Failed");
+  clipper.mProvenance = nullptr;
+
+  // Slivers under the minimum area are dropped
+  PointContour diamond{{-1, 2}, {1, 4}, {3, 2}, {1, 0}};
+  clipper.mCleanup = nullptr;
+  clipper.Subtract(square, diamond, contours);
+  ErrorIf(contours.size() != 3, "Failed");
+  cleanup.mMinArea = 1;
+  clipper.mCleanup = &cleanup;
+  clipper.Subtract(square, diamond, contours);
+  ErrorIf(contours.size() != 1 || std::abs(ComputeSignedArea(contours[0]) + 8) > 0.001f, "Failed");
+}
+
+float ComputeTriangleArea(const Array<Vec2>& vertices, const Array<uint32_t>& indices, bool& allCounterClockwise)
+{
+  float area = 0;
+  allCounterClockwise = true;
+  for(size_t i = 0; i + 2 < indices.size(); i += 3)
+  {
+    float triangleArea = 0.5f * Cross2d(vertices[indices[i + 1]] - vertices[indices[i]], vertices[indices[i + 2]] - vertices[indices[i]]);
+    allCounterClockwise = allCounterClockwise && triangleArea > 0;
+    area += triangleArea;
+  }
+  return area;
+}
+
+void TestTriangulation()
+{
+  // A square with a square hole needs n - 2 + 2 * holes triangles
+  PolygonTriangulator triangulator;
+  PointContour hole = MakeSquare(1, 1, 2);
+  std::reverse(hole.begin(), hole.end());
+  PointContourList holed{MakeSquare(0, 0, 4), hole};
+  Array<Vec2> vertices;
+  Array<uint32_t> indices;
+  triangulator.Triangulate(holed, vertices, indices);
+  bool allCounterClockwise;
+  ErrorIf(vertices.size() != 8 || indices.size() != 8 * 3, "Failed");
+  ErrorIf(std::abs(ComputeTriangleArea(vertices, indices, allCounterClockwise) - 12) > 0.001f || !allCounterClockwise, "Failed");
+
+  // Appending to the same buffers offsets the new indices
+  PointContour comb{{0, 0}, {6, 0}, {6, 4}, {5, 4}, {5, 1}, {4, 1}, {4, 4}, {3, 4}, {3, 1}, {2, 1}, {2, 4}, {1, 4}, {1, 1}, {0, 1}};
+  triangulator.Triangulate(PointContourList{comb}, vertices, indices);
+  ErrorIf(vertices.size() != 8 + comb.size() || indices.size() != (8 + comb.size() - 2) * 3, "Failed");
+  ErrorIf(std::abs(ComputeTriangleArea(vertices, indices, allCounterClockwise) - 12 - std::abs(ComputeSignedArea(comb))) > 0.001f || !allCounterClockwise, "Failed");
+
+  // The fused path matches triangulating the clipped contours, including when the operands don't cross
+  Clipper clipper;
+  PointContour diamond{{-1, 2}, {2, 5}, {5, 2}, {2, -1}};
+  for(unsigned i = 0; i < 4; ++i)
+  {
+    ClipOperation operation = static_cast<ClipOperation>(i);
+    ClipOptions options;
+    options.mEngine = ClipEngine::Scanline;
+    PointContourList contours;
+    clipper.Execute(operation, PointContourList{MakeSquare(0, 0, 4)}, PointContourList{diamond}, options, contours);
+    vertices.clear();
+    indices.clear();
+    triangulator.ClipAndTriangulate(clipper, operation, MakeSquare(0, 0, 4), diamond, vertices, indices);
+    float area = ComputeTriangleArea(vertices, indices, allCounterClockwise);
+    ErrorIf(std::abs(area - std::abs(ComputeTotalArea(contours))) > 0.001f || !allCounterClockwise, "Failed");
+  }
+  vertices.clear();
+  indices.clear();
+  triangulator.ClipAndTriangulate(clipper, ClipOperation::Intersect, MakeSquare(0, 0, 4), MakeSquare(1, 1, 1), vertices, indices);
+  ErrorIf(std::abs(ComputeTriangleArea(vertices, indices, allCounterClockwise) - 1) > 0.001f, "Failed");
+
+  // A union that closes off a hole leaves the hole uncovered
+  PointContour cShape{{0, 0}, {6, 0}, {6, 1}, {1, 1}, {1, 5}, {6, 5}, {6, 6}, {0, 6}};
+  PointContour bar{{5, -1}, {7, -1}, {7, 7}, {5, 7}};
+  vertices.clear();
+  indices.clear();
+  triangulator.ClipAndTriangulate(clipper, ClipOperation::Union, cShape, bar, vertices, indices);
+  ErrorIf(std::abs(ComputeTriangleArea(vertices, indices, allCounterClockwise) - 30) > 0.001f || !allCounterClockwise, "Failed");
+}
+
+void TestInterleavedOutput()
+{
+  // Position after a 4 byte header and a height after it, in a 16 byte vertex with 16-bit indices
+  Clipper clipper;
+  PointContour polygon = MakeSquare(0, 0, 4);
+  PointContour clipRegion{{1, 3}, {6, 5}, {7, 1}, {3, 2}, {2, -1}};
+  ClipAttributeChannel<float> heights;
+  for(const Vec2& point : polygon)
+    heights.mPolygon.push_back(point.x + 2 * point.y);
+  for(const Vec2& point : clipRegion)
+    heights.mClipRegion.push_back(point.x + 2 * point.y);
+  ClipVertexLayout layout;
+  layout.mStride = 16;
+  layout.mPositionOffset = 4;
+  layout.mAttributes.push_back({&heights, 12});
+  layout.mIndexType = ClipIndexType::UInt16;
+
+  PointContourList expected;
+  ClipOptions options;
+  options.mEngine = ClipEngine::WeilerAtherton;
+  options.mClockwiseOutput = true;
+  clipper.Subtract(polygon, clipRegion, options, expected);
+  Array<unsigned char> vertexData(64 * layout.mStride);
+  Array<uint16_t> indexData(64);
+  InterleavedContourSink sink(layout, vertexData.data(), 64, indexData.data(), 64);
+  clipper.Execute(ClipOperation::Subtract, polygon, clipRegion, sink);
+  ErrorIf(sink.HasOverflowed() || sink.mDrawRanges.size() != expected.size(), "Failed");
+  for(size_t i = 0; i < expected.size(); ++i)
+  {
+    const ClipDrawRange& range = sink.mDrawRanges[i];
+    ErrorIf(range.mVertexCount != expected[i].size() || range.mIndexCount != range.mVertexCount, "Failed");
+    for(size_t j = 0; j < range.mVertexCount; ++j)
+    {
+      float vertex[4];
+      size_t index = indexData[range.mFirstIndex + j];
+      std::memcpy(vertex, vertexData.data() + index * layout.mStride, sizeof(vertex));
+      ErrorIf(index != range.mFirstVertex + j, "Failed");
+      ErrorIf(vertex[1] != expected[i][j].x || vertex[2] != expected[i][j].y, "Failed");
+      ErrorIf(std::abs(vertex[3] - (vertex[1] + 2 * vertex[2])) > 1e-4f, "Failed");
+    }
+  }
+
+  // A contour that doesn't fit is left out and the required counts say how much room the whole result needs
+  layout.mTopology = ClipLineTopology::LineList;
+  InterleavedContourSink smallSink(layout, vertexData.data(), 4, indexData.data(), 64);
+  smallSink.Write(PointContourList{MakeSquare(0, 0, 1), MakeSquare(2, 0, 1)});
+  ErrorIf(!smallSink.HasOverflowed() || smallSink.mDrawRanges.size() != 1 || smallSink.GetVertexCount() != 4, "Failed");
+  ErrorIf(smallSink.GetRequiredVertexCount() != 8 || smallSink.GetRequiredIndexCount() != 16 || smallSink.GetIndexCount() != 8, "Failed");
+  ErrorIf(indexData[6] != 3 || indexData[7] != 0, "Failed");
+
+  // A contour 16-bit indices can't address is reported on its own and isn't counted as needing more room
+  PointContour large;
+  for(size_t i = 0; i < 70000; ++i)
+  {
+    float angle = 2 * 3.14159265f * float(i) / 70000;
+    large.push_back(Vec2(100 * std::cos(angle), 100 * std::sin(angle)));
+  }
+  ClipVertexLayout layout16;
+  layout16.mIndexType = ClipIndexType::UInt16;
+  Array<unsigned char> largeVertexData(80000 * layout16.mStride);
+  Array<uint16_t> largeIndexData(80000);
+  InterleavedContourSink largeSink(layout16, largeVertexData.data(), 80000, largeIndexData.data(), 80000);
+  largeSink.Write(PointContourList{MakeSquare(0, 0, 1), large, MakeSquare(2, 0, 1)});
+  ErrorIf(!largeSink.HasExceededIndexRange() || largeSink.HasOverflowed() || largeSink.mDrawRanges.size() != 2, "Failed");
+  ErrorIf(largeSink.GetRequiredVertexCount() != 8 || largeSink.GetVertexCount() != 8 || largeSink.mDrawRanges[1].mFirstVertex != 4, "Failed");
+  // The same contours all fit with 32-bit indices
+  ClipVertexLayout layout32;
+  Array<uint32_t> largeIndexData32(80000);
+  InterleavedContourSink largeSink32(layout32, largeVertexData.data(), 80000, largeIndexData32.data(), 80000);
+  largeSink32.Write(PointContourList{MakeSquare(0, 0, 1), large, MakeSquare(2, 0, 1)});
+  ErrorIf(largeSink32.HasExceededIndexRange() || largeSink32.HasOverflowed() || largeSink32.mDrawRanges.size() != 3, "Failed");
+  ErrorIf(largeSink32.GetVertexCount() != 70008 || largeIndexData32[70007] != 70007, "Failed");
+  largeSink.Reset();
+  ErrorIf(largeSink.HasExceededIndexRange(), "Failed");
+
+  // Operands that don't cross come back as themselves, with holes wound against the outer contour
+  PointContourList contours;
+  PointContourSink pointSink(contours);
+  clipper.Execute(ClipOperation::Subtract, MakeSquare(0, 0, 4), MakeSquare(1, 1, 1), pointSink);
+  ErrorIf(contours.size() != 2 || ComputeSignedArea(contours[0]) * ComputeSignedArea(contours[1]) >= 0, "Failed");
+  ErrorIf(std::abs(std::abs(ComputeTotalArea(contours)) - 15) > 0.001f, "Failed");
+
+  // A union that closes off a hole gives a clockwise outer contour followed by the counter-clockwise hole
+  contours.clear();
+  PointContour cShape{{0, 0}, {6, 0}, {6, 1}, {1, 1}, {1, 5}, {6, 5}, {6, 6}, {0, 6}};
+  PointContour bar{{5, -1}, {7, -1}, {7, 7}, {5, 7}};
+  clipper.Execute(ClipOperation::Union, cShape, bar, pointSink);
+  ErrorIf(contours.size() != 2 || ComputeSignedArea(contours[0]) >= 0 || ComputeSignedArea(contours[1]) <= 0, "Failed");
+  ErrorIf(std::abs(ComputeTotalArea(contours) + 30) > 0.001f, "Failed");
+}
+
+void TestScratchReuse()
+{
+  // Once reserved, repeated clips reuse the same vertices and give the same results
+  Clipper clipper;
+  PointContour polygon = MakeSquare(0, 0, 4);
+  PointContour clipRegion{{1, 3}, {6, 5}, {7, 1}, {3, 2}, {2, -1}};
+  PointContourList expected;
+  clipper.Subtract(polygon, clipRegion, expected);
+  clipper.ShrinkToFit();
+  ErrorIf(clipper.mVertexPool.GetCapacity() != 0, "Failed");
+
+  clipper.Reserve(64);
+  PointContourList contours;
+  for(size_t i = 0; i < 8; ++i)
+  {
+    clipper.Subtract(polygon, clipRegion, contours);
+    clipper.Xor(polygon, clipRegion, contours);
+    clipper.Subtract(polygon, clipRegion, contours);
+    ErrorIf(contours != expected, "Failed");
+    ErrorIf(clipper.mVertexPool.GetCapacity() != 64 || clipper.mVertexPool.GetFreeCount() != 64, "Failed");
+  }
+
+  // Lists passed in by the caller still own their vertices and can outlive the clipper
+  ClipVertexList list;
+  {
+    Clipper localClipper;
+    localClipper.BuildVertexList(polygon, list);
+  }
+  ErrorIf(list.mPool != nullptr || list.mHead->mNext->mNext->mNext->mNext != list.mHead, "Failed");
+}
+
+void TestExactAllocation()
+{
+  // The counting pass sizes every output exactly and the results match a single pass
+  Clipper clipper;
+  PointContour polygon = MakeSquare(0, 0, 4);
+  PointContour clipRegion{{1, 3}, {6, 5}, {7, 1}, {3, 2}, {2, -1}};
+  ClipProvenance provenance;
+  clipper.mProvenance = &provenance;
+  for(unsigned i = 0; i < 4; ++i)
+  {
+    ClipOperation operation = static_cast<ClipOperation>(i);
+    PointContourList expected;
+    PointContourSink pointSink(expected);
+    clipper.Execute(operation, polygon, clipRegion, pointSink);
+
+    PointContourList contours;
+    ClipExactSizes sizes;
+    clipper.ExecuteExact(operation, polygon, clipRegion, contours, &sizes);
+    ErrorIf(contours != expected || sizes.mCrossingCount != 4 || sizes.mVertexCount != 4 + 5 + 8, "Failed");
+    ErrorIf(sizes.mContourCount != contours.size() || contours.capacity() != contours.size(), "Failed");
+    size_t vertexCount = 0;
+    for(const PointContour& contour : contours)
+    {
+      ErrorIf(contour.capacity() != contour.size(), "Failed");
+      vertexCount += contour.size();
+    }
+    ErrorIf(sizes.mOutputVertexCount != vertexCount || provenance.mSources.size() != vertexCount, "Failed");
+  }
+
+  // Operands that don't cross are counted too
+  PointContourList contours;
+  ClipExactSizes sizes;
+  clipper.ExecuteExact(ClipOperation::Xor, MakeSquare(0, 0, 4), MakeSquare(1, 1, 1), contours, &sizes);
+  ErrorIf(sizes.mCrossingCount != 0 || sizes.mContourCount != 2 || contours.size() != 2 || contours[1].capacity() != 4, "Failed");
+}
+
+void TestFixedClipper()
+{
+  // Matches the allocating clipper, including operands that don't cross
+  Clipper clipper;
+  FixedClipper<64> fixedClipper;
+  FixedContourList<64> results;
+  PointContour polygon = MakeSquare(0, 0, 4);
+  PointContour crossing{{1, 3}, {6, 5}, {7, 1}, {3, 2}, {2, -1}};
+  PointContour inside = MakeSquare(1, 1, 1);
+  std::reverse(inside.begin(), inside.end());
+  for(const PointContour* clipRegion : {&crossing, &inside})
+  {
+    for(unsigned i = 0; i < 4; ++i)
+    {
+      ClipOperation operation = static_cast<ClipOperation>(i);
+      PointContourList expected;
+      PointContourSink pointSink(expected);
+      clipper.Execute(operation, polygon, *clipRegion, pointSink);
+      ErrorIf(fixedClipper.Execute(operation, polygon, *clipRegion, results) != ClipStatus::Success, "Failed");
+      ErrorIf(results.GetContourCount() != expected.size(), "Failed");
+      float expectedArea = 0;
+      float area = 0;
+      for(size_t j = 0; j < expected.size(); ++j)
+      {
+        expectedArea += ComputeSignedArea(expected[j]);
+        area += ComputeSignedArea(results.GetContourPoints(j), results.GetContourSize(j));
+      }
+      ErrorIf(std::abs(area - expectedArea) > 0.001f, "Failed");
+    }
+  }
+
+  // Running out of room is reported instead of allocating
+  FixedClipper<12> smallClipper;
+  FixedContourList<12> smallResults;
+  ErrorIf(smallClipper.Execute(ClipOperation::Xor, polygon, crossing, smallResults) != ClipStatus::VertexOverflow, "Failed");
+  FixedClipper<32> largeClipper;
+  FixedContourList<32> largeResults;
+  ErrorIf(largeClipper.Execute(ClipOperation::Xor, polygon, crossing, largeResults) != ClipStatus::Success, "Failed");
+  FixedContourList<8> tinyResults;
+  FixedClipper<8> tinyClipper;
+  ErrorIf(tinyClipper.Execute(ClipOperation::Xor, polygon, inside, tinyResults) != ClipStatus::Success || tinyResults.GetContourCount() != 2, "Failed");
+  ErrorIf(tinyClipper.Execute(ClipOperation::Union, MakeSquare(0, 0, 1), MakeSquare(3, 0, 1), tinyResults) != ClipStatus::Success, "Failed");
+  ErrorIf(tinyClipper.Execute(ClipOperation::Union, MakeSquare(0, 0, 2), MakeSquare(1, 1, 2), tinyResults) != ClipStatus::VertexOverflow, "Failed");
+}
+
+void TestClipJob()
+{
+  // Running a step at a time gives the same contours as running the operation in one go
+  Clipper clipper;
+  PointContour polygon = MakeSquare(0, 0, 4);
+  PointContour crossing{{1, 3}, {6, 5}, {7, 1}, {3, 2}, {2, -1}};
+  PointContour inside = MakeSquare(1, 1, 1);
+  ClipJobBudget budget;
+  budget.mMaxWork = 1;
+  for(const PointContour* clipRegion : {&crossing, &inside})
+  {
+    for(unsigned i = 0; i < 4; ++i)
+    {
+      ClipOperation operation = static_cast<ClipOperation>(i);
+      PointContourList expected;
+      PointContourSink expectedSink(expected);
+      clipper.Execute(operation, polygon, *clipRegion, expectedSink);
+
+      PointContourList contours;
+      PointContourSink sink(contours);
+      ClipJob job(clipper, operation, polygon, *clipRegion, sink);
+      size_t runs = 1;
+      while(job.Run(budget) == ClipJobStatus::Running)
+        ++runs;
+      ErrorIf(job.GetStatus() != ClipJobStatus::Finished || contours != expected || runs < polygon.size(), "Failed");
+    }
+  }
+
+  // A time budget still finishes and a cancelled job stops at its next check
+  PointContourList contours;
+  PointContourSink sink(contours);
+  ClipJob timedJob(clipper, ClipOperation::Xor, polygon, crossing, sink);
+  budget.mMaxWork = 0;
+  budget.mMaxMilliseconds = 1;
+  while(timedJob.Run(budget) == ClipJobStatus::Running) {}
+  ErrorIf(timedJob.GetStatus() != ClipJobStatus::Finished || contours.size() != 4, "Failed");
+
+  ClipJob cancelledJob(clipper, ClipOperation::Subtract, polygon, crossing, sink);
+  budget.mMaxWork = 1;
+  ErrorIf(cancelledJob.Run(budget) != ClipJobStatus::Running, "Failed");
+  cancelledJob.Cancel();
+  ErrorIf(cancelledJob.Run(budget) != ClipJobStatus::Cancelled || cancelledJob.Run() != ClipJobStatus::Cancelled, "Failed");
+
+  // Operands touching at a corner without crossing agree on containment through every front end
+  PointContour touching{{4, 0}, {2, 1}, {3, 2}};
+  FixedClipper<16> fixedClipper;
+  FixedContourList<16> fixedResults;
+  for(unsigned i = 0; i < 4; ++i)
+  {
+    ClipOperation operation = static_cast<ClipOperation>(i);
+    PointContourList expected;
+    PointContourSink expectedSink(expected);
+    clipper.Execute(operation, polygon, touching, expectedSink);
+    contours.clear();
+    ClipJob job(clipper, operation, polygon, touching, sink);
+    job.Run();
+    ErrorIf(contours != expected, "Failed");
+    ErrorIf(fixedClipper.Execute(operation, polygon, touching, fixedResults) != ClipStatus::Success || fixedResults.GetContourCount() != expected.size(), "Failed");
+    float expectedArea = operation == ClipOperation::Intersect ? 1.5f : (operation == ClipOperation::Union ? 16 : 14.5f);
+    ErrorIf(std::abs(std::abs(ComputeTotalArea(expected)) - expectedArea) > 0.001f, "Failed");
+  }
+  clipper.IntersectWithContainment(polygon, touching, contours);
+  ErrorIf(contours.size() != 1 || std::abs(ComputeTotalArea(contours) + 1.5f) > 0.001f, "Failed");
+}
+
+void TestParallelIntersection()
+{
+  // Two stars with enough edge pairs to take the parallel path
+  PointContour polygon;
+  PointContour clipRegion;
+  for(size_t i = 0; i < 400; ++i)
+  {
+    float angle = -float(i) * 6.2831853f / 400;
+    float radius = (i % 2) ? 8.0f : 10.0f;
+    polygon.push_back(Vec2(radius * std::cos(angle), radius * std::sin(angle)));
+    clipRegion.push_back(Vec2(3 + radius * std::cos(angle + 0.004f), 1 + radius * std::sin(angle + 0.004f)));
+  }
+
+  // Any thread count gives the same contours, and they agree with the serial path up to rounding
+  Clipper serialClipper;
+  Clipper parallelClipper;
+  for(unsigned i = 0; i < 4; ++i)
+  {
+    ClipOperation operation = static_cast<ClipOperation>(i);
+    PointContourList expected;
+    PointContourSink expectedSink(expected);
+    serialClipper.Execute(operation, polygon, clipRegion, expectedSink);
+
+    PointContourList firstContours;
+    for(size_t threadCount : {size_t(2), size_t(8)})
+    {
+      parallelClipper.mThreadCount = threadCount;
+      PointContourList contours;
+      PointContourSink sink(contours);
+      parallelClipper.Execute(operation, polygon, clipRegion, sink);
+      ErrorIf(contours.size() != expected.size(), "Failed");
+      ErrorIf(std::abs(ComputeTotalArea(contours) - ComputeTotalArea(expected)) > 0.01f, "Failed");
+      if(firstContours.empty())
+        firstContours = contours;
+      ErrorIf(contours != firstContours, "Failed");
+    }
+  }
+
+  // Small inputs stay serial
+  PointContourList expected;
+  PointContourList contours;
+  PointContourSink expectedSink(expected);
+  PointContourSink sink(contours);
+  serialClipper.Execute(ClipOperation::Subtract, MakeSquare(0, 0, 4), MakeSquare(2, 2, 4), expectedSink);
+  parallelClipper.Execute(ClipOperation::Subtract, MakeSquare(0, 0, 4), MakeSquare(2, 2, 4), sink);
+  ErrorIf(contours != expected, "Failed");
+}
+
 void RunTestFile(const std::filesystem::path& filePath)
 {
   JsonLoader loader;
@@ -182,6 +1467,10 @@ void RunTestFile(const std::filesystem::path& filePath)
   TestUnion(loader, polygon, clipRegion);
   TestSubtraction(loader, polygon, clipRegion);
   TestIntersection(loader, polygon, clipRegion);
+  TestXor(loader, polygon, clipRegion);
+  TestComputeAll(loader, polygon, clipRegion);
+  TestPredicates(loader, polygon, clipRegion);
+  TestScanline(loader, polygon, clipRegion);
 }
 
 void RunTests(const std::filesystem::path& path)
@@ -201,6 +1490,29 @@ int main()
 {
   std::filesystem::path dataPath = "Data";
   RunTests(dataPath);
+  TestPredicates();
+  TestSpatialJoin();
+  TestClipScene();
+  TestChunkedTerrain();
+  TestClipShapes();
+  TestScanline();
+  TestEngineSelection();
+  TestNormalization();
+  TestClipExpr();
+  TestMultiCutterSubtract();
+  TestPolylineClipping();
+  TestProvenance();
+  TestAttributeChannels();
+  TestPolygonOffset();
+  TestSimplification();
+  TestOutputCleanup();
+  TestTriangulation();
+  TestInterleavedOutput();
+  TestScratchReuse();
+  TestExactAllocation();
+  TestFixedClipper();
+  TestClipJob();
+  TestParallelIntersection();
 
   return 0;
 }